@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Finds heap allocations on real-time paths
+ *
+ * Builds configured with -DMOTOR_SIM_TRACK_ALLOCATIONS=ON replace the global operator
+ * new and delete, and every thread counts its own allocations. While the simulation
+ * runs (armed by SimulationEngine::start() until stop()), an allocation inside a
+ * HotPath scope (a physics tick, a board timer callback, received frame handling,
+ * and the transmits they make) is reported with a backtrace, or aborts the process.
+ *
+ * In other builds HotPath is empty and nothing is replaced.
+ */
+class AllocationTracker {
+public:
+    enum class Mode : uint8_t { Off, Report, Abort };
+
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+    static constexpr bool AVAILABLE = true;
+#else
+    static constexpr bool AVAILABLE = false;
+#endif
+
+    // Report mode prints each distinct call stack once; stacks beyond this many are only counted
+    static constexpr size_t REPORT_SITES = 256;
+
+    /**
+     * @brief What to do about hot-path allocations once armed (call before start)
+     */
+    static void setMode(Mode mode);
+    static Mode getMode();
+
+    static void arm();
+    static void disarm();
+
+    /**
+     * @brief Hot-path allocations seen while armed, over all threads
+     */
+    static uint64_t getHotAllocations();
+
+    /**
+     * @brief Allocations made by the calling thread since it started (0 in other builds)
+     */
+    static uint64_t getThreadAllocations();
+
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+    static thread_local uint32_t hot_depth_;
+#endif
+};
+
+/**
+ * @brief Marks the enclosing scope as a real-time path that must not allocate
+ */
+class HotPath {
+public:
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+    HotPath() { ++AllocationTracker::hot_depth_; }
+    ~HotPath() { --AllocationTracker::hot_depth_; }
+#else
+    HotPath() {}
+#endif
+
+    HotPath(const HotPath&) = delete;
+    HotPath& operator=(const HotPath&) = delete;
+};
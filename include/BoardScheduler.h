@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Metrics.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CanBoard;
+
+/**
+ * @brief Runs the periodic timers of every CAN board on a few shared threads
+ *
+ * A board no longer owns a thread per timer. Each scheduler thread keeps the timers of
+ * its boards in a min-heap ordered by due time and sleeps until the earliest one, so
+ * the thread count stays fixed however many boards run. A board always runs on the
+ * same thread, so its timer callbacks never overlap. A late timer keeps its phase
+ * (the next run is one period after the missed one) and counts an overrun.
+ *
+ * Example usage (CanBoard::start / stop):
+ *   handle_ = BoardScheduler::instance().add(*this, periods, enabled_timers);
+ *   BoardScheduler::instance().remove(handle_);
+ */
+class BoardScheduler {
+public:
+    static constexpr uint32_t MAX_TIMERS = 3;          // Timers per board
+    static constexpr uint32_t MAX_THREADS = 64;
+    static constexpr uint32_t NO_HANDLE = UINT32_MAX;
+
+    static BoardScheduler& instance();
+
+    ~BoardScheduler();
+
+    BoardScheduler(const BoardScheduler&) = delete;
+    BoardScheduler& operator=(const BoardScheduler&) = delete;
+
+    /**
+     * @brief Number of timer threads (call before the first board starts; default 1)
+     */
+    void setThreads(uint32_t threads);
+    uint32_t getThreads() const;
+
+    /**
+     * @brief Start running a board's timers, first due now
+     * @param periods Period of each timer in nanoseconds
+     * @param enabled Bit i set = run timer i
+     * @return Handle for remove()
+     */
+    uint32_t add(CanBoard& board, const int64_t (&periods)[MAX_TIMERS], uint32_t enabled);
+
+    /**
+     * @brief Stop running a board's timers; waits for a callback in progress
+     */
+    void remove(uint32_t handle);
+
+private:
+    static constexpr uint32_t SLOT_BITS = 24;          // Handle = thread << SLOT_BITS | slot
+
+    struct Entry {
+        int64_t dueNs;
+        uint32_t slot;
+        uint32_t generation;
+        uint32_t timer;
+    };
+
+    // One board's timers; the generation changes when the board is removed, so heap
+    // entries left behind by it are dropped instead of run
+    struct Slot {
+        CanBoard* board = nullptr;
+        uint32_t generation = 0;
+        int64_t periodNs[MAX_TIMERS] = {};
+    };
+
+    struct Shard {
+        std::mutex mutex;                              // Guards everything below
+        std::condition_variable wake;                  // New timers or shutdown
+        std::condition_variable idle;                  // A callback finished
+        std::vector<Entry> heap;                       // Earliest due first
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        const CanBoard* executing = nullptr;
+        std::thread thread;
+    };
+
+    BoardScheduler();
+
+    void startThreads();
+    void timerLoop(Shard& shard, uint32_t index);
+
+    std::mutex mutex_;                                 // Guards the thread count and startup
+    uint32_t threads_;
+    std::vector<std::unique_ptr<Shard>> shards_;       // Fixed once started
+    std::atomic<uint32_t> nextShard_;                  // Round-robin placement of boards
+    std::atomic<bool> running_;
+
+    // Per timer, over all boards
+    MetricHistogram executionTime_[MAX_TIMERS];
+    MetricCounter overruns_[MAX_TIMERS];
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+/**
+ * @brief Periodic timer frequencies of a CAN board
+ *
+ * Defaults match the original firmware timing. In OnChange transmit mode the
+ * can_transmit timer runs at TransmitPolicy::minInterval instead of canTransmitHz.
+ */
+struct BoardTimerRates {
+    double encoderReadHz = 300.0;    ///< Encoder latch (and velocity estimator sample) rate
+    double controlUpdateHz = 300.0;  ///< Control signal application rate
+    double canTransmitHz = 100.0;    ///< Status frame rate (FixedRate mode)
+};
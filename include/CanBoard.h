@@ -1,16 +1,25 @@
 #pragma once
 
-#include "CanSocket.h"
+#include "CanTransport.h"
+#include "CanBus.h"
+#include "TransmitPolicy.h"
+#include "BoardTimerRates.h"
+#include "VelocityEstimator.h"
+#include "PositionHold.h"
+#include "Metrics.h"
+#include "CpuAccounting.h"
+#include "BoardScheduler.h"
+#include "IntegrationClock.h"
+#include <array>
 #include <atomic>
-#include <thread>
 #include <chrono>
-#include <functional>
-#include <vector>
+#include <climits>
 #include <mutex>
 #include <memory>
 
 // Forward declaration to avoid circular dependency
 class Servo;
+class SyncGroup;
 
 /**
  * @brief CAN board hardware simulation for servo systems
@@ -19,25 +28,30 @@ class Servo;
  * including periodic encoder reading, control signal updates, CAN communication, and other timed operations.
  * Each board has a unique CAN ID for all communication.
  */
-class CanBoard {
+class CanBoard : private CanBus::Receiver {
 public:
+    // Periodic timers, run by the shared BoardScheduler
+    enum Timer : uint32_t { ENCODER_READ, CONTROL_UPDATE, CAN_TRANSMIT, TIMER_COUNT };
+    static constexpr const char* TIMER_NAMES[TIMER_COUNT] = {"encoder_read", "control_update", "can_transmit"};
+
     /**
      * @brief Timer configuration for periodic operations
      */
     struct TimerConfig {
-        std::string name;
         std::chrono::microseconds period;
-        std::function<void()> callback;
+        void (CanBoard::*callback)();
         bool enabled = true;
     };
 
 private:
-    Servo& servo_;
-    std::unique_ptr<CanSocket> can_socket_;
+    Servo* servo_;
+    std::unique_ptr<CanTransport> transport_;
+    std::shared_ptr<CanBus> can_bus_;
     uint32_t can_id_;
+    uint32_t can_bitrate_;
     std::atomic<bool> running_;
-    std::vector<std::thread> timerThreads_;
-    std::vector<TimerConfig> timers_;
+    std::array<TimerConfig, TIMER_COUNT> timers_;
+    uint32_t schedulerHandle_;            // BoardScheduler::NO_HANDLE while stopped
     mutable std::mutex dataMutex_;
 
     // Encoder data cache (simulates hardware registers)
@@ -45,19 +59,93 @@ private:
     std::atomic<double> cachedEncoderRadians_;
     std::atomic<int> currentControlSignal_;
 
+    // SYNC mode: status latched by the physics thread, sent by the SyncGroup
+    SyncGroup* syncGroup_;
+    bool syncListener_;
+
+    // Latched encoder state, written under a seqlock so the tick always matches the position
+    std::atomic<uint32_t> latchSequence_;
+    std::atomic<double> cachedVelocity_;
+    std::atomic<uint64_t> latchedTick_;
+
+    // Simulation clock used to timestamp latches (nullptr = not attached to an engine)
+    const std::atomic<uint64_t>* simTick_;
+    double tickPeriodUs_;
+
+    // Tick the servo's integrated state belongs to, set by the engine when it groups
+    // servos (nullptr = the servo is stepped every tick)
+    std::atomic<const IntegrationClock*> integrationClock_;
+
+    // Status transmission policy and last transmitted values (transmit timer thread only)
+    TransmitPolicy transmitPolicy_;
+    long lastSentEncoderSteps_;
+    int16_t lastSentSpeed_;
+    int lastSentControlSignal_;
+    std::chrono::steady_clock::time_point lastSentTime_;
+    bool statusSent_;
+
+    // Encoder-derived speed (estimator runs in the encoder_read timer thread only)
+    VelocityEstimator::Config velocityEstimatorConfig_;
+    VelocityEstimator velocityEstimator_;
+    std::atomic<int> estimatedSpeed_;
+
+    // Position hold, run by the physics thread every holdDivider_ ticks (0 = disabled)
+    enum HoldState : int { HOLD_OFF = 0, HOLD_REQUESTED, HOLD_ACTIVE };
+    PositionHold::Config positionHoldConfig_;
+    PositionHold positionHold_;
+    std::atomic<int> holdState_;
+    std::atomic<uint32_t> holdDivider_;   // Set by the physics thread, read on receive
+    uint32_t holdCountdown_;
+
+    // Effort commands reach the motor at a tick boundary: the control timer hands them
+    // to the physics thread, which applies them in actuate()
+    static constexpr int NO_PENDING_CONTROL = INT_MIN;
+    std::atomic<int> pendingControl_;
+    int actuationHoldState_;              // holdState_ as seen by actuationDue() (physics thread)
+    int actuationControl_;                // Command taken by actuationDue() (physics thread)
+
     // Timer frequencies (in Hz)
-    static constexpr double ENCODER_READ_FREQUENCY = 300.0;
-    static constexpr double CONTROL_UPDATE_FREQUENCY = 300.0;
-    static constexpr double CAN_TRANSMIT_FREQUENCY = 100.0;
+    BoardTimerRates timerRates_;
+
+    // Metrics, labelled with the CAN ID and interface; the latency histogram only
+    // with the interface unless per-board latency metrics are enabled
+    static std::atomic<bool> perBoardLatencyMetrics_;
+    MetricCounter framesTx_;
+    MetricCounter framesRx_;
+    MetricCounter sendFailures_;
+    MetricCounter unknownMessages_;
+    MetricHistogram commandApplyLatency_;
+    CpuAccounting::Account* receiveCpu_;  // Charged by receive threads, or senders on loop: and shm:
+    CpuAccounting::Account* timersCpu_;   // Charged by the board's scheduler thread
+    std::atomic<int64_t> commandReceivedNs_;  // Effort command not yet applied (0 = none)
+
+    /**
+     * @brief Consistent copy of the latched encoder state
+     */
+    struct LatchedStatus {
+        long encoderSteps;
+        double velocity;
+        uint64_t tick;
+    };
 
 public:
     /**
      * @brief Constructor
      * @param servo Reference to the servo to control
      * @param can_id Unique CAN ID for this board (used for all CAN communication)
-     * @param can_interface CAN interface name (e.g., "can0", "vcan0")
+     * @param can_interface CAN interface name (e.g., "can0", "vcan0", "loop:bus0")
+     * @param can_bitrate Modeled bus bitrate in bits per second (0 = ideal bus, no timing model)
+     */
+    explicit CanBoard(Servo& servo, uint32_t can_id, const std::string& can_interface = "vcan0",
+                      uint32_t can_bitrate = 0);
+
+    /**
+     * @brief Give boards constructed afterwards their own command latency histogram
+     *
+     * A histogram takes HISTOGRAM_BUCKETS + 2 metric slots, so by default boards on
+     * one interface share one and large fleets fit the slot space.
      */
-    explicit CanBoard(Servo& servo, uint32_t can_id, const std::string& can_interface = "vcan0");
+    static void setPerBoardLatencyMetrics(bool enabled);
 
     /**
      * @brief Destructor - ensures all timers are stopped
@@ -74,6 +162,19 @@ public:
      */
     void stop();
 
+    /**
+     * @brief Stop running the timers of a started board, waiting for a callback in progress
+     *
+     * Settings the timer callbacks read (timer rates, transmit policy, velocity
+     * estimator) may be changed while paused. The transport keeps running.
+     */
+    void pauseTimers();
+
+    /**
+     * @brief Run the timers again with the current periods, first due now
+     */
+    void resumeTimers();
+
     /**
      * @brief Check if board is running
      */
@@ -110,10 +211,139 @@ public:
     uint32_t getCanId() const;
 
     /**
-     * @brief Get CAN socket reference for direct access
-     * @return Reference to the CanSocket instance
+     * @brief Owner of this board's CPU accounts, e.g. "board 0x10 on vcan0"
+     */
+    std::string getCpuOwner() const;
+
+    /**
+     * @brief Get CAN transport reference for direct access
+     * @return Reference to the transport backend (SocketCAN or loopback)
+     */
+    CanTransport& getTransport();
+
+    /**
+     * @brief Get modeled bus bitrate
+     * @return Bitrate in bits per second, 0 if frames go straight to the transport
+     */
+    uint32_t getCanBitrate() const;
+
+    /**
+     * @brief Route transmitted frames through a bus timing model
+     * @param bus Shared bus model for this board's interface (nullptr = send directly);
+     *            frames still queued on a previous bus are dropped
+     */
+    void attachBus(std::shared_ptr<CanBus> bus);
+
+    /**
+     * @brief Point the board at a new owning Servo (used when a Servo is moved)
+     * @param servo Servo that now owns this board
+     */
+    void rebind(Servo& servo);
+
+    /**
+     * @brief Set periodic timer frequencies (call before start or while paused)
+     * @param rates Encoder read, control update and status transmit rates in Hz
+     */
+    void setTimerRates(const BoardTimerRates& rates);
+
+    /**
+     * @brief Get periodic timer frequencies
+     */
+    const BoardTimerRates& getTimerRates() const;
+
+    /**
+     * @brief Set status transmission policy (call before start or while paused)
+     * @param policy Fixed-rate or change-driven transmission settings
+     */
+    void setTransmitPolicy(const TransmitPolicy& policy);
+
+    /**
+     * @brief Get status transmission policy
+     */
+    const TransmitPolicy& getTransmitPolicy() const;
+
+    /**
+     * @brief Select how the reported speed is derived (call before start or while paused)
+     *
+     * With any method other than Model, status frames carry the speed estimated from
+     * successive encoder reads instead of the motor model's exact velocity.
+     * @param config Estimator method and tuning
+     */
+    void setVelocityEstimator(const VelocityEstimator::Config& config);
+
+    /**
+     * @brief Get the velocity estimator
+     */
+    const VelocityEstimator& getVelocityEstimator() const;
+
+    /**
+     * @brief Configure the effort 0 position-hold loop (call before start, or on the
+     *        physics thread between ticks)
+     * @param config Loop rate and gains (rateHz 0 = plain stop without hold)
+     */
+    void setPositionHold(const PositionHold::Config& config);
+
+    /**
+     * @brief Check if the position-hold loop currently drives the motor
+     */
+    bool isHoldingPosition() const;
+
+    /**
+     * @brief Get the position-hold loop rate in Hz (0 = hold disabled)
+     */
+    double getPositionHoldRate() const;
+
+    /**
+     * @brief Check whether actuate() changes the servo's control signal this tick
+     *
+     * The engine first integrates a coarse-step servo up to the current tick, so a
+     * new command or hold output is not applied retroactively. Physics thread, once
+     * per tick, right before actuate().
+     */
+    bool actuationDue();
+
+    /**
+     * @brief Apply the latest effort command, or run the position-hold loop when due
+     *        (physics thread, once per tick)
+     * @param encoder_steps The servo's encoder position at the end of the previous tick;
+     *        only read when actuationDue() returned true
+     */
+    void actuate(long encoder_steps);
+
+    /**
+     * @brief Join a SYNC group (call before start)
+     *
+     * The board stops running its own encoder_read and can_transmit timers and
+     * reports status only when the group latches and transmits it.
+     * @param group SYNC group for this board's interface (nullptr = free-running timers)
+     * @param listener true if this board receives the SYNC ID on behalf of the group
+     */
+    void setSyncGroup(SyncGroup* group, bool listener);
+
+    /**
+     * @brief Attach the engine's physics tick counter used to timestamp latched state
+     * @param tick Tick counter, incremented once per physics step
+     * @param simulation_frequency_hz Physics rate, to convert ticks to microseconds
+     */
+    void attachSimClock(const std::atomic<uint64_t>& tick, double simulation_frequency_hz);
+
+    /**
+     * @brief Attach the clock of the kernel group or chain that integrates the servo
+     *        (physics thread, between ticks)
+     * @param clock Clock stamping the servo's state (nullptr = the engine's tick counter)
+     */
+    void attachIntegrationClock(const IntegrationClock* clock);
+
+    /**
+     * @brief Latch encoder position and velocity (physics thread, between ticks)
+     * @param tick Physics tick the latched state belongs to
      */
-    CanSocket& getCanSocket();
+    void latchStatus(uint64_t tick);
+
+    /**
+     * @brief Send a status frame from the latched state (SyncGroup sender thread)
+     */
+    void transmitLatchedStatus();
 
     /**
      * @brief Enable/disable a timer by name
@@ -122,6 +352,11 @@ public:
      */
     void setTimerEnabled(const std::string& name, bool enabled);
 
+    /**
+     * @brief Run one timer callback (BoardScheduler thread)
+     */
+    void runTimer(uint32_t timer);
+
 private:
     /**
      * @brief Initialize default timers
@@ -129,10 +364,19 @@ private:
     void initializeTimers();
 
     /**
-     * @brief Timer thread function
-     * @param config Timer configuration
+     * @brief Derive timer periods from the rates and transmit policy (dataMutex_ held)
+     */
+    void applyTimerPeriods();
+
+    /**
+     * @brief Register the enabled timers with the BoardScheduler
+     */
+    void scheduleTimers();
+
+    /**
+     * @brief Derive the hold loop's divider and gains from its config and the physics rate
      */
-    void timerLoop(const TimerConfig& config);
+    void configureHoldLoop(double simulation_frequency_hz);
 
     /**
      * @brief Encoder reading timer callback
@@ -150,9 +394,70 @@ private:
      */
     void canTransmitTimer();
 
+    /**
+     * @brief Build and send a 0x13 status frame (and its 0x14 timestamp if enabled)
+     */
+    void sendStatusFrame(long encoder_steps, int16_t speed_scaled, int control_signal, uint64_t latched_tick);
+
+    /**
+     * @brief Build and send a 0x14 latch timestamp frame
+     */
+    void sendTimestampFrame(uint64_t latched_tick);
+
+    /**
+     * @brief Send a frame through the bus model or directly to the transport
+     */
+    void transmitFrame(const struct can_frame& frame);
+
+    /**
+     * @brief Publish latched encoder state (single writer at a time)
+     */
+    void storeLatch(long encoder_steps, double velocity, uint64_t tick);
+
+    /**
+     * @brief Read latched encoder state consistently
+     */
+    LatchedStatus loadLatch() const;
+
+    /**
+     * @brief Read the servo's encoder position and velocity with the tick they belong to
+     */
+    LatchedStatus observeServo() const;
+
+    /**
+     * @brief Run the position-hold loop when due (physics thread, from actuate())
+     */
+    void holdTick(long encoder_steps);
+
+    /**
+     * @brief Move holdState_ to HOLD_OFF from either hold state (any thread)
+     */
+    void releaseHold();
+
+    /**
+     * @brief Current physics tick, 0 without an attached clock
+     */
+    uint64_t currentTick() const;
+
+    /**
+     * @brief Convert angular velocity to the status frame's RPM * 100 format
+     */
+    static int16_t scaleSpeed(double velocity_rad_s);
+
+    /**
+     * @brief Decide whether a status frame is due under an OnChange policy
+     */
+    bool statusChanged(long encoder_steps, int16_t speed_scaled, int control_signal,
+                       std::chrono::steady_clock::time_point now) const;
+
     /**
      * @brief CAN frame receive callback
      * @param frame Received CAN frame
      */
     void onCanFrameReceived(const struct can_frame& frame);
+
+    /**
+     * @brief A received frame that crossed the bus model (bus thread)
+     */
+    void onBusFrame(const struct can_frame& frame) override;
 };
\ No newline at end of file
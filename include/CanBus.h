@@ -0,0 +1,209 @@
+#pragma once
+
+#include "CanTransport.h"
+#include "Metrics.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief CAN bus timing and arbitration model
+ *
+ * Sits between CanBoard transmit and the socket. Frames submitted by all boards
+ * sharing an interface are queued, arbitrated by CAN ID priority whenever the
+ * modeled bus becomes idle, and handed to their transport only after the frame's
+ * full on-wire time (including bit stuffing and inter-frame space) has elapsed.
+ *
+ * Frames a controller sends to the boards take the same path through receive():
+ * the interface delivers them instantly, so the bus arbitrates them against the
+ * boards' frames and hands them to the board once they have crossed the modeled
+ * wire. A frame that several boards accept crosses the bus once per board.
+ *
+ * Example usage:
+ *   auto bus = std::make_shared<CanBus>("vcan0", 500000);
+ *   bus->start();
+ *   bus->submit(frame, transport);
+ *   bus->receive(frame, receiver);
+ *   bus->detach(transport);   // Before the transport is closed or destroyed
+ */
+class CanBus {
+public:
+    /**
+     * @brief Bus statistics snapshot
+     */
+    struct Statistics {
+        uint64_t frames = 0;             ///< Frames delivered
+        uint64_t bits = 0;               ///< Total on-wire bits (including stuff bits and IFS)
+        uint64_t stuffBits = 0;          ///< Stuff bits inserted
+        double utilization = 0.0;        ///< Busy time / elapsed time since start (0..1)
+        double meanQueueDelayUs = 0.0;   ///< Mean time from submit to start of transmission
+        double maxQueueDelayUs = 0.0;    ///< Worst time from submit to start of transmission
+        size_t maxPending = 0;           ///< Highest number of frames waiting for the bus
+        uint64_t overflows = 0;          ///< Frames refused because the queue was full
+    };
+
+    /**
+     * @brief Board side of frames the bus delivers instead of writing to a transport
+     */
+    class Receiver {
+    public:
+        virtual void onBusFrame(const struct can_frame& frame) = 0;
+
+    protected:
+        ~Receiver() = default;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingFrame {
+        struct can_frame frame;
+        CanTransport* transport;   // Frame sent by a board, or
+        Receiver* receiver;        // frame received by one
+        Clock::time_point submitted;
+        uint32_t priority;   // Arbitration key, lower wins
+        uint64_t sequence;   // FIFO tie-break for identical keys
+    };
+
+    struct LowerPriority {
+        bool operator()(const PendingFrame& a, const PendingFrame& b) const {
+            return a.priority != b.priority ? a.priority > b.priority : a.sequence > b.sequence;
+        }
+    };
+
+    std::string name_;
+    uint32_t bitrate_;
+    double nanoseconds_per_bit_;
+
+    std::vector<PendingFrame> pending_;  // Heap ordered by LowerPriority, highest priority first
+    uint64_t next_sequence_;
+    std::atomic<bool> running_;
+    std::thread bus_thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::condition_variable sent_cv_;    // The bus thread finished handing a frame to its transport
+    const void* sending_;                // Transport or receiver of the frame being handed over (guarded by mutex_)
+
+    // Statistics (guarded by mutex_)
+    Clock::time_point started_at_;
+    Clock::duration busy_time_;
+    Clock::duration total_queue_delay_;
+    Clock::duration max_queue_delay_;
+    uint64_t frames_;
+    uint64_t bits_;
+    uint64_t stuff_bits_;
+    size_t max_pending_;
+    uint64_t overflows_;
+
+    // Metrics, labelled with the bus name
+    MetricCounter frames_metric_;
+    MetricGauge pending_metric_;
+    MetricHistogram queue_delay_metric_;
+    MetricCounter overflows_metric_;
+
+public:
+    // Frames that can wait for the bus, reserved up front so submit() never allocates;
+    // like a full transmit mailbox, a frame beyond this is refused
+    static constexpr size_t MAX_PENDING_FRAMES = 1024;
+
+    /**
+     * @brief Constructor
+     * @param name Bus name, normally the CAN interface it models
+     * @param bitrate Nominal bitrate in bits per second (e.g., 500000, 1000000)
+     */
+    explicit CanBus(const std::string& name, uint32_t bitrate = 500000);
+
+    /**
+     * @brief Destructor - stops the bus thread, dropping undelivered frames
+     */
+    ~CanBus();
+
+    CanBus(const CanBus&) = delete;
+    CanBus& operator=(const CanBus&) = delete;
+
+    /**
+     * @brief Start the bus arbitration thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the bus arbitration thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if the bus thread is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Queue a frame for arbitration (thread-safe)
+     * @param frame Frame to transmit
+     * @param transport Transport the frame is written to once it has won the bus
+     * @return true if queued, false if the bus is not running or MAX_PENDING_FRAMES are waiting
+     */
+    bool submit(const struct can_frame& frame, CanTransport& transport);
+
+    /**
+     * @brief Queue a frame a board received for arbitration (thread-safe)
+     * @param frame Frame the controller sent
+     * @param receiver Called on the bus thread once the frame has won the bus and crossed it
+     * @return true if queued, false if the bus is not running or MAX_PENDING_FRAMES are waiting
+     */
+    bool receive(const struct can_frame& frame, Receiver& receiver);
+
+    /**
+     * @brief Drop a transport's queued frames and wait for a frame it is sending
+     *
+     * Call before the transport is closed or destroyed; the bus holds no reference
+     * to it afterwards.
+     */
+    void detach(CanTransport& transport);
+
+    /**
+     * @brief Drop a receiver's queued frames and wait for a frame being delivered to it
+     */
+    void detach(Receiver& receiver);
+
+    /**
+     * @brief Get the bus name
+     */
+    const std::string& getName() const;
+
+    /**
+     * @brief Get the nominal bitrate in bits per second
+     */
+    uint32_t getBitrate() const;
+
+    /**
+     * @brief Get a consistent snapshot of the bus statistics
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * @brief Compute on-wire length of a frame
+     * @param frame CAN frame (standard, extended or remote)
+     * @param stuff_bits Optional output for number of stuff bits inserted
+     * @return Total bits from SOF through inter-frame space
+     */
+    static uint32_t frameBitCount(const struct can_frame& frame, uint32_t* stuff_bits = nullptr);
+
+    /**
+     * @brief Compute arbitration key of a frame (lower value wins the bus)
+     */
+    static uint32_t arbitrationKey(const struct can_frame& frame);
+
+private:
+    bool enqueue(const struct can_frame& frame, CanTransport* transport, Receiver* receiver);
+    void detachTarget(const void* target);
+
+    /**
+     * @brief Bus thread function
+     */
+    void busLoop();
+};
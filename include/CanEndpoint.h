@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CanTransport.h"
+#include "Metrics.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Receive side of a user-space transport endpoint
+ *
+ * Shared (by shared_ptr) between a transport and whatever dispatches frames to it,
+ * so a dispatcher holding a stale endpoint list never touches a destroyed transport.
+ * stopReceiving() waits for deliveries already inside the callback to return, and
+ * waitForSends() for the transport's own sendFrame() calls still using its bus.
+ *
+ * Filters live in a fixed array under a seqlock, so checking a frame against an
+ * endpoint that does not want it costs no atomic read-modify-write.
+ */
+struct CanEndpoint {
+    static constexpr size_t MAX_FILTERS = 16;
+
+    std::atomic<bool> receiving{false};
+    std::atomic<int> deliveries_in_flight{0};
+    std::atomic<int> sends_in_flight{0};  // Announced by the transport before it reads its bus pointer
+    CanTransport::ReceiveCallback callback;
+    MetricCounter filter_drops;  // Frames rejected by the filters, set by the transport
+
+    // Written under filter_mutex, read through filter_sequence (odd while written)
+    std::mutex filter_mutex;
+    std::atomic<uint32_t> filter_sequence{0};
+    std::atomic<uint32_t> filter_count{0};  // 0 = receive everything, like a fresh SocketCAN socket
+    std::atomic<canid_t> filter_ids[MAX_FILTERS] = {};
+    std::atomic<canid_t> filter_masks[MAX_FILTERS] = {};
+
+    bool accepts(const struct can_frame& frame) const {
+        struct can_filter current[MAX_FILTERS];
+        for (;;) {
+            uint32_t before = filter_sequence.load(std::memory_order_acquire);
+            if (before & 1U) {
+                continue; // setFilters() copies at most MAX_FILTERS entries
+            }
+            uint32_t count = filter_count.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < count; ++i) {
+                current[i].can_id = filter_ids[i].load(std::memory_order_relaxed);
+                current[i].can_mask = filter_masks[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (filter_sequence.load(std::memory_order_relaxed) == before) {
+                return CanTransport::filterAccepts(current, count, frame);
+            }
+        }
+    }
+
+    /**
+     * @return false (filters unchanged) for more than MAX_FILTERS filters
+     */
+    bool setFilters(const struct can_filter* filter_array, size_t count) {
+        if (count > MAX_FILTERS) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(filter_mutex);
+        uint32_t sequence = filter_sequence.load(std::memory_order_relaxed);
+        filter_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < count; ++i) {
+            filter_ids[i].store(filter_array[i].can_id, std::memory_order_relaxed);
+            filter_masks[i].store(filter_array[i].can_mask, std::memory_order_relaxed);
+        }
+        filter_count.store(static_cast<uint32_t>(count), std::memory_order_relaxed);
+
+        filter_sequence.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    void deliver(const struct can_frame& frame) {
+        // Most endpoints on a bus filter a frame out; they only read their filters
+        if (!receiving.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (!accepts(frame)) {
+            filter_drops.add();
+            return;
+        }
+
+        // Announce the delivery before checking receiving again, so stopReceiving() can wait it out
+        deliveries_in_flight.fetch_add(1);
+        if (receiving.load()) {
+            callback(frame);
+        }
+        deliveries_in_flight.fetch_sub(1);
+    }
+
+    void waitForSends() {
+        while (sends_in_flight.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool startReceiving(CanTransport::ReceiveCallback receive_callback) {
+        if (receiving) {
+            return true;
+        }
+        callback = std::move(receive_callback);
+        receiving = true;
+        return true;
+    }
+
+    void stopReceiving() {
+        if (!receiving.exchange(false)) {
+            return;
+        }
+        while (deliveries_in_flight.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+/**
+ * @brief Copy-on-write list of endpoints attached to one user-space bus
+ *
+ * Dispatchers take a snapshot without locking; attach/detach publish a new list.
+ */
+class CanEndpointList {
+private:
+    using List = std::vector<std::shared_ptr<CanEndpoint>>;
+
+    std::mutex mutex_;
+    std::shared_ptr<const List> endpoints_;
+
+public:
+    CanEndpointList() : endpoints_(std::make_shared<List>()) {}
+
+    void attach(const std::shared_ptr<CanEndpoint>& endpoint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto updated = std::make_shared<List>(*endpoints_);
+        updated->push_back(endpoint);
+        std::atomic_store(&endpoints_, std::shared_ptr<const List>(std::move(updated)));
+    }
+
+    void detach(const std::shared_ptr<CanEndpoint>& endpoint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto updated = std::make_shared<List>();
+        for (const auto& existing : *endpoints_) {
+            if (existing != endpoint) {
+                updated->push_back(existing);
+            }
+        }
+        std::atomic_store(&endpoints_, std::shared_ptr<const List>(std::move(updated)));
+    }
+
+    size_t size() {
+        return std::atomic_load(&endpoints_)->size();
+    }
+
+    /**
+     * @brief Deliver a frame to every endpoint except the sender
+     */
+    void broadcast(const CanEndpoint* sender, const struct can_frame& frame) {
+        auto snapshot = std::atomic_load(&endpoints_);
+        for (const auto& endpoint : *snapshot) {
+            if (endpoint.get() != sender) {
+                endpoint->deliver(frame);
+            }
+        }
+    }
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <linux/can.h>
+#include <linux/io_uring.h>
+
+/**
+ * @brief Shared io_uring reactor for SocketCAN sockets
+ *
+ * One completion thread services every registered socket. A multishot receive stays
+ * armed on each socket and fills one-frame buffers from a shared provided-buffer
+ * ring. Frames to send are queued and submitted in batches together with the wait
+ * for completions, so the thread makes about one io_uring_enter per batch, instead
+ * of a read or write per frame and a receive thread per board.
+ *
+ * Callbacks run on the completion thread and must not call removeSocket(). Needs
+ * Linux 6.0 (multishot receive); instance() returns nullptr where io_uring is not
+ * usable, and CanSocket falls back to its own threads.
+ */
+class CanIoUring {
+public:
+    using FrameHandler = std::function<void(const struct can_frame&)>;
+    using SendHandler = std::function<void(int result)>;   // Bytes written, or -errno
+
+    static constexpr unsigned SQ_ENTRIES = 2048;
+    static constexpr unsigned RECEIVE_BUFFERS = 4096;        // One frame each, shared; power of two
+    static constexpr unsigned MAX_OUTSTANDING_SENDS = 1024;  // Queued or in flight, all sockets
+
+    struct Client;
+
+    /**
+     * @brief The process-wide reactor, started on first use
+     * @return nullptr if io_uring is unavailable (logged once)
+     */
+    static CanIoUring* instance();
+
+    ~CanIoUring();
+
+    CanIoUring(const CanIoUring&) = delete;
+    CanIoUring& operator=(const CanIoUring&) = delete;
+
+    /**
+     * @brief Arm a multishot receive on a socket
+     * @param on_frame Called for every received frame
+     * @param on_send Called with the result of every send()
+     */
+    Client* addSocket(int fd, FrameHandler on_frame, SendHandler on_send);
+
+    /**
+     * @brief Cancel the socket's receive and wait until no callback can run for it
+     */
+    void removeSocket(Client* client);
+
+    /**
+     * @brief Queue a frame for the next batch
+     * @return false if MAX_OUTSTANDING_SENDS frames are already outstanding
+     */
+    bool send(Client* client, const struct can_frame& frame);
+
+private:
+    struct Request {
+        enum class Kind { Arm, Send, Cancel } kind;
+        Client* client;
+        struct can_frame frame;
+    };
+
+    struct SendSlot {
+        struct can_frame frame;
+        Client* client;
+    };
+
+    CanIoUring() = default;
+
+    bool setup();
+    void completionLoop();
+    void prepareRequests(std::vector<Request>& requests);
+    void handleCompletion(const struct io_uring_cqe& cqe);
+    struct io_uring_sqe* nextSqe();
+    int submit(unsigned wait_for);
+    void prepareReceive(Client* client);
+    void prepareWakeRead();
+    void recycleBuffer(uint16_t buffer);
+
+    int ring_fd_ = -1;
+    int wake_fd_ = -1;                          // eventfd, read by an SQE kept armed
+    uint64_t wake_value_ = 0;
+
+    // Rings shared with the kernel
+    void* ring_memory_ = nullptr;
+    size_t ring_size_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    uint32_t* sq_head_ = nullptr;
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t sq_mask_ = 0;
+    uint32_t sq_entries_ = 0;
+    uint32_t sq_tail_local_ = 0;                // Prepared SQEs; published at submit()
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t cq_mask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+
+    // Provided receive buffers; the ring's tail overlays the first entry's resv field
+    struct io_uring_buf* buffer_ring_ = nullptr;
+    uint16_t buffer_tail_ = 0;
+    std::vector<struct can_frame> receive_frames_;
+
+    std::vector<SendSlot> send_slots_;
+    std::vector<uint32_t> free_send_slots_;     // Completion thread only
+
+    std::mutex mutex_;                          // Guards everything below
+    std::condition_variable removed_;
+    std::vector<Request> requests_;
+    bool wake_posted_ = false;                  // wake_fd_ written since the last drain
+    unsigned outstanding_sends_ = 0;
+    std::list<std::unique_ptr<Client>> clients_;
+    bool running_ = false;
+    std::thread thread_;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "CanTransport.h"
+#include "Metrics.h"
+#include "CanIoUring.h"
 #include <string>
 #include <functional>
 #include <atomic>
@@ -13,23 +16,40 @@
  *
  * Provides a simple interface for sending and receiving CAN frames
  * using Linux SocketCAN. Supports both blocking and non-blocking operations.
+ * This is the kernel backend of CanTransport.
  */
-class CanSocket {
+class CanSocket : public CanTransport {
 public:
     /**
-     * @brief CAN frame receive callback function type
-     * @param frame The received CAN frame
+     * @brief How sockets move frames
+     * - Threads: a receive thread per socket, write() per frame
+     * - IoUring: the shared CanIoUring reactor, falling back to Threads if unavailable
      */
-    using ReceiveCallback = std::function<void(const struct can_frame&)>;
+    enum class IoBackend { Threads, IoUring };
+
+    /**
+     * @brief Select the backend for sockets that start receiving afterwards
+     */
+    static void setIoBackend(IoBackend backend);
 
 private:
+    static std::atomic<IoBackend> io_backend_;
+
+
     int socket_fd_;
     std::string interface_name_;
     std::atomic<bool> receiving_;
     std::thread receive_thread_;
     ReceiveCallback receive_callback_;
+    CanIoUring::Client* uring_client_;   // Set while receiving through CanIoUring
     mutable std::mutex socket_mutex_;
 
+    // Metrics, labelled with the interface
+    MetricCounter frames_tx_;
+    MetricCounter frames_rx_;
+    MetricCounter send_failures_;
+    MetricCounter send_enobufs_;   // Kernel transmit queue full (txqueuelen)
+
 public:
     /**
      * @brief Constructor
@@ -40,49 +60,49 @@ public:
     /**
      * @brief Destructor - ensures socket is closed
      */
-    ~CanSocket();
+    ~CanSocket() override;
 
     /**
      * @brief Open CAN socket and bind to interface
      * @return true if successful, false otherwise
      */
-    bool open();
+    bool open() override;
     
     /**
      * @brief Close CAN socket
      */
-    void close();
+    void close() override;
     
     /**
      * @brief Check if socket is open
      * @return true if socket is open and ready
      */
-    bool isOpen() const;
+    bool isOpen() const override;
 
     /**
      * @brief Send a CAN frame
      * @param frame CAN frame to send
      * @return true if sent successfully, false otherwise
      */
-    bool sendFrame(const struct can_frame& frame);
+    bool sendFrame(const struct can_frame& frame) override;
 
     /**
-     * @brief Start receiving CAN frames in background thread
+     * @brief Start receiving CAN frames in background thread (or through CanIoUring)
      * @param callback Function to call when frame is received
      * @return true if started successfully, false otherwise
      */
-    bool startReceiving(ReceiveCallback callback);
+    bool startReceiving(ReceiveCallback callback) override;
     
     /**
      * @brief Stop receiving CAN frames
      */
-    void stopReceiving();
+    void stopReceiving() override;
     
     /**
      * @brief Check if currently receiving
      * @return true if receive thread is running
      */
-    bool isReceiving() const;
+    bool isReceiving() const override;
 
     /**
      * @brief Receive a single CAN frame (blocking)
@@ -96,7 +116,7 @@ public:
      * @brief Get the CAN interface name
      * @return Interface name string
      */
-    const std::string& getInterfaceName() const;
+    const std::string& getInterfaceName() const override;
 
     /**
      * @brief Set CAN filters
@@ -104,13 +124,24 @@ public:
      * @param filter_count Number of filters
      * @return true if filters set successfully, false otherwise
      */
-    bool setFilters(const struct can_filter* filters, size_t filter_count);
+    bool setFilters(const struct can_filter* filters, size_t filter_count) override;
 
 private:
     /**
      * @brief Receive thread function
      */
     void receiveLoop();
+
+    /**
+     * @brief Count a received frame and pass it to the callback
+     */
+    void deliverFrame(const struct can_frame& frame);
+
+    /**
+     * @brief Account for a write completed by CanIoUring
+     * @param result Bytes written, or -errno
+     */
+    void onSendResult(int result);
     
     /**
      * @brief Convert errno to string for error reporting
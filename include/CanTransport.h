@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <linux/can.h>
+
+/**
+ * @brief Abstract CAN frame transport
+ *
+ * Decouples CanBoard from the kernel: a transport moves can_frame structures
+ * between the simulator and whoever is listening on the named interface.
+ * Backends:
+ * - CanSocket: Linux SocketCAN (e.g., "can0", "vcan0")
+ * - LoopbackTransport: in-process, zero-copy (e.g., "loop:bus0")
+ * - ShmTransport: shared memory with a co-located controller (e.g., "shm:bus0")
+ */
+class CanTransport {
+public:
+    /**
+     * @brief CAN frame receive callback function type
+     * @param frame The received CAN frame (only valid for the duration of the call)
+     */
+    using ReceiveCallback = std::function<void(const struct can_frame&)>;
+
+    virtual ~CanTransport() = default;
+
+    /**
+     * @brief Open the transport and attach to the interface
+     * @return true if successful, false otherwise
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief Close the transport (also stops receiving)
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief Check if transport is open
+     * @return true if open and ready
+     */
+    virtual bool isOpen() const = 0;
+
+    /**
+     * @brief Send a CAN frame
+     * @param frame CAN frame to send
+     * @return true if sent successfully, false otherwise
+     */
+    virtual bool sendFrame(const struct can_frame& frame) = 0;
+
+    /**
+     * @brief Start delivering received frames to a callback
+     * @param callback Function to call when frame is received
+     * @return true if started successfully, false otherwise
+     */
+    virtual bool startReceiving(ReceiveCallback callback) = 0;
+
+    /**
+     * @brief Stop delivering received frames
+     */
+    virtual void stopReceiving() = 0;
+
+    /**
+     * @brief Check if currently receiving
+     */
+    virtual bool isReceiving() const = 0;
+
+    /**
+     * @brief Set receive filters (SocketCAN semantics; no filters = receive all)
+     * @param filters Array of CAN filters
+     * @param filter_count Number of filters
+     * @return true if filters set successfully, false otherwise
+     */
+    virtual bool setFilters(const struct can_filter* filters, size_t filter_count) = 0;
+
+    /**
+     * @brief Get the interface name this transport was created for
+     */
+    virtual const std::string& getInterfaceName() const = 0;
+
+    /**
+     * @brief Create the backend matching an interface name
+     * @param interface_name "loop:<name>" for the in-process loopback, "shm:<name>" or
+     *                       "shm-poll:<name>" for shared memory, anything else for SocketCAN
+     * @return Unopened transport instance
+     */
+    static std::unique_ptr<CanTransport> create(const std::string& interface_name);
+
+    /**
+     * @brief Apply SocketCAN filter semantics in user space
+     * @param filters Array of CAN filters (CAN_INV_FILTER honoured)
+     * @param filter_count Number of filters, 0 accepts every frame
+     * @param frame Frame to test
+     * @return true if any filter accepts the frame
+     */
+    static bool filterAccepts(const struct can_filter* filters, size_t filter_count, const struct can_frame& frame) {
+        if (filter_count == 0) {
+            return true;
+        }
+        for (size_t i = 0; i < filter_count; ++i) {
+            bool match = (frame.can_id & filters[i].can_mask) == (filters[i].can_id & filters[i].can_mask);
+            if (filters[i].can_id & CAN_INV_FILTER) {
+                match = !match;
+            }
+            if (match) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
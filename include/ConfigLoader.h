@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Servo.h"
+#include "KinematicChain.h"
 #include <vector>
 #include <string>
 
@@ -15,9 +16,45 @@ struct ServoConfig {
     bool encoderDirectionInverted = false;
     uint32_t canId = 0x10;
     std::string canInterface = "vcan0";
+    uint32_t canBitrate = 0;             // Modeled bus bitrate in bit/s (0 = ideal bus)
+    std::string transmitMode = "fixed";  // "fixed" or "onChange"
+    long positionDeadbandSteps = 0;
+    double velocityDeadbandRPM = 0.0;
+    double minTransmitIntervalMs = 10.0;
+    double maxTransmitIntervalMs = 1000.0;
+    bool timestampedStatus = false;      // Follow each 0x13 with a 0x14 latch timestamp frame
+    std::string velocityEstimator = "model";  // "model", "difference", "average" or "tracking"
+    int velocityAverageWindow = 8;            // Samples for "average" (power of two)
+    double velocityTrackingBandwidthHz = 20.0;  // Loop bandwidth for "tracking"
+    double holdRateHz = 1000.0;          // Effort 0 position-hold loop rate (0 = stop without hold)
+    double holdKp = 200.0;               // Effort per radian
+    double holdKi = 50.0;
+    double holdKd = 10.0;
+    bool fixedPoint = false;             // Deterministic Q32.32 motor/encoder integration
+    std::string motorModel = "firstOrder";  // "firstOrder" or "electromechanical"
+    ElectromechanicalModel::Parameters electromechanical;  // Flat keys, see ConfigLoader.cpp
+    double encoderReadHz = 300.0;        // Board timer frequencies
+    double controlUpdateHz = 300.0;
+    double canTransmitHz = 100.0;
+    std::string loadProfile;             // Recorded load profile file (empty = none)
+    int loadProfileChannel = 0;
+    double loadProfileScale = 1.0;
+    bool loadProfileLoop = true;
+    double loadDampingNms = 1.0;         // First-order model: load torque per rad/s of velocity droop
+    bool telemetry = false;              // Capture with --telemetry (no servo flagged = all servos)
     std::string name = "servo";  // Optional name for identification
 };
 
+/**
+ * @brief Engine-wide settings (top-level keys of an object-form servos.json)
+ */
+struct SimulationConfig {
+    double simulationFrequencyHz = 20000.0;  // Physics tick rate
+    double integrationAccuracy = 0.01;       // Max integration step / timeConstant (0 = every tick)
+    uint32_t chainThreads = 1;               // Threads stepping kinematic chains, incl. physics thread
+    uint32_t timerThreads = 1;               // Threads running the board timers of every servo
+};
+
 /**
  * @brief Configuration loader for servo systems
  * 
@@ -32,6 +69,37 @@ public:
      */
     static std::vector<ServoConfig> loadFromFile(const std::string& filename);
 
+    /**
+     * @brief Load engine-wide settings from JSON file
+     *
+     * The file is either a plain array of servo objects, or an object holding
+     * engine settings next to a "servos" array:
+     *   { "simulationFrequencyHz": 10000, "servos": [ ... ] }
+     * @param filename Path to JSON configuration file
+     * @return Engine settings, defaults for keys that are absent
+     */
+    static SimulationConfig loadSimulationConfig(const std::string& filename);
+
+    /**
+     * @brief Load kinematic chain descriptions from JSON file (e.g. chains.json)
+     *
+     * The file is an array of chains, each with a "name", optional "gravity" and a
+     * "joints" array; see KinematicChain.h for the joint keys.
+     * @param filename Path to JSON chain file
+     * @return Chain descriptions, empty if the file does not exist or on error
+     */
+    static std::vector<KinematicChain::Config> loadChainsFromFile(const std::string& filename);
+
+    /**
+     * @brief Map a chain's joint servo names to positions in a servo configuration list
+     * @param chain Chain description
+     * @param servos Servo configurations, in the order the servos were added to the engine
+     * @param indices Output servo index of each joint
+     * @return true if every joint names a known servo
+     */
+    static bool resolveChainServos(const KinematicChain::Config& chain, const std::vector<ServoConfig>& servos,
+                                   std::vector<size_t>& indices);
+
     /**
      * @brief Create servos from configuration vector
      * @param configs Vector of servo configurations
@@ -54,12 +122,21 @@ public:
      */
     static bool saveToFile(const std::vector<ServoConfig>& configs, const std::string& filename);
 
+    // Board settings of a servo configuration, as createServos() applies them
+    static TransmitPolicy transmitPolicyFromConfig(const ServoConfig& config);
+    static VelocityEstimator::Config velocityEstimatorFromConfig(const ServoConfig& config);
+    static PositionHold::Config positionHoldFromConfig(const ServoConfig& config);
+    static BoardTimerRates timerRatesFromConfig(const ServoConfig& config);
+
 private:
     static bool parseJsonValue(const std::string& json, const std::string& key, double& value);
     static bool parseJsonValue(const std::string& json, const std::string& key, int& value);
     static bool parseJsonValue(const std::string& json, const std::string& key, uint32_t& value);
+    static bool parseJsonValue(const std::string& json, const std::string& key, long& value);
     static bool parseJsonValue(const std::string& json, const std::string& key, bool& value);
     static bool parseJsonValue(const std::string& json, const std::string& key, std::string& value);
+    static bool parseJsonValue(const std::string& json, const std::string& key, double (&value)[3]);
+    static std::string readFile(const std::string& filename);
     static std::string trimWhitespace(const std::string& str);
     static std::vector<std::string> splitJsonObjects(const std::string& json);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ConfigLoader.h"
+#include "Metrics.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SimulationEngine;
+
+/**
+ * @brief Applies edits of servos.json to a running simulation
+ *
+ * An inotify watch on the file's directory (editors often save by renaming a new
+ * file over the old one) reloads the file once writes have settled and diffs it
+ * against the running servos, matched by CAN interface and ID:
+ * - motor, position-hold, timer, transmit and velocity-estimator settings change
+ *   in place, all at the same tick boundary, keeping the servo's state and CAN link
+ * - servos new to the file are created and started, missing ones stopped and removed
+ * - other changes (encoder, motor model, bitrate, load profile) replace the servo
+ * Servos that are unchanged are not touched, and their board timers keep their phase.
+ * The engine refuses to add or remove servos that drive a chain, play a load
+ * profile or are captured by telemetry, and any servo in state mirror or SYNC mode;
+ * those changes are logged and wait for a restart.
+ *
+ * Example usage (main.cpp):
+ *   ConfigWatcher watcher(simulation, "servos.json", servo_configs);
+ *   watcher.start();
+ *   ...
+ *   watcher.stop();
+ */
+class ConfigWatcher {
+public:
+    // Quiet time after the last write before the file is reloaded
+    static constexpr int SETTLE_MS = 200;
+
+    /**
+     * @param engine Engine running the servos of `running`
+     * @param path Configuration file to watch
+     * @param running Configuration of each engine servo, in engine index order
+     */
+    ConfigWatcher(SimulationEngine& engine, const std::string& path, const std::vector<ServoConfig>& running);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief Start watching the file
+     * @return false if the inotify watch cannot be set up
+     */
+    bool start();
+    void stop();
+
+    /**
+     * @brief Reload the file and apply the difference to the engine now
+     * @return false if the file holds no servos or repeats a CAN ID (nothing changes)
+     */
+    bool reload();
+
+private:
+    void watchLoop();
+    void applySettings(const std::vector<size_t>& indices, const std::vector<ServoConfig>& configs);
+
+    SimulationEngine& engine_;
+    std::string path_;
+    std::vector<ServoConfig> configs_;      // Per engine servo, kept in step with its indices
+    int inotifyFd_;
+    std::atomic<bool> watching_;
+    std::thread thread_;
+    MetricCounter reloads_;
+    MetricCounter rejectedReloads_;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <semaphore.h>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Attributes CPU time to servos and boards, counted in TSC cycles
+ *
+ * Code paths charge their cycles to an account of an owner (a board's CAN ID and
+ * interface, or "servo N" without a board) and an activity. An account is written
+ * by one thread only, with plain loads and stores, unless it was registered as
+ * shared: a board's receive work runs on the sending thread for loopback and
+ * shared-memory transports, so those accounts are charged with fetch_add. While enabled, a sampler thread
+ * snapshots every account each WINDOW_MS, and report() compares against the
+ * snapshot WINDOWS windows back: the table shows the recent load as a share of
+ * one core, not an average since start. SIGUSR2 prints it to stdout.
+ *
+ * While disabled, an accounted scope costs one relaxed load.
+ */
+class CpuAccounting {
+public:
+    enum class Activity : uint8_t { Physics, Timers, Receive };
+    static constexpr size_t ACTIVITIES = 3;
+
+    static constexpr int WINDOW_MS = 1000;
+    static constexpr size_t WINDOWS = 10;
+
+    struct Account {
+        std::atomic<uint64_t> cycles{0};
+        bool shared = false;                    // Charged from more than one thread
+    };
+
+    static CpuAccounting& instance();
+
+    CpuAccounting(const CpuAccounting&) = delete;
+    CpuAccounting& operator=(const CpuAccounting&) = delete;
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief New account (obtain at setup)
+     * @param shared false if one thread only charges it
+     */
+    Account* account(const std::string& owner, Activity activity, bool shared = false);
+
+    /**
+     * @brief Start counting and sampling; SIGUSR2 prints the top_n owners
+     */
+    void enable(size_t top_n);
+    void disable();
+
+    /**
+     * @brief Table of the top_n owners by CPU share over the sliding window
+     */
+    std::string report(size_t top_n) const;
+
+    // TSC on x86 (the virtual counter on ARM), steady clock nanoseconds elsewhere
+    static uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        uint64_t cycles;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(cycles));
+        return cycles;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static void charge(Account* account, uint64_t cycles) {
+        if (account->shared) {
+            account->cycles.fetch_add(cycles, std::memory_order_relaxed);
+        } else {
+            account->cycles.store(account->cycles.load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Entry {
+        std::string owner;
+        Activity activity;
+        Account account;
+    };
+
+    // Totals of every account (in registration order) at one instant
+    struct Sample {
+        uint64_t cycles;
+        std::chrono::steady_clock::time_point time;
+        std::vector<uint64_t> accounts;
+    };
+
+    CpuAccounting() = default;
+
+    Sample takeSample() const;      // mutex_ held
+    void samplerLoop();
+    static void onReportSignal(int signal);
+
+    static std::atomic<bool> enabled_;
+
+    mutable std::mutex mutex_;                  // Guards entries_ and samples_
+    std::deque<Entry> entries_;
+    std::deque<Sample> samples_;                // Oldest first, at most WINDOWS + 1
+    size_t top_n_ = 0;
+    sem_t report_request_;                      // Posted by the signal handler
+    std::atomic<bool> sampler_running_{false};
+    std::thread sampler_;
+    struct sigaction previous_action_ = {};
+};
+
+/**
+ * @brief Charges the enclosing scope's cycles to an account when accounting is enabled
+ */
+class CpuScope {
+private:
+    CpuAccounting::Account* account_;
+    uint64_t started_;
+
+public:
+    explicit CpuScope(CpuAccounting::Account* account)
+        : account_(CpuAccounting::isEnabled() ? account : nullptr),
+          started_(account_ ? CpuAccounting::readCycles() : 0) {}
+
+    ~CpuScope() {
+        if (account_) {
+            CpuAccounting::charge(account_, CpuAccounting::readCycles() - started_);
+        }
+    }
+
+    CpuScope(const CpuScope&) = delete;
+    CpuScope& operator=(const CpuScope&) = delete;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Motor.h"
+
+/**
+ * @brief Optional DC motor model with armature and load dynamics
+ *
+ * Replaces the first-order velocity lag of Motor::update() with
+ *   L di/dt = V - R i - Ke w
+ *   J dw/dt = Kt i - b w - Tc sign(w) - T_load
+ * where the control signal sets the armature voltage V as a fraction of the supply.
+ * All quantities are referred to the output shaft (the encoder side of any gearbox).
+ *
+ * The electrical time constant L/R is usually far below the physics tick, so explicit
+ * Euler would blow up. Each step instead solves the linear part implicitly (the 2x2
+ * system is inverted once per step size and cached), which is unconditionally stable
+ * and costs a handful of multiplies. Coulomb friction is resolved on top of that
+ * step: it opposes motion, and holds the shaft at rest while the driving torque stays
+ * below it. An optional driver current limit clamps the armature current.
+ *
+ * After each step the velocity and position are published to the Motor, so the rest
+ * of the simulator reads them through its usual getters.
+ */
+class ElectromechanicalModel {
+public:
+    struct Parameters {
+        double supplyVoltageV = 24.0;
+        double resistanceOhm = 2.0;
+        double inductanceH = 0.002;
+        double torqueConstantNmPerA = 3.0;
+        double backEmfConstantVsPerRad = 3.0;
+        double inertiaKgM2 = 0.005;
+        double viscousFrictionNms = 0.01;
+        double coulombFrictionNm = 0.05;
+        double loadTorqueNm = 0.0;       ///< Constant load, added to Motor::getLoad()
+        double currentLimitA = 0.0;      ///< Driver current limit (0 = unlimited)
+    };
+
+private:
+    Parameters parameters_;
+
+    // Implicit step matrix inverse for dt_, row-major
+    double dt_;
+    double inverse_[4];
+    double velocity_denominator_;    // 1 + dt b / J, for current-limited steps
+
+    double current_;                 // Armature current (A)
+
+public:
+    ElectromechanicalModel();
+    explicit ElectromechanicalModel(const Parameters& parameters);
+
+    /**
+     * @brief Advance one step and publish velocity and position to the motor
+     * @param motor Motor providing the control signal, receives the mechanical state
+     * @param dt Time step in seconds
+     */
+    void update(Motor& motor, double dt);
+
+    /**
+     * @brief Reset the electrical state (the motor resets its own)
+     */
+    void reset();
+
+    double getCurrent() const { return current_; }
+    const Parameters& getParameters() const { return parameters_; }
+
+private:
+    void configure(double dt);
+};
@@ -87,6 +87,7 @@ private:
     double fractional_steps_; // Accumulated fractional steps
     int bit_resolution_;      // Encoder bit resolution (e.g., 12 bits)
     long max_steps_;          // Maximum steps per revolution (2^bit_resolution)
+    long step_mask_;          // max_steps_ - 1, wraps positions since max_steps_ is a power of two
     bool direction_inverted_; // Encoder direction: false = normal, true = inverted
 
     // Cached values for performance optimization
@@ -108,12 +109,35 @@ public:
     // Update encoder position based on motor rotation
     void update(double angular_velocity, double dt);
 
+    /**
+     * @brief Update specialized on counting direction (branch-free inner loop)
+     * @tparam DirectionInverted Must match isDirectionInverted()
+     */
+    template <bool DirectionInverted>
+    void step(double angular_velocity, double dt) {
+        double position_change_radians = angular_velocity * dt;
+        if constexpr (DirectionInverted) {
+            position_change_radians = -position_change_radians;
+        }
+
+        // Whole steps move the position, the remainder keeps accumulating
+        fractional_steps_ += position_change_radians * steps_per_radian_;
+        long whole_steps = static_cast<long>(fractional_steps_);
+        fractional_steps_ -= whole_steps;
+
+        // Absolute encoders wrap around at max_steps (two's complement mask also wraps negatives)
+        position_steps_ = (position_steps_ + whole_steps) & step_mask_;
+    }
+
     // Get current position in steps
     long getPositionSteps() const;
 
     // Get current position in radians
     double getPositionRadians() const;
 
+    // Set position in steps and drop accumulated fractional steps (used by FixedPointModel)
+    void setPositionSteps(long steps);
+
     // Reset encoder position to zero
     void reset();
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Servo;
+
+/**
+ * @brief Fixed-point state of a group of servos, stepped as structure-of-arrays
+ *
+ * The engine moves the Q32.32 state of a kernel group's fixed-point servos into one
+ * array per quantity and steps them in a flat integer loop the compiler vectorizes
+ * (AVX-512, AVX2 and SSE4.2 clones are picked at run time on x86-64). The arithmetic
+ * is FixedPointModel::step()'s, so results stay bit-exact.
+ *
+ * Motor and Encoder only see the state when publish() writes it back; the engine
+ * publishes where it is read (board observation periods, SYNC latches, the state
+ * mirror, telemetry, edits and stop). Control signals are read from the Motor on
+ * load() and after a board actuates.
+ *
+ * Example usage:
+ *   lanes.load(group_servos, dt);
+ *   lanes.step();
+ *   lanes.publish();
+ */
+class FixedPointLanes {
+private:
+    std::vector<Servo*> servos_;
+
+    // Per lane coefficients, Q32.32 (alpha is Q0.32)
+    std::vector<int64_t> velocityPerSignal_;
+    std::vector<int64_t> maxVelocity_;
+    std::vector<int64_t> alpha_;
+    std::vector<int64_t> revolutionMask_;
+
+    // Per lane input and state
+    std::vector<int64_t> control_;
+    std::vector<int64_t> velocity_;
+    std::vector<int64_t> position_;
+    std::vector<int64_t> revolutions_;
+
+public:
+    /**
+     * @brief Take over the state of fixed-point servos, replacing any previous lanes
+     * @param servos Servos with a FixedPointModel
+     * @param dt Time step in seconds of every step()
+     */
+    void load(const std::vector<Servo*>& servos, double dt);
+
+    /**
+     * @brief Advance every lane one step
+     */
+    void step();
+
+    /**
+     * @brief Write every lane back to its servo's FixedPointModel, Motor and Encoder
+     */
+    void publish() const;
+
+    /**
+     * @brief Read a lane's control signal from its Motor again
+     */
+    void reloadControlSignal(size_t lane);
+
+    /**
+     * @brief Encoder position of a lane, as publish() would write it
+     */
+    long getEncoderSteps(size_t lane) const;
+
+    size_t size() const { return servos_.size(); }
+};
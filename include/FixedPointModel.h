@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Motor.h"
+#include "Encoder.h"
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Deterministic fixed-point motor and encoder integration
+ *
+ * Optional replacement for Motor::update() + Encoder::update() that keeps the
+ * servo state in Q32.32 integers: velocity in encoder steps per tick and motor-side
+ * position in encoder steps within one revolution, plus a whole-revolution counter.
+ * Only integer add, shift, mask and 32x32->64 multiplies run per tick, so results
+ * are bit-exact across compilers, flags and machines, and the kernel maps onto
+ * 64-bit SIMD lanes.
+ *
+ * Coefficients are derived from the motor parameters and dt once, when the step
+ * size is first seen or changes. After each step the state is published to the
+ * Motor and Encoder so the rest of the simulator reads it through their usual
+ * getters. Encoder steps use floor semantics (the double path truncates towards
+ * zero), so the two paths can differ by one step while moving backwards.
+ *
+ * The engine steps grouped servos through FixedPointLanes instead, which holds
+ * the same state as structure-of-arrays and publishes it less often.
+ */
+class FixedPointModel {
+    friend class FixedPointLanes;
+
+public:
+    static constexpr int FRACTION_BITS = 32;
+    static constexpr double TWO_PI = 2.0 * M_PI;
+    // One revolution in Q32.32 steps must fit an int64_t
+    static constexpr int MAX_BIT_RESOLUTION = 30;
+
+private:
+    double dt_;                      // Step size the coefficients were derived for, 0 = not seeded
+
+    // Per-tick coefficients, Q32.32 (alpha is Q0.32)
+    int64_t velocity_per_signal_q32_;  // Steady-state steps/tick per control signal unit
+    int64_t max_velocity_q32_;         // Velocity limit in steps/tick
+    int64_t alpha_q32_;                // dt / time constant
+
+    // Encoder geometry
+    int bit_resolution_;
+    int64_t revolution_mask_q32_;      // (max_steps << 32) - 1
+
+    // Publishing to double state
+    double radians_per_q32_;
+    double radians_per_second_per_q32_;
+
+    // State
+    int64_t velocity_q32_;             // Steps per tick
+    int64_t position_q32_;             // Motor-side steps within the current revolution
+    int64_t revolutions_;
+
+public:
+    FixedPointModel();
+
+    /**
+     * @brief Advance one step and publish the result to the motor and encoder
+     * @param motor Motor providing the control signal and parameters, receives velocity/position
+     * @param encoder Encoder providing resolution and direction, receives the step count
+     * @param dt Time step in seconds (constant in steady state)
+     */
+    void update(Motor& motor, Encoder& encoder, double dt);
+
+    /**
+     * @brief update() specialized on the encoder's counting direction
+     * @tparam DirectionInverted Must match encoder.isDirectionInverted()
+     */
+    template <bool DirectionInverted>
+    void step(Motor& motor, Encoder& encoder, double dt) {
+        if (dt != dt_) {
+            configure(motor, encoder, dt);
+        }
+
+        // First-order velocity response towards the commanded steady state, then limit
+        int64_t target_q32 = motor.getControlSignal() * velocity_per_signal_q32_;
+        velocity_q32_ += mulQ32(target_q32 - velocity_q32_, alpha_q32_);
+        velocity_q32_ = std::clamp(velocity_q32_, -max_velocity_q32_, max_velocity_q32_);
+
+        // Integrate position; whole revolutions carry out of the masked phase
+        int64_t position_q32 = position_q32_ + velocity_q32_;
+        revolutions_ += position_q32 >> (FRACTION_BITS + bit_resolution_);
+        position_q32_ = position_q32 & revolution_mask_q32_;
+
+        publish<DirectionInverted>(motor, encoder);
+    }
+
+    /**
+     * @brief Write the state to the motor and encoder through their regular interfaces
+     */
+    template <bool DirectionInverted>
+    void publish(Motor& motor, Encoder& encoder) const {
+        int64_t encoder_q32 = DirectionInverted ? (-position_q32_ & revolution_mask_q32_) : position_q32_;
+        encoder.setPositionSteps(static_cast<long>(encoder_q32 >> FRACTION_BITS));
+        motor.setState(static_cast<double>(velocity_q32_) * radians_per_second_per_q32_,
+                       static_cast<double>(revolutions_) * TWO_PI
+                       + static_cast<double>(position_q32_) * radians_per_q32_);
+    }
+
+    /**
+     * @brief Forget the state; the next update() re-seeds it from the motor
+     */
+    void reset();
+
+    int64_t getVelocityQ32() const { return velocity_q32_; }
+    int64_t getPositionQ32() const { return position_q32_; }
+    int64_t getRevolutions() const { return revolutions_; }
+
+    /**
+     * @brief floor(value * factor / 2^32) for a Q0.32 factor, without a 128-bit product
+     */
+    static int64_t mulQ32(int64_t value, int64_t factor_q32) {
+        int64_t high = value >> FRACTION_BITS;
+        uint64_t low = static_cast<uint64_t>(value) & 0xFFFFFFFFULL;
+        return high * factor_q32 + static_cast<int64_t>((low * static_cast<uint64_t>(factor_q32)) >> FRACTION_BITS);
+    }
+
+private:
+    void configure(const Motor& motor, const Encoder& encoder, double dt);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Physics tick that the state of a group of servos belongs to
+ *
+ * Servos integrated with a coarse step hold the state of their group's last step,
+ * up to `decimation - 1` ticks behind the engine's tick counter. The physics thread
+ * brackets every step of the group with beginStep()/endStep() like a seqlock, so a
+ * board timer reading the state on another thread learns which tick it belongs to.
+ */
+struct IntegrationClock {
+    std::atomic<uint32_t> sequence{0};                  // Odd while the group is being stepped
+    std::atomic<uint64_t> tick{0};                      // Tick of the last completed step
+
+    void beginStep() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endStep(uint64_t stepped_to) {
+        tick.store(stepped_to, std::memory_order_relaxed);
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Servo.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Serial chain of revolute joints coupling servos through rigid-body dynamics
+ *
+ * Each joint is driven by one servo. The servo's control signal sets a target joint
+ * velocity (control / maxControlSignal * maxVelocityRPM), and the joint's drive applies
+ * torque = velocityGain * (target - velocity), limited to maxTorqueNm. With the
+ * default gain, derived from the joint's articulated inertia at start and the servo's
+ * timeConstant, an unloaded joint reproduces the servo's first-order response. Gravity
+ * and the inertial coupling between links then make it sag, lag and interact like a
+ * real arm.
+ *
+ * Joint accelerations come from Featherstone's articulated-body algorithm: three
+ * passes over the joints, O(n) in chain length, with all storage allocated up front.
+ * Integration is semi-implicit Euler. After each step the joint angle and velocity are
+ * published to the servo's Motor and Encoder.
+ *
+ * Example chain (chains.json):
+ *   [ { "name": "arm", "gravity": [0, 0, -9.81], "joints": [
+ *       { "servo": "servo_1", "origin": [0, 0, 0.1], "rpy": [0, 0, 0], "axis": [0, 0, 1],
+ *         "mass": 2.0, "com": [0, 0, 0.1], "inertia": [0.02, 0.02, 0.005], "maxTorqueNm": 40 } ] } ]
+ */
+class KinematicChain {
+public:
+    static constexpr size_t MAX_JOINTS = 32;
+
+    struct JointConfig {
+        std::string servo;                     ///< Name of the driving servo
+        double origin[3] = {0.0, 0.0, 0.0};    ///< Joint frame position in the parent link frame (m)
+        double rpy[3] = {0.0, 0.0, 0.0};       ///< Joint frame orientation in the parent link frame (rad)
+        double axis[3] = {0.0, 0.0, 1.0};      ///< Rotation axis in the joint frame
+        double mass = 1.0;                     ///< Link mass (kg)
+        double com[3] = {0.0, 0.0, 0.0};       ///< Link centre of mass in the joint frame (m)
+        double inertia[3] = {0.01, 0.01, 0.01};  ///< Principal inertia about the COM, joint frame axes (kg m^2)
+        double maxTorqueNm = 50.0;             ///< Drive torque limit
+        double velocityGainNms = 0.0;          ///< Drive gain (0 = derive from the servo's timeConstant)
+    };
+
+    struct Config {
+        std::string name = "chain";
+        double gravity[3] = {0.0, 0.0, -9.81};  ///< In the base frame (m/s^2)
+        std::vector<JointConfig> joints;
+    };
+
+private:
+    struct SpatialVector {
+        double v[6];  // Angular part first, then linear
+    };
+
+    struct SpatialMatrix {
+        double m[6][6];
+    };
+
+    struct Joint {
+        Servo* servo;
+        double tree_rotation[3][3];  // Parent link frame -> joint frame at q = 0
+        double tree_translation[3];
+        double axis[3];
+        SpatialMatrix inertia;       // Link spatial inertia about the joint frame origin
+        double max_torque;
+        double velocity_gain;
+        double target_per_signal;    // Target velocity (rad/s) per control signal unit
+
+        // State
+        double position;
+        double velocity;
+        double torque;
+
+        // Articulated-body algorithm workspace
+        SpatialMatrix transform;     // Parent -> this joint (Plücker)
+        SpatialVector spatial_velocity;
+        SpatialVector bias_acceleration;
+        SpatialMatrix articulated_inertia;
+        SpatialVector articulated_bias;
+        SpatialVector inertia_axis;  // U = IA S
+        double axis_inertia;         // d = S^T U
+        double bias_torque;          // u = tau - S^T pA
+        SpatialVector acceleration;
+    };
+
+    std::string name_;
+    SpatialVector base_acceleration_;  // -gravity, so gravity acts as a base acceleration
+    std::vector<Joint> joints_;
+
+public:
+    /**
+     * @brief Build a chain from its description
+     * @param config Chain description
+     * @param servos Driving servo of each joint, in joint order (must outlive the chain)
+     * @throws std::invalid_argument if the chain is empty, longer than MAX_JOINTS, or
+     *         the servo count does not match the joints
+     */
+    KinematicChain(const Config& config, const std::vector<Servo*>& servos);
+
+    /**
+     * @brief Advance the chain one step and publish joint states to the servos
+     * @param dt Time step in seconds
+     */
+    void step(double dt);
+
+    const std::string& getName() const { return name_; }
+    size_t getJointCount() const { return joints_.size(); }
+    double getJointTorque(size_t index) const { return joints_[index].torque; }
+
+private:
+    void computeAccelerations(double* accelerations);
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Load profile file layout
+ *
+ * A 32-byte header followed by frameCount frames of `channels` little-endian
+ * float32 samples, recorded at sampleRateHz. Samples are load torques in Nm at the
+ * output shaft. Use `motor_simulator --make-profile` to convert a CSV recording.
+ */
+constexpr uint32_t LOAD_PROFILE_MAGIC = 0x4652504C;  // "LPRF"
+constexpr uint32_t LOAD_PROFILE_VERSION = 1;
+
+struct LoadProfileHeader {
+    uint32_t magic;
+    uint32_t version;
+    double sampleRateHz;
+    uint32_t channels;
+    uint32_t reserved;
+    uint64_t frameCount;
+};
+
+static_assert(sizeof(LoadProfileHeader) == 32, "Load profile header layout is part of the file format");
+
+/**
+ * @brief One playback cursor over a load profile file, streamed through mmap'd chunks
+ *
+ * At most three chunks of CHUNK_BYTES are mapped at a time: the one being read,
+ * the next one, and a consumed one waiting to be unmapped. A streamer thread calls
+ * service() to map the next chunk and fault its pages in ahead of playback, and to
+ * unmap and drop consumed chunks, so multi-GB profiles never load fully into RAM and
+ * the physics thread never waits on file I/O. Chunks change hands through atomic
+ * pointers, without locks.
+ *
+ * If the streamer falls behind, nextSample() reports an underrun and the caller holds
+ * the previous value.
+ */
+class LoadProfile {
+public:
+    static constexpr size_t CHUNK_BYTES = 4u << 20;
+
+    /**
+     * @param path Profile file
+     * @param channel Channel of each frame to play
+     * @param loop Restart at the beginning at the end, instead of holding the last sample
+     */
+    LoadProfile(const std::string& path, uint32_t channel = 0, bool loop = true);
+    ~LoadProfile();
+
+    LoadProfile(const LoadProfile&) = delete;
+    LoadProfile& operator=(const LoadProfile&) = delete;
+
+    /**
+     * @brief Validate the file and map the first two chunks
+     * @return true if the profile is ready to play
+     */
+    bool open();
+    void close();
+
+    const std::string& getPath() const { return path_; }
+    double getSampleRate() const { return header_.sampleRateHz; }
+    uint64_t getFrameCount() const { return header_.frameCount; }
+
+    /**
+     * @brief Read the next sample (physics thread only)
+     * @param sample Output sample, unchanged when false is returned
+     * @return false at the end of a non-looping profile, or on an underrun
+     */
+    bool nextSample(float& sample);
+
+    // Chunks that were not mapped in time
+    uint64_t getUnderruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Unmap consumed chunks and map the next one (streamer thread only)
+     */
+    void service();
+
+    /**
+     * @brief Convert a CSV recording (one frame per line, one column per channel)
+     * @param csv_path Input file; empty lines and lines starting with '#' are skipped
+     * @param profile_path Output profile file
+     * @param sample_rate_hz Recording sample rate
+     * @return true if the profile was written
+     */
+    static bool convertCsv(const std::string& csv_path, const std::string& profile_path, double sample_rate_hz);
+
+private:
+    struct Chunk {
+        void* mapping;          // nullptr = free slot
+        size_t mappingLength;
+        const float* frames;
+        uint64_t firstFrame;
+        uint64_t frameCount;
+    };
+
+    static constexpr uint64_t NO_CHUNK = UINT64_MAX;
+
+    bool mapChunk(Chunk& chunk, uint64_t first_frame);
+    void unmapChunk(Chunk& chunk);
+    uint64_t nextChunkStart(const Chunk& chunk) const;
+
+    std::string path_;
+    uint32_t channel_;
+    bool loop_;
+    int fd_;
+    LoadProfileHeader header_;
+    uint64_t frames_per_chunk_;
+
+    Chunk chunks_[3];
+    Chunk* current_;                 // Physics thread
+    uint64_t frame_;                 // Next frame to read (physics thread)
+    Chunk* last_mapped_;             // Streamer thread
+    std::atomic<Chunk*> next_;       // Mapped by the streamer, taken by the physics thread
+    std::atomic<Chunk*> retired_;    // Consumed by the physics thread, unmapped by the streamer
+    std::atomic<uint64_t> underruns_;
+};
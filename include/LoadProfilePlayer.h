@@ -0,0 +1,76 @@
+#pragma once
+
+#include "LoadProfile.h"
+#include "Motor.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Plays load profiles into motors, interpolated at the physics tick rate
+ *
+ * Per-profile interpolation state is kept as structure-of-arrays of SIMD lanes, so
+ * the per-tick kernel is one branch-free vector loop. Only profiles whose interpolation crosses a sample boundary take the
+ * scalar path to read their next sample. One streamer thread keeps every profile's
+ * next chunk mapped ahead of playback.
+ */
+class LoadProfilePlayer {
+private:
+    std::vector<std::unique_ptr<LoadProfile>> profiles_;
+    std::vector<Motor*> motors_;
+    std::vector<double> scales_;
+
+    // KERNEL_LANES profiles per element; the GCC/Clang vector extension lowers the
+    // arithmetic to the target's SIMD instructions
+    static constexpr size_t KERNEL_LANES = 4;
+    typedef double Lanes __attribute__((vector_size(KERNEL_LANES * sizeof(double))));
+
+    // Interpolation state, padded to whole Lanes
+    std::vector<Lanes> phase_;       // Position between the two current samples [0, 1)
+    std::vector<Lanes> increment_;   // Phase advance per tick (sample rate / tick rate)
+    std::vector<Lanes> start_;       // Scaled sample at phase 0
+    std::vector<Lanes> delta_;       // Scaled difference to the sample at phase 1
+    std::vector<Lanes> value_;
+
+    std::atomic<bool> streaming_;
+    std::thread streamer_;
+
+public:
+    // How often the streamer checks for consumed chunks (each chunk lasts seconds or more)
+    static constexpr int STREAM_POLL_MS = 2;
+
+    LoadProfilePlayer();
+    ~LoadProfilePlayer();
+
+    /**
+     * @brief Play an opened profile into a motor's load (call before start)
+     * @param profile Opened profile
+     * @param motor Motor receiving the load (must outlive the player)
+     * @param scale Factor applied to every sample
+     */
+    void add(std::unique_ptr<LoadProfile> profile, Motor* motor, double scale = 1.0);
+    size_t size() const { return profiles_.size(); }
+
+    // Whether a profile plays into this motor
+    bool drives(const Motor* motor) const;
+
+    /**
+     * @brief Load the first samples and start streaming
+     * @param tick_rate_hz Rate tick() will be called at
+     */
+    void start(double tick_rate_hz);
+    void stop();
+
+    /**
+     * @brief Advance every profile by one tick and apply the loads (physics thread)
+     */
+    void tick();
+
+    // Samples not streamed in time, summed over all profiles
+    uint64_t getUnderruns() const;
+
+private:
+    void advanceSample(size_t block, size_t lane, size_t index);
+    void streamLoop();
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class LogLevel : uint8_t { Debug, Info, Warning, Error };
+
+/**
+ * @brief Rate limiter of one logging call site (see the LOG_* macros)
+ *
+ * A site emits at most BURST messages per WINDOW_NS. Further messages are counted
+ * without being formatted, and the count is reported with the next emitted message.
+ */
+class LogSite {
+public:
+    static constexpr uint32_t BURST = 5;
+    static constexpr uint64_t WINDOW_NS = 1000000000ULL;
+
+    /**
+     * @param suppressed Messages dropped since the last admitted one (set when admitted)
+     * @return true if the message should be emitted
+     */
+    bool admit(uint32_t& suppressed);
+
+private:
+    std::atomic<uint64_t> window_{0};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+/**
+ * @brief Asynchronous logger for threads that must never block on output
+ *
+ * Each logging thread formats its messages into its own lock-free single-producer ring;
+ * a writer thread merges the rings in time order and writes Debug/Info to stdout and
+ * Warning/Error to stderr. Logging never takes a lock after the first message of a
+ * thread, and a full ring drops the message instead of waiting. Consecutive identical
+ * lines are collapsed into a repeat count.
+ *
+ * Use the LOG_* macros, which add per-call-site rate limiting.
+ */
+class Logger {
+public:
+    // Record size, including the formatted text; longer messages are truncated
+    static constexpr size_t RECORD_BYTES = 256;
+    // Records each thread can have waiting for the writer
+    static constexpr size_t RING_RECORDS = 256;
+    // How often the writer polls the rings when idle
+    static constexpr int WRITER_IDLE_MS = 10;
+
+    static Logger& instance();
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    static void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    static bool isEnabled(LogLevel level) { return level >= level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parse "debug", "info", "warning" or "error"
+     * @return false if the name is unknown
+     */
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+    /**
+     * @brief Format a message into the calling thread's ring (printf format)
+     * @param suppressed Messages of the same call site dropped by rate limiting before this one
+     */
+    void log(LogLevel level, uint32_t suppressed, const char* format, ...) __attribute__((format(printf, 4, 5)));
+
+    /**
+     * @brief Create the calling thread's ring now rather than on its first message
+     */
+    void prepareThread() { threadRing(); }
+
+    /**
+     * @brief Wait until everything logged so far is written
+     */
+    void flush();
+
+    // Messages lost to full rings
+    uint64_t getDropped() const;
+
+private:
+    struct Record {
+        uint64_t timeNs;
+        uint32_t suppressed;
+        LogLevel level;
+        uint16_t length;
+        char text[RECORD_BYTES - 16];
+    };
+    static_assert(sizeof(Record) == RECORD_BYTES, "Log records are fixed-size ring slots");
+
+    struct Ring {
+        std::unique_ptr<Record[]> records{new Record[RING_RECORDS]};
+        alignas(64) std::atomic<uint64_t> head{0};  // Next record the thread writes
+        alignas(64) std::atomic<uint64_t> tail{0};  // Next record the writer reads
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> retired{false};           // Thread exited, free once drained
+    };
+
+    // Releases the thread's ring to the writer when the thread exits
+    struct ThreadRing {
+        std::shared_ptr<Ring> ring;
+        ~ThreadRing();
+    };
+
+    Logger();
+
+    Ring* threadRing();
+    void writerLoop();
+    void drain(bool flushing);
+    void write(const Record& record);
+    void flushRepeats();
+
+    static std::atomic<LogLevel> level_;
+
+    mutable std::mutex rings_mutex_;              // Guards rings_ (registration and writer)
+    std::vector<std::shared_ptr<Ring>> rings_;
+    uint64_t retired_dropped_;                    // Drops of rings already freed
+
+    // Writer thread
+    std::vector<Record> batch_;
+    std::string last_line_;
+    LogLevel last_level_;
+    uint64_t repeats_;
+    uint64_t reported_dropped_;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    uint64_t flush_requested_;
+    uint64_t flush_completed_;
+    bool running_;
+    std::thread writer_thread_;
+};
+
+// Log with printf formatting, rate limited per call site; arguments are not evaluated
+// when the level is disabled or the site is over its rate
+#define SIM_LOG(level, ...)                                                      \
+    do {                                                                         \
+        if (Logger::isEnabled(level)) {                                          \
+            static LogSite sim_log_site_;                                        \
+            uint32_t sim_log_suppressed_;                                        \
+            if (sim_log_site_.admit(sim_log_suppressed_)) {                      \
+                Logger::instance().log(level, sim_log_suppressed_, __VA_ARGS__); \
+            }                                                                    \
+        }                                                                        \
+    } while (0)
+
+#define LOG_DEBUG(...) SIM_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) SIM_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) SIM_LOG(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) SIM_LOG(LogLevel::Error, __VA_ARGS__)
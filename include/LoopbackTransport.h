@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CanTransport.h"
+#include "CanEndpoint.h"
+#include <mutex>
+
+class LoopbackBus;
+
+/**
+ * @brief In-process, zero-copy CAN transport
+ *
+ * All LoopbackTransport instances opened on the same "loop:<name>" interface
+ * share one LoopbackBus. sendFrame() invokes the receive callback of every other
+ * open endpoint whose filters accept the frame, directly on the sending thread
+ * and by const reference, so a frame never leaves the CPU cache and no syscall
+ * is made. Like SocketCAN without CAN_RAW_RECV_OWN_MSGS, senders do not receive
+ * their own frames.
+ *
+ * Example usage (embedded controller talking to boards on "loop:bus0"):
+ *   LoopbackTransport controller("loop:bus0");
+ *   controller.open();
+ *   controller.startReceiving([](const can_frame& frame) { ... });
+ *   controller.sendFrame(effort_command);
+ */
+class LoopbackTransport : public CanTransport {
+private:
+    std::string interface_name_;
+    std::shared_ptr<LoopbackBus> bus_;             // Keeps the bus alive while open, under transport_mutex_
+    std::atomic<LoopbackBus*> open_bus_;           // bus_ for sendFrame(), nullptr while closed
+    std::shared_ptr<CanEndpoint> endpoint_;
+    std::mutex transport_mutex_;
+
+public:
+    /**
+     * @brief Constructor
+     * @param interface_name Loopback interface name (e.g., "loop:bus0")
+     */
+    explicit LoopbackTransport(const std::string& interface_name = "loop:default");
+
+    /**
+     * @brief Destructor - detaches from the bus
+     */
+    ~LoopbackTransport() override;
+
+    LoopbackTransport(const LoopbackTransport&) = delete;
+    LoopbackTransport& operator=(const LoopbackTransport&) = delete;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    bool sendFrame(const struct can_frame& frame) override;
+    bool startReceiving(ReceiveCallback callback) override;
+    void stopReceiving() override;
+    bool isReceiving() const override;
+    bool setFilters(const struct can_filter* filters, size_t filter_count) override;
+    const std::string& getInterfaceName() const override;
+
+    /**
+     * @brief Check if an interface name selects the loopback backend
+     */
+    static bool isLoopbackInterface(const std::string& interface_name);
+};
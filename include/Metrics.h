@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Process-wide registry of counters, gauges and latency histograms
+ *
+ * Counters and histograms live in per-thread shards: each thread adds to its own
+ * slots with plain loads and stores (no locked instructions, no shared cache lines),
+ * and render() sums the shards. Shards of exited threads are folded into a retained
+ * total, so counts never go backwards. Handles are obtained once, at setup, by name
+ * and labels; recording through a handle never takes a lock.
+ *
+ * render() produces the Prometheus text exposition format; see MetricsExporter.
+ */
+class Metrics {
+public:
+    // Histogram buckets: 1 us doubling up to HISTOGRAM_BUCKETS - 1, then +Inf
+    static constexpr uint32_t HISTOGRAM_BUCKETS = 17;
+    static constexpr uint64_t HISTOGRAM_FIRST_BOUND_NS = 1000;
+
+    // Counter slots are allocated in chunks, so shards grow without moving; room for
+    // the four counters of each of 200k boards
+    static constexpr uint32_t CHUNK_SLOTS = 1024;
+    static constexpr uint32_t MAX_CHUNKS = 1024;
+
+    static Metrics& instance();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Slot of a counter (the same name and labels give the same slot)
+     * @param labels Prometheus label list without braces, e.g. `board="0x10",interface="vcan0"`
+     */
+    uint32_t counterSlot(const std::string& name, const std::string& help, const std::string& labels);
+
+    /**
+     * @brief First of the HISTOGRAM_BUCKETS + 2 slots (buckets, sum, count) of a histogram
+     */
+    uint32_t histogramSlot(const std::string& name, const std::string& help, const std::string& labels);
+
+    std::atomic<double>* gaugeValue(const std::string& name, const std::string& help, const std::string& labels);
+
+    /**
+     * @brief Current value of a counter, summed over every thread (0 if unknown)
+     */
+    uint64_t counterValue(const std::string& name, const std::string& labels = "") const;
+
+    /**
+     * @brief Prometheus text exposition of every metric
+     */
+    std::string render() const;
+
+    /**
+     * @brief Allocate the calling thread's shard now, with room for every slot registered
+     *        so far and one more chunk, so that add() does not allocate on real-time threads
+     */
+    static void prepareThread();
+
+    // Add to a slot of the calling thread's shard
+    static void add(uint32_t slot, uint64_t value) {
+        std::atomic<uint64_t>* chunk = thread_shard_ ? thread_shard_->chunks[slot / CHUNK_SLOTS].load(std::memory_order_relaxed)
+                                                     : nullptr;
+        if (!chunk) {
+            chunk = instance().allocateChunk(slot / CHUNK_SLOTS);
+        }
+        std::atomic<uint64_t>& counter = chunk[slot % CHUNK_SLOTS];
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Steady clock in nanoseconds, for latencies recorded across threads
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint32_t bucketIndex(uint64_t nanoseconds) {
+        if (nanoseconds <= HISTOGRAM_FIRST_BOUND_NS) {
+            return 0;
+        }
+        uint32_t bucket = 64 - static_cast<uint32_t>(__builtin_clzll((nanoseconds - 1) / HISTOGRAM_FIRST_BOUND_NS));
+        return bucket < HISTOGRAM_BUCKETS - 1 ? bucket : HISTOGRAM_BUCKETS - 1;
+    }
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        uint32_t slot;                    // Counters and histograms
+        std::atomic<double>* gauge;       // Gauges
+    };
+
+    struct Family {
+        std::string help;
+        Type type;
+        std::map<std::string, Series> series;   // Keyed by labels, so large fleets register in log time
+    };
+
+    // One thread's slots; written only by the owning thread
+    struct Shard {
+        std::atomic<std::atomic<uint64_t>*> chunks[MAX_CHUNKS] = {};
+        std::atomic<bool> retired{false};
+        ~Shard();
+    };
+
+    // Hands the thread's shard back to the registry when the thread exits
+    struct ThreadShard {
+        std::shared_ptr<Shard> shard;
+        ~ThreadShard();
+    };
+
+    Metrics() = default;
+
+    uint32_t allocateSlots(const std::string& name, const std::string& help, const std::string& labels,
+                           Type type, uint32_t count);
+    std::atomic<uint64_t>* allocateChunk(uint32_t chunk);
+
+    // Sum of a slot over live shards and exited threads (mutex_ held)
+    uint64_t total(uint32_t slot) const;
+    void foldRetiredShards() const;
+
+    static thread_local Shard* thread_shard_;
+    static thread_local ThreadShard thread_shard_owner_;
+
+    mutable std::mutex mutex_;                          // Guards everything below
+    std::map<std::string, Family> families_;
+    uint32_t next_slot_ = 0;
+    bool slots_exhausted_ = false;
+    std::deque<std::atomic<double>> gauges_;
+    mutable std::vector<std::shared_ptr<Shard>> shards_;
+    mutable std::vector<uint64_t> retired_totals_;      // Slots of exited threads
+};
+
+/**
+ * @brief Monotonic counter handle (default-constructed handles record nothing)
+ */
+class MetricCounter {
+private:
+    uint32_t slot_ = UINT32_MAX;
+
+public:
+    MetricCounter() = default;
+    MetricCounter(const std::string& name, const std::string& help, const std::string& labels = "")
+        : slot_(Metrics::instance().counterSlot(name, help, labels)) {}
+
+    void add(uint64_t value = 1) const {
+        if (slot_ != UINT32_MAX) {
+            Metrics::add(slot_, value);
+        }
+    }
+};
+
+/**
+ * @brief Latency histogram handle, exported in seconds
+ */
+class MetricHistogram {
+private:
+    uint32_t slot_ = UINT32_MAX;
+
+public:
+    MetricHistogram() = default;
+    MetricHistogram(const std::string& name, const std::string& help, const std::string& labels = "")
+        : slot_(Metrics::instance().histogramSlot(name, help, labels)) {}
+
+    void observe(uint64_t nanoseconds) const {
+        if (slot_ != UINT32_MAX) {
+            Metrics::add(slot_ + Metrics::bucketIndex(nanoseconds), 1);
+            Metrics::add(slot_ + Metrics::HISTOGRAM_BUCKETS, nanoseconds);
+            Metrics::add(slot_ + Metrics::HISTOGRAM_BUCKETS + 1, 1);
+        }
+    }
+};
+
+/**
+ * @brief Gauge handle: the last value set wins
+ */
+class MetricGauge {
+private:
+    std::atomic<double>* value_ = nullptr;
+
+public:
+    MetricGauge() = default;
+    MetricGauge(const std::string& name, const std::string& help, const std::string& labels = "")
+        : value_(Metrics::instance().gaugeValue(name, help, labels)) {}
+
+    void set(double value) const {
+        if (value_) {
+            value_->store(value, std::memory_order_relaxed);
+        }
+    }
+};
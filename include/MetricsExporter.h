@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Serves Metrics in Prometheus text format and dumps it to a file
+ *
+ * Every configured endpoint answers any HTTP request with the current metrics:
+ * - a UNIX stream socket (`curl --unix-socket <path> http://localhost/metrics`)
+ * - a TCP port bound to 127.0.0.1 only (`curl http://127.0.0.1:<port>/metrics`)
+ * The dump file is rewritten every dumpIntervalMs through a rename, so readers
+ * never see a partial file. Everything runs on one background thread.
+ */
+class MetricsExporter {
+public:
+    struct Config {
+        std::string unixSocketPath;        // Empty = no UNIX socket
+        uint16_t httpPort = 0;             // 0 = no TCP endpoint
+        std::string dumpPath;              // Empty = no file dump
+        int dumpIntervalMs = 1000;
+    };
+
+    explicit MetricsExporter(const Config& config);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Open the endpoints and start serving
+     * @return false if an endpoint cannot be opened
+     */
+    bool start();
+
+    /**
+     * @brief Stop serving, remove the UNIX socket and write a final dump
+     */
+    void stop();
+
+private:
+    // How long a client has to send its request
+    static constexpr int REQUEST_TIMEOUT_MS = 100;
+
+    void serveLoop();
+    void respond(int client_fd);
+    void dump();
+
+    Config config_;
+    int unix_fd_;
+    int http_fd_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
@@ -101,6 +101,13 @@ private:
     // Cached values for performance optimization
     double inv_time_constant_;       // 1.0 / motor_time_constant_ (cached)
     double inv_max_control_signal_;  // 1.0 / max_control_signal_ (cached)
+    double exact_dt_;                // Step size exact_decay_ was computed for
+    double exact_decay_;             // exp(-exact_dt_ / motor_time_constant_) (cached)
+
+    // External load (e.g. from a recorded load profile)
+    double load_torque_;             // Load torque at the output shaft (Nm)
+    double inv_load_damping_;        // Velocity droop per Nm of load for this first-order model
+    double load_velocity_;           // load_torque_ * inv_load_damping_ (cached)
 
 public:
     Motor(double max_angular_velocity_rpm = 60.0, int max_control_signal = 1000, double motor_time_constant = 0.15);
@@ -110,8 +117,53 @@ public:
         return Builder();
     }
 
-    // Update motor physics simulation
-    void update(double dt);
+    // Update motor physics simulation (inline so servo kernels can fuse it into their loop)
+    void update(double dt) {
+        // Calculate target steady-state velocity based on control signal
+        // At max control signal (1000), we should reach max angular velocity
+        // minus the droop caused by any external load
+        double target_velocity = static_cast<double>(control_signal_) * inv_max_control_signal_ * max_angular_velocity_
+                                 - load_velocity_;
+
+        // Simple velocity control - move towards target velocity with realistic time constant
+        double velocity_error = target_velocity - angular_velocity_;
+
+        // Use the configurable motor time constant (cached inverse)
+        double velocity_change = velocity_error * inv_time_constant_ * dt;
+
+        // Update angular velocity
+        angular_velocity_ += velocity_change;
+
+        // Apply maximum angular velocity limit (safety)
+        angular_velocity_ = std::clamp(angular_velocity_, -max_angular_velocity_, max_angular_velocity_);
+
+        // Update position
+        angular_position_ += angular_velocity_ * dt;
+    }
+
+    /**
+     * @brief Advance by the exact solution of the velocity lag (any step size)
+     *
+     * Used for coarse integration steps, where explicit Euler would lose accuracy.
+     * @param dt Time step in seconds
+     * @return Angular displacement over the step in radians
+     */
+    double advanceExact(double dt) {
+        if (dt != exact_dt_) {
+            exact_dt_ = dt;
+            exact_decay_ = std::exp(-dt * inv_time_constant_);
+        }
+
+        double target_velocity = static_cast<double>(control_signal_) * inv_max_control_signal_ * max_angular_velocity_
+                                 - load_velocity_;
+        double velocity_excess = angular_velocity_ - target_velocity;
+        double displacement = target_velocity * dt + velocity_excess * (1.0 - exact_decay_) * motor_time_constant_;
+
+        angular_velocity_ = std::clamp(target_velocity + velocity_excess * exact_decay_,
+                                       -max_angular_velocity_, max_angular_velocity_);
+        angular_position_ += displacement;
+        return displacement;
+    }
 
     // Set control signal
     void setControlSignal(int control_signal);
@@ -129,6 +181,30 @@ public:
     // Set motor limits
     void setMaxControlSignal(int max_control_signal);
     void setMaxAngularVelocity(double max_velocity_rpm);
+    void setMotorTimeConstant(double time_constant);
+
+    /**
+     * @brief Apply an external load torque at the output shaft
+     *
+     * The electromechanical model and kinematic chains apply it as a torque. The
+     * first-order model has no torque balance, so the load lowers its target velocity
+     * by torque / loadDamping instead.
+     * @param torque Load torque in Nm (positive opposes positive rotation)
+     */
+    void setLoad(double torque) {
+        load_torque_ = torque;
+        load_velocity_ = torque * inv_load_damping_;
+    }
+    double getLoad() const { return load_torque_; }
+
+    // Velocity-loop stiffness of the first-order model against load torque (Nm per rad/s)
+    void setLoadDamping(double damping_nms);
+
+    // Overwrite integrated state (used by FixedPointModel)
+    void setState(double angular_velocity, double angular_position) {
+        angular_velocity_ = angular_velocity;
+        angular_position_ = angular_position;
+    }
 
     // Reset motor state
     void reset();
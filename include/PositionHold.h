@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Position-hold PID controller emulating board firmware
+ *
+ * Engaged by an effort 0 ("stop with hold") command, it drives the motor's control
+ * signal to keep the encoder at the position latched when the hold engaged. The
+ * error is taken around the encoder's wraparound point and follows its counting
+ * direction, so the loop holds the same target whichever way the encoder counts.
+ *
+ * Gains are in effort units per radian of position error; the output is rounded
+ * and clamped to the motor's control signal range, with integrator anti-windup.
+ *
+ * Example usage:
+ *   PositionHold hold;
+ *   hold.configure(config, encoder.getMaxSteps(), encoder.isDirectionInverted(),
+ *                  motor.getMaxControlSignal(), 0.001);
+ *   hold.engage(encoder.getPositionSteps());
+ *   motor.setControlSignal(hold.update(encoder.getPositionSteps()));  // every loop period
+ */
+class PositionHold {
+public:
+    struct Config {
+        double rateHz = 1000.0;  ///< Loop rate, run from the physics tick (0 = hold disabled)
+        double kp = 200.0;       ///< Effort per radian
+        double ki = 50.0;        ///< Effort per radian-second
+        double kd = 10.0;        ///< Effort per radian/second
+    };
+
+private:
+    Config config_;
+    long max_steps_;
+    double direction_;           // +1 normal, -1 inverted encoder
+    double radians_per_step_;
+    int max_effort_;
+    double period_;              // Loop period in seconds
+
+    long target_steps_;
+    double integral_;
+    double previous_error_;
+    bool primed_;
+
+public:
+    PositionHold();
+
+    /**
+     * @brief Configure gains and plant limits (not real-time safe)
+     * @param config Rate and gains
+     * @param max_steps Encoder steps per revolution
+     * @param direction_inverted Encoder counts against positive effort
+     * @param max_effort Control signal limit of the motor
+     * @param period Seconds between update() calls
+     */
+    void configure(const Config& config, long max_steps, bool direction_inverted, int max_effort, double period);
+
+    /**
+     * @brief Latch the hold target and reset the controller state
+     * @param target_steps Encoder position to hold
+     */
+    void engage(long target_steps);
+
+    /**
+     * @brief Run one loop iteration
+     * @param encoder_steps Current encoder position
+     * @return Control signal to apply
+     */
+    int update(long encoder_steps);
+
+    const Config& getConfig() const { return config_; }
+    long getTargetSteps() const { return target_steps_; }
+};
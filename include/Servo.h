@@ -2,6 +2,12 @@
 
 #include "Motor.h"
 #include "Encoder.h"
+#include "TransmitPolicy.h"
+#include "BoardTimerRates.h"
+#include "VelocityEstimator.h"
+#include "PositionHold.h"
+#include "FixedPointModel.h"
+#include "ElectromechanicalModel.h"
 #include <memory>
 #include <string>
 
@@ -18,9 +24,15 @@ class CanBoard;
  */
 class Servo {
 private:
-    std::shared_ptr<Motor> motor_;
-    std::shared_ptr<Encoder> encoder_;
+    // Motor and encoder are stepped together every tick, so they share one allocation
+    struct Physics {
+        Motor motor;
+        Encoder encoder;
+    };
+    std::unique_ptr<Physics> physics_;
     std::unique_ptr<CanBoard> can_board_;
+    std::unique_ptr<FixedPointModel> fixed_point_;  // nullptr = double-precision physics
+    std::unique_ptr<ElectromechanicalModel> electromechanical_;  // nullptr = first-order velocity lag
 
 public:
     /**
@@ -35,6 +47,7 @@ public:
         double max_velocity_rpm_ = 160.0;
         int max_control_signal_ = 1000;
         double motor_time_constant_ = 0.3;
+        double load_damping_nms_ = 1.0;
 
         // Encoder parameters
         int bit_resolution_ = 18;
@@ -44,6 +57,16 @@ public:
         bool enable_can_ = false;
         uint32_t can_id_ = 0x10;
         std::string can_interface_ = "vcan0";
+        uint32_t can_bitrate_ = 0;
+        BoardTimerRates timer_rates_;
+        TransmitPolicy transmit_policy_;
+        VelocityEstimator::Config velocity_estimator_;
+        PositionHold::Config position_hold_;
+
+        // Physics parameters
+        bool fixed_point_ = false;
+        bool electromechanical_ = false;
+        ElectromechanicalModel::Parameters electromechanical_parameters_;
 
     public:
         /**
@@ -70,6 +93,14 @@ public:
             return *this;
         }
 
+        /**
+         * @brief Set how far external load torque slows the first-order motor (Nm per rad/s)
+         */
+        Builder& loadDamping(double damping_nms) {
+            load_damping_nms_ = damping_nms;
+            return *this;
+        }
+
         /**
          * @brief Set encoder bit resolution
          */
@@ -113,12 +144,74 @@ public:
             return *this;
         }
 
+        /**
+         * @brief Set modeled CAN bus bitrate in bits per second (0 = ideal bus)
+         */
+        Builder& canBitrate(uint32_t bitrate) {
+            can_bitrate_ = bitrate;
+            return *this;
+        }
+
+        /**
+         * @brief Use the electromechanical motor model (armature, back-EMF, friction, inertia)
+         */
+        Builder& electromechanical(const ElectromechanicalModel::Parameters& parameters) {
+            electromechanical_ = true;
+            electromechanical_parameters_ = parameters;
+            return *this;
+        }
+
+        /**
+         * @brief Set board timer frequencies (encoder read, control update, status transmit)
+         */
+        Builder& timerRates(const BoardTimerRates& rates) {
+            timer_rates_ = rates;
+            return *this;
+        }
+
+        /**
+         * @brief Set status frame transmission policy (fixed rate or change-driven)
+         */
+        Builder& transmitPolicy(const TransmitPolicy& policy) {
+            transmit_policy_ = policy;
+            return *this;
+        }
+
+        /**
+         * @brief Set how the board derives the reported speed (model or encoder-based estimate)
+         */
+        Builder& velocityEstimator(const VelocityEstimator::Config& config) {
+            velocity_estimator_ = config;
+            return *this;
+        }
+
+        /**
+         * @brief Set the effort 0 position-hold loop rate and gains (rateHz 0 = no hold)
+         */
+        Builder& positionHold(const PositionHold::Config& config) {
+            position_hold_ = config;
+            return *this;
+        }
+
+        /**
+         * @brief Use deterministic Q32.32 fixed-point physics instead of double precision
+         */
+        Builder& fixedPoint(bool enabled) {
+            fixed_point_ = enabled;
+            return *this;
+        }
+
         /**
          * @brief Build the Servo
          */
         Servo build() {
-            return Servo(max_velocity_rpm_, max_control_signal_, motor_time_constant_,
-                         bit_resolution_, direction_inverted_, enable_can_, can_id_, can_interface_);
+            Servo servo(max_velocity_rpm_, max_control_signal_, motor_time_constant_,
+                        bit_resolution_, direction_inverted_, enable_can_, can_id_, can_interface_,
+                        can_bitrate_, transmit_policy_, velocity_estimator_,
+                        position_hold_, fixed_point_, timer_rates_, electromechanical_,
+                        electromechanical_parameters_);
+            servo.getMotor().setLoadDamping(load_damping_nms_);
+            return servo;
         }
 
         /**
@@ -132,7 +225,13 @@ public:
 private:
     Servo(double max_velocity_rpm, int max_control_signal, double motor_time_constant,
           int bit_resolution, bool direction_inverted, bool enable_can, uint32_t can_id,
-          const std::string& can_interface);
+          const std::string& can_interface, uint32_t can_bitrate = 0,
+          const TransmitPolicy& transmit_policy = TransmitPolicy(),
+          const VelocityEstimator::Config& velocity_estimator = VelocityEstimator::Config(),
+          const PositionHold::Config& position_hold = PositionHold::Config(),
+          bool fixed_point = false, const BoardTimerRates& timer_rates = BoardTimerRates(),
+          bool electromechanical = false,
+          const ElectromechanicalModel::Parameters& electromechanical_parameters = ElectromechanicalModel::Parameters());
 
 public:
     /**
@@ -165,15 +264,24 @@ public:
      * @param dt Time step in seconds
      */
     void update(double dt) {
-        motor_->update(dt);
-        encoder_->update(motor_->getAngularVelocity(), dt);
+        if (electromechanical_) {
+            electromechanical_->update(physics_->motor, dt);
+            physics_->encoder.update(physics_->motor.getAngularVelocity(), dt);
+            return;
+        }
+        if (fixed_point_) {
+            fixed_point_->update(physics_->motor, physics_->encoder, dt);
+            return;
+        }
+        physics_->motor.update(dt);
+        physics_->encoder.update(physics_->motor.getAngularVelocity(), dt);
     }
 
     /**
      * @brief Set motor control signal
      */
     void setControlSignal(int signal) {
-        motor_->setControlSignal(signal);
+        physics_->motor.setControlSignal(signal);
     }
 
     /**
@@ -195,29 +303,17 @@ public:
 
     bool isCANRunning() const;
 
-    /**
-     * @brief Get shared pointer to motor for direct access
-     */
-    std::shared_ptr<Motor> getMotorPtr() { return motor_; }
-    std::shared_ptr<const Motor> getMotorPtr() const { return motor_; }
-
-    /**
-     * @brief Get shared pointer to encoder for direct access
-     */
-    std::shared_ptr<Encoder> getEncoderPtr() { return encoder_; }
-    std::shared_ptr<const Encoder> getEncoderPtr() const { return encoder_; }
-
     /**
      * @brief Get motor reference for direct access
      */
-    Motor& getMotor() { return *motor_; }
-    const Motor& getMotor() const { return *motor_; }
+    Motor& getMotor() { return physics_->motor; }
+    const Motor& getMotor() const { return physics_->motor; }
 
     /**
      * @brief Get encoder reference for direct access
      */
-    Encoder& getEncoder() { return *encoder_; }
-    const Encoder& getEncoder() const { return *encoder_; }
+    Encoder& getEncoder() { return physics_->encoder; }
+    const Encoder& getEncoder() const { return physics_->encoder; }
 
     /**
      * @brief Get CanBoard reference if enabled
@@ -229,24 +325,55 @@ public:
      * @brief Reset both motor and encoder to initial state
      */
     void reset() {
-        motor_->reset();
-        encoder_->reset();
+        physics_->motor.reset();
+        physics_->encoder.reset();
+        if (fixed_point_) {
+            fixed_point_->reset();
+        }
+        if (electromechanical_) {
+            electromechanical_->reset();
+        }
+    }
+
+    /**
+     * @brief Check if the servo integrates in fixed point
+     */
+    bool isFixedPoint() const {
+        return fixed_point_ != nullptr;
+    }
+
+    /**
+     * @brief Get the fixed-point model, nullptr in double-precision mode
+     */
+    FixedPointModel* getFixedPointModel() { return fixed_point_.get(); }
+
+    /**
+     * @brief Check if the servo uses the electromechanical motor model
+     */
+    bool isElectromechanical() const {
+        return electromechanical_ != nullptr;
     }
 
+    /**
+     * @brief Get the electromechanical model, nullptr with the first-order model
+     */
+    ElectromechanicalModel* getElectromechanicalModel() { return electromechanical_.get(); }
+    const ElectromechanicalModel* getElectromechanicalModel() const { return electromechanical_.get(); }
+
     /**
      * @brief Stop the motor (set control signal to 0)
      */
     void stop() {
-        motor_->setControlSignal(0);
+        physics_->motor.setControlSignal(0);
         stopCAN();
     }
 
     // Convenience methods that delegate to motor
-    int getControlSignal() const { return motor_->getControlSignal(); }
-    double getAngularVelocity() const { return motor_->getAngularVelocity(); }
-    double getAngularPosition() const { return motor_->getAngularPosition(); }
+    int getControlSignal() const { return physics_->motor.getControlSignal(); }
+    double getAngularVelocity() const { return physics_->motor.getAngularVelocity(); }
+    double getAngularPosition() const { return physics_->motor.getAngularPosition(); }
 
     // Convenience methods that delegate to encoder
-    long getEncoderPosition() const { return encoder_->getPositionSteps(); }
-    double getEncoderPositionRadians() const { return encoder_->getPositionRadians(); }
+    long getEncoderPosition() const { return physics_->encoder.getPositionSteps(); }
+    double getEncoderPositionRadians() const { return physics_->encoder.getPositionRadians(); }
 };
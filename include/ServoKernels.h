@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Servo.h"
+#include <cstddef>
+
+/**
+ * @brief Physics kernels specialized per servo variant
+ *
+ * Servo::update() decides per call between the double and fixed-point models and
+ * between encoder counting directions. The engine instead groups servos by variant
+ * once and steps each group through a kernel instantiated for it, so the per-servo
+ * inner loop has no variant branches and Motor::update() inlines into it. Encoder
+ * wraparound uses the power-of-two step mask in every variant.
+ *
+ * Coarse-step groups (multi-rate integration) use the exact solution of the motor's
+ * velocity lag, so their accuracy does not degrade with the step size.
+ */
+using ServoKernel = void (*)(Servo* const* servos, size_t count, double dt);
+
+template <bool DirectionInverted>
+void stepDoubleServos(Servo* const* servos, size_t count, double dt) {
+    for (size_t i = 0; i < count; ++i) {
+        Motor& motor = servos[i]->getMotor();
+        motor.update(dt);
+        servos[i]->getEncoder().step<DirectionInverted>(motor.getAngularVelocity(), dt);
+    }
+}
+
+template <bool DirectionInverted>
+void stepDoubleServosExact(Servo* const* servos, size_t count, double dt) {
+    for (size_t i = 0; i < count; ++i) {
+        double displacement = servos[i]->getMotor().advanceExact(dt);
+        servos[i]->getEncoder().step<DirectionInverted>(displacement / dt, dt);
+    }
+}
+
+template <bool DirectionInverted>
+void stepFixedPointServos(Servo* const* servos, size_t count, double dt) {
+    for (size_t i = 0; i < count; ++i) {
+        servos[i]->getFixedPointModel()->step<DirectionInverted>(servos[i]->getMotor(), servos[i]->getEncoder(), dt);
+    }
+}
+
+template <bool DirectionInverted>
+void stepElectromechanicalServos(Servo* const* servos, size_t count, double dt) {
+    for (size_t i = 0; i < count; ++i) {
+        Motor& motor = servos[i]->getMotor();
+        servos[i]->getElectromechanicalModel()->update(motor, dt);
+        servos[i]->getEncoder().step<DirectionInverted>(motor.getAngularVelocity(), dt);
+    }
+}
+
+/**
+ * @brief Pick the kernel instantiation matching a servo's variant
+ * @param servo Servo to step
+ * @param coarse true if the servo is stepped less often than every tick
+ */
+inline ServoKernel selectServoKernel(const Servo& servo, bool coarse = false) {
+    bool inverted = servo.getEncoder().isDirectionInverted();
+    if (servo.isElectromechanical()) {
+        return inverted ? &stepElectromechanicalServos<true> : &stepElectromechanicalServos<false>;
+    }
+    if (servo.isFixedPoint()) {
+        return inverted ? &stepFixedPointServos<true> : &stepFixedPointServos<false>;
+    }
+    if (coarse) {
+        return inverted ? &stepDoubleServosExact<true> : &stepDoubleServosExact<false>;
+    }
+    return inverted ? &stepDoubleServos<true> : &stepDoubleServos<false>;
+}
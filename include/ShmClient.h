@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ShmFrameRing.h"
+#include <string>
+
+/**
+ * @brief Controller-side client for the simulator's shared-memory transport
+ *
+ * Maps the segment created by a simulator running boards on "shm:<name>" and
+ * exchanges frames through its rings. Sending and receiving are plain memory
+ * operations; a syscall only happens to wake a peer that is parked on its futex.
+ * Built as the standalone can_shm_client library.
+ *
+ * Example usage:
+ *   ShmClient client("bus0");
+ *   if (client.connect()) {
+ *       client.send(effort_command);
+ *       can_frame status;
+ *       while (client.receive(status, 10)) { ... }
+ *   }
+ */
+class ShmClient {
+private:
+    std::string name_;
+    bool busy_poll_;
+    ShmSegment* segment_;
+
+public:
+    /**
+     * @brief Constructor
+     * @param name Segment name used by the simulator (the part after "shm:")
+     * @param busy_poll true = receive() spins instead of sleeping on the futex
+     */
+    explicit ShmClient(const std::string& name, bool busy_poll = false);
+
+    /**
+     * @brief Destructor - unmaps the segment
+     */
+    ~ShmClient();
+
+    ShmClient(const ShmClient&) = delete;
+    ShmClient& operator=(const ShmClient&) = delete;
+
+    /**
+     * @brief Map the simulator's segment
+     * @return true if the segment exists and is initialized
+     */
+    bool connect();
+
+    /**
+     * @brief Unmap the segment
+     */
+    void disconnect();
+
+    /**
+     * @brief Check if connected
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Send a frame to the simulator
+     * @return false if not connected or the ring is full
+     */
+    bool send(const struct can_frame& frame);
+
+    /**
+     * @brief Receive a frame without waiting
+     * @return true if a frame was received
+     */
+    bool tryReceive(struct can_frame& frame);
+
+    /**
+     * @brief Receive a frame, waiting up to timeout_ms
+     * @return true if a frame was received
+     */
+    bool receive(struct can_frame& frame, int timeout_ms);
+};
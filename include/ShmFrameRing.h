@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <ctime>
+#include <string>
+#include <linux/can.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Shared-memory frame ring layout shared by the simulator and ShmClient
+ *
+ * A segment holds two bounded lock-free MPSC rings of can_frame, one per direction.
+ * Producers claim slots with a CAS on head and publish them through a per-slot
+ * sequence number; the single consumer never writes head. Consumers that run out of
+ * frames may park on a futex word in the segment, and producers only issue the
+ * FUTEX_WAKE syscall when a consumer has announced itself as sleeping, so a busy
+ * exchange never leaves user space.
+ *
+ * Everything in the segment is a lock-free, address-free std::atomic, so the same
+ * layout works across processes mapping it at different addresses.
+ */
+
+constexpr uint32_t SHM_SEGMENT_MAGIC = 0x4D53434E;  // "NCSM"
+constexpr uint32_t SHM_SEGMENT_VERSION = 1;
+constexpr uint64_t SHM_RING_CAPACITY = 1024;         // Frames per direction, power of two
+
+// Spin iterations a consumer polls before parking on the futex
+constexpr int SHM_SPIN_BEFORE_SLEEP = 2000;
+
+static_assert((SHM_RING_CAPACITY & (SHM_RING_CAPACITY - 1)) == 0, "Ring capacity must be a power of two");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared rings need lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Futex words need lock-free 32-bit atomics");
+
+struct ShmRingSlot {
+    std::atomic<uint64_t> sequence;
+    struct can_frame frame;
+};
+
+struct ShmFrameRing {
+    alignas(64) std::atomic<uint64_t> head;     // Next slot producers claim
+    alignas(64) std::atomic<uint64_t> tail;     // Next slot the consumer reads
+    alignas(64) std::atomic<uint32_t> wake_sequence;  // Futex word, bumped on every wake
+    std::atomic<uint32_t> consumer_sleeping;
+    alignas(64) ShmRingSlot slots[SHM_RING_CAPACITY];
+
+    /**
+     * @brief Initialize an empty ring (creator only, before publishing the segment)
+     */
+    void initialize() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        wake_sequence.store(0, std::memory_order_relaxed);
+        consumer_sleeping.store(0, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < SHM_RING_CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Enqueue a frame (any number of producer threads/processes)
+     * @return false if the ring is full
+     */
+    bool push(const struct can_frame& frame) {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        for (;;) {
+            ShmRingSlot& slot = slots[position & (SHM_RING_CAPACITY - 1)];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (difference == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::memcpy(&slot.frame, &frame, sizeof(frame));
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    wakeConsumer();
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Dequeue a frame (single consumer only)
+     * @return false if the ring is empty
+     */
+    bool pop(struct can_frame& frame) {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        ShmRingSlot& slot = slots[position & (SHM_RING_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        std::memcpy(&frame, &slot.frame, sizeof(frame));
+        slot.sequence.store(position + SHM_RING_CAPACITY, std::memory_order_release);
+        tail.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Check for a published frame without consuming it (single consumer only)
+     */
+    bool hasFrame() const {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        return slots[position & (SHM_RING_CAPACITY - 1)].sequence.load(std::memory_order_acquire) == position + 1;
+    }
+
+    /**
+     * @brief Wait until a frame is available (single consumer only)
+     * @param busy_poll true = spin without ever sleeping (zero syscalls), false = spin then park on the futex
+     * @param timeout_ms Upper bound on the wait in milliseconds
+     * @return true if a frame is available
+     */
+    bool waitForFrame(bool busy_poll, int timeout_ms) {
+        for (int i = 0; i < SHM_SPIN_BEFORE_SLEEP; ++i) {
+            if (hasFrame()) {
+                return true;
+            }
+            cpuRelax();
+        }
+        if (busy_poll) {
+            return false; // Never sleep; the caller re-checks its running flag and polls again
+        }
+
+        uint32_t observed = wake_sequence.load(std::memory_order_relaxed);
+        consumer_sleeping.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool available = hasFrame();
+        if (!available) {
+            struct timespec timeout;
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wake_sequence), FUTEX_WAIT, observed,
+                    &timeout, nullptr, 0);
+            available = hasFrame();
+        }
+        consumer_sleeping.store(0, std::memory_order_relaxed);
+        return available;
+    }
+
+private:
+    void wakeConsumer() {
+        // Pairs with the fence in waitForFrame(): either the consumer sees the new
+        // frame, or this producer sees it sleeping and wakes it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_sleeping.load(std::memory_order_relaxed)) {
+            wake_sequence.fetch_add(1, std::memory_order_relaxed);
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wake_sequence), FUTEX_WAKE, INT_MAX,
+                    nullptr, nullptr, 0);
+        }
+    }
+
+    static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+};
+
+struct ShmSegment {
+    std::atomic<uint32_t> magic;     // Written last by the creator, SHM_SEGMENT_MAGIC once usable
+    uint32_t version;
+    uint64_t ring_capacity;
+    ShmFrameRing to_client;          // Simulator -> controller (status frames)
+    ShmFrameRing to_simulator;       // Controller -> simulator (commands)
+};
+
+/**
+ * @brief Build the POSIX shm object name for a segment ("bus0" -> "/can_sim_bus_bus0")
+ *
+ * The prefix keeps CAN segments apart from state mirrors of the same name.
+ */
+inline std::string shmSegmentPath(const std::string& name) {
+    return "/can_sim_bus_" + name;
+}
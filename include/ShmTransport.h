@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CanTransport.h"
+#include "CanEndpoint.h"
+#include <mutex>
+
+class ShmChannel;
+
+/**
+ * @brief Shared-memory CAN transport for controllers running on the same host
+ *
+ * All ShmTransport instances opened on "shm:<name>" share one ShmChannel, which
+ * owns the POSIX shared-memory segment "/can_sim_bus_<name>" (see ShmFrameRing.h) and
+ * a single dispatch thread feeding controller frames to every board's callback.
+ * Boards publish status frames straight into the segment's to-client ring.
+ *
+ * "shm-poll:<name>" selects busy-poll mode: the dispatch thread spins instead of
+ * parking on the futex, so neither side ever makes a syscall. A segment serves one
+ * mode: opening "shm:<name>" and "shm-poll:<name>" in one process fails the second.
+ * Controllers connect with ShmClient.
+ *
+ * The segment outlives its transports closing, so a controller stays connected
+ * while boards restart; releaseSegments() unlinks it at engine shutdown.
+ */
+class ShmTransport : public CanTransport {
+private:
+    std::string interface_name_;
+    std::string segment_name_;
+    bool busy_poll_;
+    std::shared_ptr<ShmChannel> channel_;          // Keeps the channel alive while open, under transport_mutex_
+    std::atomic<ShmChannel*> open_channel_;        // channel_ for sendFrame(), nullptr while closed
+    std::shared_ptr<CanEndpoint> endpoint_;
+    std::mutex transport_mutex_;
+
+public:
+    /**
+     * @brief Constructor
+     * @param interface_name "shm:<name>" or "shm-poll:<name>"
+     */
+    explicit ShmTransport(const std::string& interface_name = "shm:default");
+
+    /**
+     * @brief Destructor - detaches from the channel
+     */
+    ~ShmTransport() override;
+
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    bool sendFrame(const struct can_frame& frame) override;
+    bool startReceiving(ReceiveCallback callback) override;
+    void stopReceiving() override;
+    bool isReceiving() const override;
+    bool setFilters(const struct can_filter* filters, size_t filter_count) override;
+    const std::string& getInterfaceName() const override;
+
+    /**
+     * @brief Check if an interface name selects the shared-memory backend
+     */
+    static bool isShmInterface(const std::string& interface_name);
+
+    /**
+     * @brief Unlink every segment once the transports still open on it close
+     *        (engine shutdown)
+     */
+    static void releaseSegments();
+};
@@ -1,6 +1,21 @@
 #pragma once
 
 #include "Servo.h"
+#include "CanBus.h"
+#include "StateMirror.h"
+#include "SyncGroup.h"
+#include "CanBoard.h"
+#include "ServoKernels.h"
+#include "FixedPointLanes.h"
+#include "KinematicChain.h"
+#include "LoadProfilePlayer.h"
+#include "TelemetryRecorder.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <atomic>
 #include <thread>
@@ -8,17 +23,114 @@
 
 class SimulationEngine {
 private:
-    std::vector<Servo> servos_;
+    std::vector<std::unique_ptr<Servo>> servos_;                // Heap-allocated, so addresses survive edits
+
+    // Servos grouped by physics variant and integration rate, each stepped by its
+    // specialized kernel every `decimation` ticks, and up to the current tick before
+    // one of its boards actuates or a SYNC latches it. Fixed-point groups keep their
+    // state in lanes and publish it to the servos every publishDivider ticks.
+    struct KernelGroup {
+        ServoKernel kernel;
+        uint32_t decimation;
+        uint64_t lastTick;                                      // Tick the group's state belongs to
+        IntegrationClock* clock;                                // publishedTick, as board timers read it
+        std::vector<Servo*> servos;
+        std::vector<uint32_t> indices;                          // Positions in servos_
+        std::vector<CanBoard*> boards;                          // Boards of servos
+        std::vector<uint32_t> boardServos;                      // Position in servos of each board's servo
+        std::unique_ptr<FixedPointLanes> lanes;                 // Fixed-point groups only
+        uint32_t publishDivider;
+        uint64_t publishedTick;                                 // Tick the servos' state belongs to
+    };
+    std::vector<KernelGroup> kernelGroups_;                     // Rebuilt when servos_ changes
+    std::vector<std::unique_ptr<IntegrationClock>> groupClocks_; // By group position, kept for board timers
+
+    // Chained servos are integrated by their chain every tick instead of a kernel group
+    struct ChainSpec {
+        KinematicChain::Config config;
+        std::vector<size_t> servoIndices;                       // Driving servo of each joint
+    };
+    struct ChainInstance {
+        std::unique_ptr<KinematicChain> chain;
+        std::vector<uint32_t> indices;
+        std::vector<CanBoard*> boards;
+        std::vector<Servo*> boardServos;                        // Servo of each board
+    };
+    std::vector<ChainSpec> chainSpecs_;
+    std::vector<ChainInstance> chains_;                         // Rebuilt with kernelGroups_
+    IntegrationClock chainClock_;                               // Shared by chained servos, stepped every tick
+    uint32_t chainThreads_;                                     // Threads stepping chains, incl. physics thread
+    std::vector<std::thread> chainWorkers_;
+    std::atomic<bool> chainWorkersRunning_;
+    alignas(64) std::atomic<uint64_t> chainRound_;              // Bumped by the physics thread each tick
+    alignas(64) std::atomic<uint32_t> chainPending_;            // Workers still stepping this round
+    LoadProfilePlayer loadProfiles_;                            // Recorded loads applied each tick
+    std::string telemetryPath_;                                 // Empty = telemetry capture disabled
+    std::vector<size_t> telemetryIndices_;                      // Empty = every servo
+    std::unique_ptr<TelemetryRecorder> telemetry_;
+    TelemetryRing* telemetryRing_;                              // Physics thread's capture ring
+
+    // runBetweenTicks() hands an edit to the physics thread, which runs it before its next tick
+    std::mutex editMutex_;                                      // Guards the three members below
+    std::condition_variable editDone_;
+    const std::function<void()>* pendingEdit_;
+    std::atomic<bool> editPending_;                             // pendingEdit_ set, polled once per tick
+    bool physicsRunning_;                                       // false = edits run on their caller
     std::atomic<bool> running_;
     std::thread simulationThread_;
-    static constexpr double simulationFrequencyHz_ = 20000.0;
+    std::map<std::string, std::shared_ptr<CanBus>> canBuses_;  // Bus timing models keyed by interface
+    std::map<std::string, uint32_t> canBitrates_;               // Bitrate of each bus-modeled interface
+    std::atomic<uint64_t> tick_;                                // Physics ticks completed since construction
+    MetricCounter tickOverruns_;                                // Ticks that ended past the next tick's start
+    MetricHistogram tickDuration_;                              // Time spent in update()
+    MetricGauge heapBytesPerServo_;                             // Set by measureHeapBytesPerServo()
+    std::vector<CpuAccounting::Account*> physicsCpu_;           // Per servo, charged by the thread stepping it
+    std::string stateMirrorName_;                               // Empty = state mirror disabled
+    std::unique_ptr<StateMirror> stateMirror_;
+    uint32_t syncId_;                                           // 0 = free-running board timers
+    std::vector<std::unique_ptr<SyncGroup>> syncGroups_;        // One per interface in SYNC mode
+    double simulationFrequencyHz_;
+    double dt_;                                                 // 1 / simulationFrequencyHz_, cached for update()
+    double integrationAccuracy_;                                // Max step / time constant, 0 = every tick
 
 public:
+    static constexpr double DEFAULT_SIMULATION_FREQUENCY_HZ = 20000.0;
+    static constexpr double DEFAULT_INTEGRATION_ACCURACY = 0.01;
+    static constexpr uint32_t MAX_INTEGRATION_DECIMATION = 64;
+
     SimulationEngine();
     ~SimulationEngine();
 
+    /**
+     * @brief Add a servo; while running it joins at a tick boundary and its board starts
+     * @throws std::invalid_argument if its board models the bus of an interface at
+     *         another bitrate than the boards added before
+     * @throws std::logic_error while running with the state mirror or SYNC mode
+     */
     void addServo(Servo&& servo);
 
+    /**
+     * @brief Stop a servo's board and remove the servo at a tick boundary
+     *
+     * Later servos move down one index. Other servos keep integrating and their
+     * boards keep their timer phase.
+     * @throws std::invalid_argument if the servo drives a chain, plays a load profile
+     *         or is captured by telemetry
+     * @throws std::logic_error while running with the state mirror or SYNC mode
+     */
+    void removeServo(size_t index);
+
+    /**
+     * @brief Run an edit of servo state or parameters between two physics ticks
+     *
+     * Blocks until the physics thread has run the edit, so every change it makes is
+     * seen from the same tick on; runs it directly while the engine is stopped. Servos
+     * are regrouped afterwards, so the edit may change anything the integration rate
+     * depends on. Must not be called from the physics thread.
+     * @param edit Changes to apply
+     */
+    void runBetweenTicks(const std::function<void()>& edit);
+
     size_t getServoCount() const;
 
     Servo& getServo(size_t index = 0);
@@ -32,9 +144,75 @@ public:
     std::atomic<bool>& getRunningRef();
     double getSimulationFrequency() const;
 
+    // Physics tick rate in Hz (call before start)
+    void setSimulationFrequency(double frequency_hz);
+
+    // Integrate slow servos at coarser steps of at most accuracy * timeConstant
+    // (call before start, 0 = integrate every servo every tick)
+    void setIntegrationAccuracy(double accuracy);
+    uint32_t getIntegrationDecimation(size_t index) const;
+
+    // Couple servos through a kinematic chain (call before start)
+    void addChain(const KinematicChain::Config& config, const std::vector<size_t>& servo_indices);
+    size_t getChainCount() const;
+
+    // Step chains on this many threads, the physics thread included (call before start)
+    void setChainThreads(uint32_t threads);
+
+    /**
+     * @brief Play a recorded load profile into a servo's motor (call before start)
+     * @param index Servo index
+     * @param path Profile file (see LoadProfile.h)
+     * @param channel Channel of the profile to play
+     * @param scale Factor applied to every sample
+     * @param loop Restart at the end instead of holding the last sample
+     * @return true if the profile was opened
+     */
+    bool addLoadProfile(size_t index, const std::string& path, uint32_t channel = 0, double scale = 1.0,
+                        bool loop = true);
+    const LoadProfilePlayer& getLoadProfiles() const;
+
     Motor& getMotor(size_t index = 0);
     Encoder& getEncoder(size_t index = 0);
 
+    const std::map<std::string, std::shared_ptr<CanBus>>& getCanBuses() const;
+
+    // Heap in use over the servo count, for sizing large fleets (0 if the allocator
+    // cannot tell); also exported as motor_sim_heap_bytes_per_servo
+    size_t measureHeapBytesPerServo();
+
+    // Publish full-precision servo state to /dev/shm/can_sim_state_<name> (call before start)
+    void enableStateMirror(const std::string& name = "main");
+    uint64_t getTick() const;
+
+    // Capture servo state every tick to a compressed file (call before start,
+    // no indices = every servo); decode with telemetry_reader
+    void enableTelemetry(const std::string& path, const std::vector<size_t>& servo_indices = {});
+    const TelemetryRecorder* getTelemetry() const;
+
+    // Sample and transmit all boards on a CANopen-style SYNC message (call before start)
+    void enableSync(uint32_t sync_id = 0x80);
+
 private:
     void simulationLoop();
+    void createCanBuses();
+    void attachCanBus(CanBoard& board);
+    void claimCanBitrate(Servo& servo);
+    void applyPendingEdit();
+    void createSyncGroups();
+    void createKernelGroups();
+    uint32_t integrationDecimation(size_t index) const;
+    double observationStep(const Servo& servo) const;
+    uint32_t publishDivider(const KernelGroup& group) const;
+    bool capturesTelemetry(size_t index) const;
+    void startTelemetry();
+    void stepKernelGroup(KernelGroup& group, uint64_t tick);
+    void publishLanes(KernelGroup& group);
+    void publishAllLanes();
+    void stepChains();
+    void stepChainShare(uint32_t worker, uint32_t workers);
+    void chargePhysics(const std::vector<uint32_t>& indices, uint64_t cycles);
+    void startChainWorkers();
+    void stopChainWorkers();
+    void chainWorkerLoop(uint32_t worker, uint32_t workers);
 };
\ No newline at end of file
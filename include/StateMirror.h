@@ -0,0 +1,73 @@
+#pragma once
+
+#include "StateMirrorLayout.h"
+#include <string>
+
+class Servo;
+
+/**
+ * @brief Publishes every servo's full-precision state to a shared-memory segment
+ *
+ * Owned by SimulationEngine and written from the physics thread after each tick.
+ * External monitors mmap "/dev/shm/can_sim_state_<name>" read-only and read entries
+ * through the seqlock in StateMirrorLayout.h, without touching the CAN bus.
+ *
+ * Example reader:
+ *   int fd = shm_open("/can_sim_state_main", O_RDONLY, 0);
+ *   auto* header = static_cast<const StateMirrorHeader*>(mmap(..., PROT_READ, MAP_SHARED, fd, 0));
+ *   ServoStateSnapshot state = stateMirrorEntries(header)[0].read();
+ */
+class StateMirror {
+private:
+    std::string path_;
+    StateMirrorHeader* header_;
+    StateMirrorEntry* entries_;
+    uint32_t servo_count_;
+    size_t size_;
+
+public:
+    /**
+     * @brief Constructor
+     * @param name Segment name (the mirror lives at /dev/shm/can_sim_state_<name>)
+     */
+    explicit StateMirror(const std::string& name = "main");
+
+    /**
+     * @brief Destructor - unmaps and unlinks the segment
+     */
+    ~StateMirror();
+
+    StateMirror(const StateMirror&) = delete;
+    StateMirror& operator=(const StateMirror&) = delete;
+
+    /**
+     * @brief Create and size the segment
+     * @param servo_count Number of entries
+     * @param simulation_frequency_hz Physics rate, recorded for readers
+     * @return true if the segment is ready for publishing
+     */
+    bool open(uint32_t servo_count, double simulation_frequency_hz);
+
+    /**
+     * @brief Unmap and unlink the segment
+     */
+    void close();
+
+    /**
+     * @brief Check if the segment is mapped
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Publish one servo's state (physics thread only)
+     * @param index Entry index (same as the engine's servo index)
+     * @param servo Servo to sample
+     * @param tick Physics tick the state belongs to
+     */
+    void publish(uint32_t index, const Servo& servo, uint64_t tick);
+
+    /**
+     * @brief Mark a tick as completely published
+     */
+    void commitTick(uint64_t tick);
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Shared-memory layout of the live servo state mirror
+ *
+ * The simulation engine is the only writer. Each servo owns one cache-line sized
+ * entry guarded by a seqlock: the sequence is odd while the physics thread is
+ * updating it, and readers retry if it changed underneath them. Readers never
+ * write to the segment and never block the simulator.
+ *
+ * All fields are std::atomic accessed with relaxed ordering, so concurrent reads
+ * are well defined; on x86 and ARM64 they compile to plain loads and stores.
+ */
+
+constexpr uint32_t STATE_MIRROR_MAGIC = 0x4D53534D;  // "MSSM"
+constexpr uint32_t STATE_MIRROR_VERSION = 1;
+
+/**
+ * @brief Plain copy of one servo's state, as returned to readers
+ */
+struct ServoStateSnapshot {
+    uint32_t canId = 0;
+    int32_t controlSignal = 0;
+    uint64_t tick = 0;               ///< Physics tick the state belongs to
+    int64_t encoderSteps = 0;
+    double angularPosition = 0.0;    ///< Motor position in radians (unwrapped)
+    double angularVelocity = 0.0;    ///< Motor velocity in rad/s
+    double encoderRadians = 0.0;     ///< Encoder position in radians (wrapped)
+};
+
+struct alignas(64) StateMirrorEntry {
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> can_id;
+    std::atomic<int32_t> control_signal;
+    std::atomic<uint64_t> tick;
+    std::atomic<int64_t> encoder_steps;
+    std::atomic<double> angular_position;
+    std::atomic<double> angular_velocity;
+    std::atomic<double> encoder_radians;
+
+    /**
+     * @brief Publish a new state (single writer only)
+     */
+    void write(const ServoStateSnapshot& state) {
+        uint32_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        can_id.store(state.canId, std::memory_order_relaxed);
+        control_signal.store(state.controlSignal, std::memory_order_relaxed);
+        tick.store(state.tick, std::memory_order_relaxed);
+        encoder_steps.store(state.encoderSteps, std::memory_order_relaxed);
+        angular_position.store(state.angularPosition, std::memory_order_relaxed);
+        angular_velocity.store(state.angularVelocity, std::memory_order_relaxed);
+        encoder_radians.store(state.encoderRadians, std::memory_order_relaxed);
+
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent state (any number of readers, lock-free)
+     */
+    ServoStateSnapshot read() const {
+        ServoStateSnapshot state;
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            state.canId = can_id.load(std::memory_order_relaxed);
+            state.controlSignal = control_signal.load(std::memory_order_relaxed);
+            state.tick = tick.load(std::memory_order_relaxed);
+            state.encoderSteps = encoder_steps.load(std::memory_order_relaxed);
+            state.angularPosition = angular_position.load(std::memory_order_relaxed);
+            state.angularVelocity = angular_velocity.load(std::memory_order_relaxed);
+            state.encoderRadians = encoder_radians.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1U) || before != after);
+        return state;
+    }
+};
+
+struct alignas(64) StateMirrorHeader {
+    std::atomic<uint32_t> magic;          // Written last by the engine, STATE_MIRROR_MAGIC once usable
+    uint32_t version;
+    uint32_t servo_count;
+    uint32_t entry_size;
+    double simulation_frequency_hz;
+    std::atomic<uint64_t> tick;           // Last fully published physics tick
+};
+
+static_assert(sizeof(StateMirrorEntry) == 64, "Mirror entries must stay one cache line");
+static_assert(std::atomic<double>::is_always_lock_free, "Mirror needs lock-free double atomics");
+
+/**
+ * @brief Total segment size for a number of servos
+ */
+inline size_t stateMirrorSize(uint32_t servo_count) {
+    return sizeof(StateMirrorHeader) + servo_count * sizeof(StateMirrorEntry);
+}
+
+/**
+ * @brief Entry array following the header
+ */
+inline StateMirrorEntry* stateMirrorEntries(StateMirrorHeader* header) {
+    return reinterpret_cast<StateMirrorEntry*>(header + 1);
+}
+
+inline const StateMirrorEntry* stateMirrorEntries(const StateMirrorHeader* header) {
+    return reinterpret_cast<const StateMirrorEntry*>(header + 1);
+}
+
+/**
+ * @brief Build the POSIX shm object name for a mirror ("main" -> "/can_sim_state_main")
+ *
+ * The prefix keeps mirrors apart from shm:<name> CAN segments of the same name.
+ */
+inline std::string stateMirrorPath(const std::string& name) {
+    return "/can_sim_state_" + name;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CanBoard;
+
+/**
+ * @brief CANopen-style SYNC coordination for all boards on one interface
+ *
+ * One board per interface listens for the SYNC ID and calls requestSync(). At the
+ * next physics tick the engine calls latchIfRequested(), which latches every board's
+ * encoder and velocity from that same tick, then wakes the sender thread to put all
+ * status frames on the bus as one burst. Boards in a SyncGroup run no encoder_read
+ * or can_transmit timers of their own.
+ */
+class SyncGroup {
+private:
+    uint32_t sync_id_;
+    std::vector<CanBoard*> boards_;
+    std::atomic<bool> sync_requested_;
+    std::atomic<bool> running_;
+    std::thread sender_thread_;
+    std::mutex mutex_;
+    std::condition_variable burst_cv_;
+    uint64_t pending_bursts_;
+    std::atomic<uint64_t> sync_count_;
+
+public:
+    /**
+     * @brief Constructor
+     * @param sync_id CAN ID of the SYNC message (CANopen default 0x80)
+     */
+    explicit SyncGroup(uint32_t sync_id = 0x80);
+
+    /**
+     * @brief Destructor - stops the sender thread
+     */
+    ~SyncGroup();
+
+    SyncGroup(const SyncGroup&) = delete;
+    SyncGroup& operator=(const SyncGroup&) = delete;
+
+    /**
+     * @brief Add a board to the group (call before start)
+     */
+    void addBoard(CanBoard* board);
+
+    /**
+     * @brief Start the burst sender thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the burst sender thread
+     */
+    void stop();
+
+    /**
+     * @brief Request a coherent sample (called from the listener's receive thread)
+     */
+    void requestSync();
+
+    /**
+     * @brief Check for a pending SYNC without consuming it (physics thread)
+     */
+    bool isSyncRequested() const;
+
+    /**
+     * @brief Latch all boards if a SYNC arrived since the last tick (physics thread only)
+     * @param tick Physics tick the latched state belongs to
+     * @return true if the boards were latched and a burst was queued
+     */
+    bool latchIfRequested(uint64_t tick);
+
+    /**
+     * @brief Get the SYNC CAN ID
+     */
+    uint32_t getSyncId() const;
+
+    /**
+     * @brief Get number of SYNC messages serviced
+     */
+    uint64_t getSyncCount() const;
+
+private:
+    /**
+     * @brief Sender thread function
+     */
+    void senderLoop();
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Telemetry file layout and column codecs, shared by TelemetryRecorder and telemetry_reader
+ *
+ * A file is a TelemetryFileHeader, the engine index of each captured servo (uint32),
+ * then blocks of up to TELEMETRY_BLOCK_TICKS consecutive captured ticks. Each block is
+ * a TelemetryBlockHeader followed by length-prefixed (uint32) columns:
+ * - tick: zigzag varints of delta-of-delta from firstTick (a run of 0s at full rate)
+ * - per servo, in header order:
+ *   - position (rad) and velocity (rad/s): XOR float encoding (Gorilla)
+ *   - control signal and encoder steps: zigzag varints of deltas
+ * All integers are little-endian.
+ */
+constexpr uint32_t TELEMETRY_FILE_MAGIC = 0x4D4C4554;   // "TELM"
+constexpr uint32_t TELEMETRY_BLOCK_MAGIC = 0x4B4C4254;  // "TBLK"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr uint32_t TELEMETRY_BLOCK_TICKS = 4096;
+
+struct TelemetryFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    double tickRateHz;
+    uint32_t servoCount;
+    uint32_t reserved;
+};
+
+struct TelemetryBlockHeader {
+    uint32_t magic;
+    uint32_t tickCount;
+    uint64_t firstTick;
+};
+
+// One servo's state in a captured tick
+struct TelemetrySample {
+    double position;
+    double velocity;
+    int32_t control;
+    int32_t steps;
+};
+
+static_assert(sizeof(TelemetryFileHeader) == 24, "Telemetry header layout is part of the file format");
+static_assert(sizeof(TelemetryBlockHeader) == 16, "Telemetry block layout is part of the file format");
+
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @return false if the varint runs past the end of the buffer
+ */
+inline bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class BitWriter {
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t pending_;  // Bits not yet flushed, most significant first
+    int pending_bits_;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out), pending_(0), pending_bits_(0) {}
+
+    // Append the low `count` bits of value (count <= 32)
+    void write(uint32_t value, int count) {
+        pending_ = (pending_ << count) | (count == 32 ? value : value & ((1U << count) - 1));
+        pending_bits_ += count;
+        while (pending_bits_ >= 8) {
+            pending_bits_ -= 8;
+            out_.push_back(static_cast<uint8_t>(pending_ >> pending_bits_));
+        }
+    }
+
+    void write64(uint64_t value, int count) {
+        if (count > 32) {
+            write(static_cast<uint32_t>(value >> 32), count - 32);
+            count = 32;
+        }
+        write(static_cast<uint32_t>(value), count);
+    }
+
+    // Pad the last byte with zero bits
+    void flush() {
+        if (pending_bits_ > 0) {
+            out_.push_back(static_cast<uint8_t>(pending_ << (8 - pending_bits_)));
+            pending_bits_ = 0;
+        }
+    }
+};
+
+class BitReader {
+private:
+    const uint8_t* data_;
+    const uint8_t* end_;
+    uint64_t pending_;
+    int pending_bits_;
+
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), end_(data + size), pending_(0), pending_bits_(0) {}
+
+    // Read `count` bits (count <= 32); past the end reads zero bits
+    uint32_t read(int count) {
+        while (pending_bits_ < count) {
+            pending_ = (pending_ << 8) | (data_ < end_ ? *data_++ : 0);
+            pending_bits_ += 8;
+        }
+        pending_bits_ -= count;
+        uint64_t mask = (count == 32) ? 0xFFFFFFFFULL : ((1ULL << count) - 1);
+        return static_cast<uint32_t>((pending_ >> pending_bits_) & mask);
+    }
+
+    uint64_t read64(int count) {
+        uint64_t value = 0;
+        if (count > 32) {
+            value = static_cast<uint64_t>(read(count - 32)) << 32;
+            count = 32;
+        }
+        return value | read(count);
+    }
+};
+
+/**
+ * @brief XOR float encoding (Gorilla): slowly changing doubles cost a few bits each
+ *
+ * Each value is XORed with its predecessor. Identical values cost one bit. Otherwise
+ * only the meaningful bits between the leading and trailing zeros are stored, reusing
+ * the previous window when they fit in it.
+ */
+class XorFloatEncoder {
+private:
+    uint64_t previous_ = 0;
+    int leading_ = -1;   // Previous window, -1 = none yet
+    int trailing_ = 0;
+    bool first_ = true;
+
+public:
+    void encode(BitWriter& writer, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (first_) {
+            writer.write64(bits, 64);
+            previous_ = bits;
+            first_ = false;
+            return;
+        }
+
+        uint64_t difference = bits ^ previous_;
+        previous_ = bits;
+        if (difference == 0) {
+            writer.write(0, 1);
+            return;
+        }
+
+        int leading = __builtin_clzll(difference);
+        int trailing = __builtin_ctzll(difference);
+        if (leading_ >= 0 && leading >= leading_ && trailing >= trailing_) {
+            writer.write(0b10, 2);
+            writer.write64(difference >> trailing_, 64 - leading_ - trailing_);
+            return;
+        }
+
+        // New window: 6 bits of leading zeros, 6 bits of (length - 1)
+        int length = 64 - leading - trailing;
+        writer.write(0b11, 2);
+        writer.write(static_cast<uint32_t>(leading), 6);
+        writer.write(static_cast<uint32_t>(length - 1), 6);
+        writer.write64(difference >> trailing, length);
+        leading_ = leading;
+        trailing_ = trailing;
+    }
+};
+
+class XorFloatDecoder {
+private:
+    uint64_t previous_ = 0;
+    int leading_ = 0;
+    int trailing_ = 0;
+    bool first_ = true;
+
+public:
+    double decode(BitReader& reader) {
+        if (first_) {
+            previous_ = reader.read64(64);
+            first_ = false;
+        } else if (reader.read(1) == 1) {
+            if (reader.read(1) == 1) {
+                leading_ = static_cast<int>(reader.read(6));
+                int length = static_cast<int>(reader.read(6)) + 1;
+                trailing_ = 64 - leading_ - length;
+            }
+            int length = 64 - leading_ - trailing_;
+            previous_ ^= reader.read64(length) << trailing_;
+        }
+
+        double value;
+        std::memcpy(&value, &previous_, sizeof(value));
+        return value;
+    }
+};
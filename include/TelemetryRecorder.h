@@ -0,0 +1,144 @@
+#pragma once
+
+#include "TelemetryFormat.h"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Servo;
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring of captured ticks
+ *
+ * Each record is the tick number followed by one TelemetrySample per captured servo.
+ * The producer writes records in place and never blocks: when the writer thread falls
+ * behind, the tick is dropped and counted.
+ */
+class TelemetryRing {
+private:
+    std::vector<uint8_t> storage_;
+    size_t record_size_;
+    uint64_t capacity_;  // Records, power of two
+    alignas(64) std::atomic<uint64_t> head_;  // Next record the producer writes
+    alignas(64) std::atomic<uint64_t> tail_;  // Next record the consumer reads
+    alignas(64) std::atomic<uint64_t> dropped_;
+
+public:
+    TelemetryRing(uint32_t servo_count, uint64_t capacity);
+
+    /**
+     * @brief Claim the next record (producer only)
+     * @return Samples of the record, nullptr if the ring is full
+     */
+    TelemetrySample* beginRecord(uint64_t tick);
+
+    // Publish the record returned by beginRecord() (producer only)
+    void commitRecord() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+     * @brief Oldest unread record (consumer only)
+     * @return Samples of the record, nullptr if the ring is empty
+     */
+    const TelemetrySample* peekRecord(uint64_t& tick) const;
+
+    // Release the record returned by peekRecord() (consumer only)
+    void popRecord() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t* record(uint64_t position) { return storage_.data() + (position & (capacity_ - 1)) * record_size_; }
+    const uint8_t* record(uint64_t position) const {
+        return storage_.data() + (position & (capacity_ - 1)) * record_size_;
+    }
+};
+
+/**
+ * @brief Captures selected servos every physics tick into a compressed columnar file
+ *
+ * Each capturing thread gets its own TelemetryRing, so capture is a plain copy into
+ * the ring, with no locks or shared cache lines between producers. A writer thread
+ * drains the rings, gathers TELEMETRY_BLOCK_TICKS ticks into columns, and encodes
+ * them (see TelemetryFormat.h). Decode files with telemetry_reader.
+ */
+class TelemetryRecorder {
+private:
+    std::string path_;
+    std::vector<Servo*> servos_;
+    std::vector<uint32_t> indices_;
+    double tick_rate_hz_;
+    FILE* file_;
+
+    mutable std::mutex rings_mutex_;                     // Guards rings_ against registration while draining
+    std::vector<std::unique_ptr<TelemetryRing>> rings_;
+
+    // Writer thread: staged columns of the block being gathered, per ring
+    struct Block {
+        uint64_t firstTick = 0;
+        std::vector<uint64_t> ticks;
+        std::vector<TelemetrySample> samples;      // Tick-major, servo-minor
+    };
+    std::vector<Block> blocks_;
+    std::vector<uint8_t> encoded_;
+    uint64_t bytes_written_;
+    uint64_t ticks_written_;
+
+    std::atomic<bool> running_;
+    std::thread writer_thread_;
+
+public:
+    // Buffer each producer has ahead of the writer (rounded to a power-of-two tick count)
+    static constexpr size_t RING_BYTES = 16u << 20;
+    static constexpr uint64_t MIN_RING_TICKS = 1024;
+
+    // How long the writer sleeps when every ring is empty
+    static constexpr int WRITER_IDLE_MS = 1;
+
+    /**
+     * @param path Output file
+     * @param servos Servos to capture (must outlive the recorder)
+     * @param indices Engine index of each servo, stored in the file
+     * @param tick_rate_hz Capture rate, stored in the file
+     */
+    TelemetryRecorder(const std::string& path, const std::vector<Servo*>& servos,
+                      const std::vector<uint32_t>& indices, double tick_rate_hz);
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    /**
+     * @brief Create the file and start the writer thread
+     * @return true if capturing can start
+     */
+    bool start();
+
+    /**
+     * @brief Drain every ring, write the last block and close the file
+     */
+    void stop();
+
+    /**
+     * @brief Create the calling thread's ring (call once per capturing thread)
+     */
+    TelemetryRing* registerProducer();
+
+    /**
+     * @brief Capture every selected servo for one tick (the ring's producer thread only)
+     */
+    void capture(TelemetryRing& ring, uint64_t tick);
+
+    uint64_t getDropped() const;
+    uint64_t getBytesWritten() const { return bytes_written_; }
+    uint64_t getTicksWritten() const { return ticks_written_; }
+    size_t getServoCount() const { return servos_.size(); }
+
+private:
+    void writerLoop();
+    bool drain();
+    void writeBlock(Block& block);
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <semaphore.h>
+#include <set>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Opt-in timeline of spans across all simulator threads, in Chrome trace format
+ *
+ * Each thread records completed spans into its own ring, keeping the most recent
+ * ones like a flight recorder; recording is a few stores, without locks. The rings
+ * are written as Chrome trace-event JSON (open in ui.perfetto.dev or chrome://tracing)
+ * when the process receives SIGUSR1, to `<path>.<n>`, and at shutdown(), to `<path>`.
+ *
+ * While disabled, a span costs one relaxed load.
+ */
+class Tracer {
+public:
+    // Spans kept per thread; the physics thread asks for more (see nameThread)
+    static constexpr size_t DEFAULT_RING_EVENTS = 16384;
+
+    /**
+     * @brief Start recording, and dump on SIGUSR1
+     * @param path Trace file written at shutdown; signal dumps append .1, .2, ...
+     */
+    static void enable(const std::string& path);
+
+    /**
+     * @brief Write the final trace and stop recording (no-op if never enabled)
+     */
+    static void shutdown();
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Name the calling thread in the trace and size its ring (before its first span)
+     */
+    static void nameThread(const std::string& name, size_t ring_events = DEFAULT_RING_EVENTS);
+
+    /**
+     * @brief Stable copy of a span name built at run time (call once, outside the hot path)
+     */
+    static const char* intern(const std::string& name);
+
+    /**
+     * @brief Record a completed span on the calling thread
+     * @param name Static or interned string
+     * @param id Shown as the span's "id" argument, 0 = none (e.g. a board's CAN ID)
+     */
+    static void record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t id);
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint32_t durationNs;
+        uint32_t id;
+    };
+
+    struct Ring {
+        std::string threadName;
+        long tid;
+        std::vector<Event> events;
+        std::atomic<uint64_t> head{0};   // Events recorded; slot = head % size
+    };
+
+    static Ring* threadRing(size_t ring_events);
+    static void onDumpSignal(int signal);
+    static void dumperLoop();
+    static bool write(const std::string& path);
+
+    static std::atomic<bool> enabled_;
+    static std::string path_;
+    static sem_t dump_request_;       // Posted by the signal handler
+    static std::thread dumper_;
+    static std::atomic<bool> dumper_running_;
+    static struct sigaction previous_action_;
+
+    static std::mutex mutex_;         // Guards rings_ and names_
+    static std::vector<std::shared_ptr<Ring>> rings_;
+    static std::set<std::string> names_;
+    static thread_local Ring* thread_ring_;
+};
+
+/**
+ * @brief Records the enclosing scope as a span when tracing is enabled
+ */
+class TraceSpan {
+private:
+    const char* name_;
+    uint32_t id_;
+    uint64_t start_ns_;
+
+public:
+    explicit TraceSpan(const char* name, uint32_t id = 0)
+        : name_(name), id_(id), start_ns_(Tracer::isEnabled() ? Tracer::nowNs() : 0) {}
+
+    ~TraceSpan() {
+        if (start_ns_ != 0) {
+            Tracer::record(name_, start_ns_, Tracer::nowNs(), id_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
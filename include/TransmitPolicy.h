@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * @brief Status (0x13) transmission policy of a CAN board
+ *
+ * FixedRate reproduces the classic behaviour: one status frame per transmit period.
+ * OnChange samples every minInterval but only sends when position or velocity moved
+ * beyond their deadbands or the effort changed, and always sends at least once per
+ * maxInterval as a heartbeat.
+ *
+ * With timestamped set, every 0x13 status frame is immediately followed by a 0x14
+ * companion frame carrying the physics tick at which the encoder was latched and
+ * the latch-to-transmit age, so controllers can compensate for pipeline latency.
+ *
+ * Example usage:
+ *   TransmitPolicy policy;
+ *   policy.mode = TransmitPolicy::Mode::OnChange;
+ *   policy.positionDeadbandSteps = 16;
+ *   policy.velocityDeadbandRPM = 0.05;
+ *   policy.minInterval = std::chrono::milliseconds(10);
+ *   policy.maxInterval = std::chrono::milliseconds(500);
+ */
+struct TransmitPolicy {
+    enum class Mode {
+        FixedRate,  ///< Send every transmit period (default)
+        OnChange    ///< Send on change beyond deadbands, with heartbeat
+    };
+
+    Mode mode = Mode::FixedRate;
+    long positionDeadbandSteps = 0;        ///< Encoder steps the position must move before a send
+    double velocityDeadbandRPM = 0.0;      ///< RPM the reported speed must change before a send
+    std::chrono::microseconds minInterval = std::chrono::milliseconds(10);   ///< Sampling period (OnChange)
+    std::chrono::microseconds maxInterval = std::chrono::milliseconds(1000); ///< Heartbeat period (OnChange)
+    bool timestamped = false;              ///< Send a 0x14 latch timestamp frame after each status frame
+};
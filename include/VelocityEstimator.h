@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Encoder-derived velocity estimator using integer arithmetic
+ *
+ * Emulates what board firmware does: estimate speed from successive latched encoder
+ * step counts sampled at a fixed rate. All runtime state is fixed-point (Q16) and
+ * stored inline, so update() never allocates and has no data-dependent branches.
+ * Step deltas are wrapped around the encoder's (power-of-two) resolution, so a
+ * crossing of Encoder::getMaxSteps() is seen as a small step, not a full turn.
+ *
+ * Methods:
+ * - FiniteDifference: delta steps / sample period
+ * - MovingAverage: finite difference averaged over a power-of-two window of samples
+ * - TrackingLoop: second-order PLL / tracking observer with configurable bandwidth
+ *
+ * Example usage:
+ *   VelocityEstimator estimator;
+ *   VelocityEstimator::Config config;
+ *   config.method = VelocityEstimator::Method::TrackingLoop;
+ *   estimator.configure(config, encoder.getMaxSteps(), 300.0);
+ *   estimator.update(encoder.getPositionSteps());   // every encoder read
+ *   int16_t speed = estimator.getSpeedRPMx100();
+ */
+class VelocityEstimator {
+public:
+    enum class Method {
+        Model,             ///< No estimation, report the motor model's velocity
+        FiniteDifference,
+        MovingAverage,
+        TrackingLoop
+    };
+
+    struct Config {
+        Method method = Method::Model;
+        int averageWindow = 8;           ///< MovingAverage samples, rounded down to a power of two (max 64)
+        double trackingBandwidthHz = 20.0; ///< TrackingLoop natural frequency
+    };
+
+    static constexpr int MAX_AVERAGE_WINDOW = 64;
+    static constexpr int FRACTION_BITS = 16;
+
+private:
+    Method method_;
+
+    // Encoder geometry (Q16 wrap)
+    int64_t half_revolution_q16_;
+    int64_t revolution_mask_q16_;
+
+    // Sample timing
+    int64_t sample_rate_q16_;        // Samples per second, Q16
+    int64_t sample_period_q24_;      // Seconds per sample, Q24
+
+    // Conversion of steps/s (Q16) to RPM * 100
+    int64_t rpm_x100_numerator_;     // 6000
+    int64_t rpm_x100_denominator_;   // max_steps << 16
+
+    // FiniteDifference / MovingAverage state
+    int64_t last_steps_;
+    int64_t window_sum_;
+    int64_t window_[MAX_AVERAGE_WINDOW];
+    uint32_t window_index_;
+    uint32_t window_mask_;
+    uint32_t window_shift_;
+
+    // TrackingLoop state and gains
+    int64_t position_estimate_q16_;
+    int64_t velocity_q16_;
+    int64_t proportional_gain_q16_;  // 2 * zeta * omega * T
+    int64_t integral_gain_q16_;      // omega^2 * T (per second)
+
+    bool primed_;
+
+public:
+    VelocityEstimator();
+
+    /**
+     * @brief Configure the estimator and reset its state (not real-time safe)
+     * @param config Method and tuning
+     * @param max_steps Encoder steps per revolution (power of two)
+     * @param sample_rate_hz Rate at which update() is called
+     */
+    void configure(const Config& config, long max_steps, double sample_rate_hz);
+
+    /**
+     * @brief Reset state; the next sample primes the estimator
+     */
+    void reset();
+
+    /**
+     * @brief Feed one latched encoder position
+     * @param steps Encoder position in steps, 0..max_steps-1
+     */
+    void update(long steps);
+
+    /**
+     * @brief Check if the estimator replaces the model velocity
+     */
+    bool isEnabled() const { return method_ != Method::Model; }
+
+    Method getMethod() const { return method_; }
+
+    /**
+     * @brief Estimated velocity in encoder steps per second, Q16 fixed-point
+     */
+    int64_t getVelocityStepsPerSecondQ16() const;
+
+    /**
+     * @brief Estimated velocity in the status frame format (RPM * 100, saturated)
+     */
+    int16_t getSpeedRPMx100() const;
+
+private:
+    int64_t wrapQ16(int64_t value_q16) const {
+        return ((value_q16 + half_revolution_q16_) & revolution_mask_q16_) - half_revolution_q16_;
+    }
+};
@@ -0,0 +1,200 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+#include <execinfo.h>
+#endif
+
+namespace {
+
+std::atomic<AllocationTracker::Mode> mode{AllocationTracker::Mode::Off};
+std::atomic<bool> armed{false};
+std::atomic<uint64_t> hot_allocations{0};
+
+thread_local uint64_t thread_allocations = 0;
+
+} // namespace
+
+void AllocationTracker::setMode(Mode new_mode) {
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+    // backtrace() allocates when first used; do that now, not inside operator new
+    void* frames[1];
+    backtrace(frames, 1);
+#endif
+    mode = new_mode;
+}
+
+AllocationTracker::Mode AllocationTracker::getMode() {
+    return mode;
+}
+
+void AllocationTracker::arm() {
+    armed = mode != Mode::Off;
+}
+
+void AllocationTracker::disarm() {
+    armed = false;
+}
+
+uint64_t AllocationTracker::getHotAllocations() {
+    return hot_allocations;
+}
+
+uint64_t AllocationTracker::getThreadAllocations() {
+    return thread_allocations;
+}
+
+#ifdef MOTOR_SIM_TRACK_ALLOCATIONS
+
+thread_local uint32_t AllocationTracker::hot_depth_ = 0;
+
+namespace {
+
+// Hashes of the call stacks already reported (0 = free)
+std::atomic<uint64_t> reported_sites[AllocationTracker::REPORT_SITES];
+
+// Claim a stack's slot; false if it was reported before or the table is full
+bool firstReport(uint64_t site) {
+    for (size_t probe = 0; probe < AllocationTracker::REPORT_SITES; ++probe) {
+        std::atomic<uint64_t>& slot = reported_sites[(site + probe) % AllocationTracker::REPORT_SITES];
+        uint64_t seen = slot.load(std::memory_order_relaxed);
+        if (seen == 0 && slot.compare_exchange_strong(seen, site, std::memory_order_relaxed)) {
+            return true;
+        }
+        if (seen == site) {
+            return false;
+        }
+    }
+    return false;
+}
+
+void onHotAllocation(std::size_t size) {
+    hot_allocations.fetch_add(1, std::memory_order_relaxed);
+    bool aborting = mode.load(std::memory_order_relaxed) == AllocationTracker::Mode::Abort;
+
+    void* frames[32];
+    int depth = backtrace(frames, 32);
+    uint64_t site = 1469598103934665603ULL; // FNV-1a over the return addresses
+    for (int i = 0; i < depth; ++i) {
+        site = (site ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ULL;
+    }
+    if (!aborting && !firstReport(site | 1)) {
+        return;
+    }
+
+    // Only stack buffers and write(): the heap is what is being watched
+    char message[128];
+    int length = std::snprintf(message, sizeof(message), "AllocationTracker: %zu-byte allocation on a hot path:\n", size);
+    (void)!write(STDERR_FILENO, message, static_cast<size_t>(length));
+    backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+    if (aborting) {
+        std::abort();
+    }
+}
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    ++thread_allocations;
+    if (AllocationTracker::hot_depth_ > 0 && armed.load(std::memory_order_relaxed)) {
+        onHotAllocation(size);
+    }
+
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        memory = std::malloc(size);
+    } else if (posix_memalign(&memory, alignment, size) != 0) {
+        memory = nullptr;
+    }
+    return memory;
+}
+
+void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+    void* memory = allocate(size, alignment);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+#endif
@@ -0,0 +1,213 @@
+#include "SimulationEngine.h"
+#include "ServoKernels.h"
+#include "FixedPointLanes.h"
+#include "TelemetryRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Time the simulator's hot paths outside the production binary
+ *
+ * Usage: motor_sim_benchmark [ticks]
+ * Steps 1000 servos of each motor model for `ticks` ticks (default 20000, one
+ * simulated second), a 7-DoF chain, and telemetry capture of 100 servos, then
+ * builds and starts a 100,000-axis fleet on loopback buses and prints its heap
+ * per servo.
+ */
+
+namespace {
+
+// Time the physics step of a CAN-less fleet for each motor model variant, of a chain,
+// and the cost of telemetry capture
+void runBenchmark(long ticks) {
+    constexpr size_t fleet_size = 1000;
+    const double dt = 1.0 / 20000.0;
+    enum class Variant { Double, FixedPoint, FixedPointLanes, Electromechanical };
+
+    for (Variant variant : {Variant::Double, Variant::FixedPoint, Variant::FixedPointLanes,
+                            Variant::Electromechanical}) {
+        std::vector<Servo> servos;
+        for (size_t i = 0; i < fleet_size; ++i) {
+            auto builder = Servo::builder()
+                .maxVelocityRPM(60.0)
+                .maxControlSignal(100)
+                .timeConstant(0.15)
+                .encoderDirectionInverted(i % 2 == 1)
+                .fixedPoint(variant == Variant::FixedPoint || variant == Variant::FixedPointLanes);
+            if (variant == Variant::Electromechanical) {
+                builder.electromechanical(ElectromechanicalModel::Parameters());
+            }
+            servos.push_back(builder.build());
+            servos.back().setControlSignal(static_cast<int>(i % 201) - 100);
+        }
+
+        // Step through the specialized kernels, grouped by variant, or through lanes as
+        // the engine steps fixed-point servos
+        std::map<ServoKernel, std::vector<Servo*>> groups;
+        std::vector<Servo*> all;
+        for (auto& servo : servos) {
+            groups[selectServoKernel(servo)].push_back(&servo);
+            all.push_back(&servo);
+        }
+        FixedPointLanes lanes;
+        if (variant == Variant::FixedPointLanes) {
+            lanes.load(all, dt);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (variant == Variant::FixedPointLanes) {
+            for (long tick = 0; tick < ticks; ++tick) {
+                lanes.step();
+            }
+            lanes.publish();
+        } else {
+            for (long tick = 0; tick < ticks; ++tick) {
+                for (const auto& group : groups) {
+                    group.first(group.second.data(), group.second.size(), dt);
+                }
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        // Identical for every build and machine in fixed-point mode
+        uint64_t digest = 1469598103934665603ULL;
+        for (const auto& servo : servos) {
+            digest = (digest ^ static_cast<uint64_t>(servo.getEncoderPosition())) * 1099511628211ULL;
+        }
+
+        const char* names[] = {"double           ", "fixed-point      ", "fixed-point lanes", "electromechanical"};
+        std::cout << names[static_cast<int>(variant)] << ": "
+                  << elapsed.count() / (static_cast<double>(ticks) * fleet_size) << " ns per servo step, "
+                  << "encoder digest 0x" << std::hex << digest << std::dec << std::endl;
+    }
+
+    // A 7-DoF arm with alternating yaw/pitch joints, the size the engine rate must sustain
+    constexpr size_t chain_joints = 7;
+    std::vector<Servo> arm;
+    KinematicChain::Config arm_config;
+    for (size_t i = 0; i < chain_joints; ++i) {
+        arm.push_back(Servo::builder().maxVelocityRPM(30.0).timeConstant(0.05).build());
+        arm.back().setControlSignal(static_cast<int>(i * 30) - 90);
+
+        KinematicChain::JointConfig joint;
+        joint.origin[2] = i == 0 ? 0.1 : 0.3;
+        joint.axis[0] = static_cast<double>(i % 2);
+        joint.axis[2] = static_cast<double>(1 - i % 2);
+        joint.mass = 3.0 - 0.3 * static_cast<double>(i);
+        joint.com[2] = 0.15;
+        arm_config.joints.push_back(joint);
+    }
+    std::vector<Servo*> arm_servos;
+    for (auto& servo : arm) {
+        arm_servos.push_back(&servo);
+    }
+    KinematicChain chain(arm_config, arm_servos);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long tick = 0; tick < ticks; ++tick) {
+        chain.step(dt);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double per_step = elapsed.count() / static_cast<double>(ticks);
+    std::cout << "7-DoF chain      : " << per_step << " ns per chain step, "
+              << per_step / (dt * 1e9) * 100.0 << "% of a " << 1.0 / dt << " Hz tick" << std::endl;
+
+    // Telemetry capture of 100 moving servos: the physics thread's share, and the file size
+    constexpr size_t captured_count = 100;
+    std::vector<Servo> captured;
+    std::vector<Servo*> captured_servos;
+    std::vector<uint32_t> captured_indices;
+    for (size_t i = 0; i < captured_count; ++i) {
+        captured.push_back(Servo::builder().maxVelocityRPM(60.0).timeConstant(0.15).build());
+        captured.back().setControlSignal(static_cast<int>(i % 201) - 100);
+    }
+    for (size_t i = 0; i < captured_count; ++i) {
+        captured_servos.push_back(&captured[i]);
+        captured_indices.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::string capture_path = (std::filesystem::temp_directory_path() / "motor_simulator_telemetry.bin").string();
+    TelemetryRecorder recorder(capture_path, captured_servos, captured_indices, 1.0 / dt);
+    if (!recorder.start()) {
+        return;
+    }
+    TelemetryRing* ring = recorder.registerProducer();
+    ServoKernel kernel = selectServoKernel(captured[0]);
+    std::chrono::duration<double, std::nano> capture_time(0.0);
+    for (long tick = 0; tick < ticks; ++tick) {
+        kernel(captured_servos.data(), captured_servos.size(), dt);
+        auto capture_start = std::chrono::steady_clock::now();
+        recorder.capture(*ring, static_cast<uint64_t>(tick));
+        capture_time += std::chrono::steady_clock::now() - capture_start;
+    }
+    recorder.stop();
+    std::remove(capture_path.c_str());
+
+    double per_capture = capture_time.count() / static_cast<double>(ticks);
+    std::cout << "telemetry x" << captured_count << "    : " << per_capture << " ns per tick, "
+              << per_capture / (dt * 1e9) * 100.0 << "% of a " << 1.0 / dt << " Hz tick, "
+              << static_cast<double>(recorder.getBytesWritten()) /
+                     (static_cast<double>(std::max<uint64_t>(recorder.getTicksWritten(), 1)) * captured_count)
+              << " bytes per servo tick (" << recorder.getDropped() << " ticks dropped, unpaced)" << std::endl;
+
+    // Memory of a 100k-axis fleet with every board running, 1000 boards per loopback bus.
+    // The footprint does not depend on the rates, so slow timers keep the run light.
+    constexpr size_t fleet_axes = 100000;
+    constexpr size_t boards_per_bus = 1000;
+    BoardTimerRates slow_timers;
+    slow_timers.encoderReadHz = 1.0;
+    slow_timers.controlUpdateHz = 1.0;
+    slow_timers.canTransmitHz = 1.0;
+
+    SimulationEngine fleet;
+    fleet.setSimulationFrequency(100.0);
+    auto fleet_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fleet_axes; ++i) {
+        fleet.addServo(Servo::builder()
+                           .enableCAN(static_cast<uint32_t>(0x10 + i % boards_per_bus),
+                                      "loop:fleet" + std::to_string(i / boards_per_bus))
+                           .timerRates(slow_timers)
+                           .build());
+    }
+    fleet.start();
+    for (size_t i = 0; i < fleet_axes; ++i) {
+        fleet.getServo(i).startCAN();
+    }
+    std::chrono::duration<double> fleet_setup = std::chrono::steady_clock::now() - fleet_start;
+    size_t bytes_per_servo = fleet.measureHeapBytesPerServo();
+    auto threads = std::distance(std::filesystem::directory_iterator("/proc/self/task"),
+                                 std::filesystem::directory_iterator());
+    std::cout << "fleet x" << fleet_axes << "    : " << bytes_per_servo << " bytes of heap per servo, "
+              << threads << " threads, " << fleet_setup.count() << " s to build and start" << std::endl;
+    for (size_t i = 0; i < fleet_axes; ++i) {
+        fleet.getServo(i).stopCAN();
+    }
+    fleet.stop();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long ticks = 20000;
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [ticks]" << std::endl;
+        return 1;
+    }
+    if (argc == 2) {
+        char* end = nullptr;
+        ticks = std::strtol(argv[1], &end, 10);
+        if (end == argv[1] || *end != '\0' || ticks <= 0) {
+            std::cerr << "Invalid tick count: " << argv[1] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [ticks]" << std::endl;
+            return 1;
+        }
+    }
+    runBenchmark(ticks);
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "BoardScheduler.h"
+#include "CanBoard.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+static_assert(CanBoard::TIMER_COUNT == BoardScheduler::MAX_TIMERS, "Every board timer needs a scheduler slot");
+
+namespace {
+
+// std heap functions keep the largest element first; order by "due later" to get the earliest
+template <typename Entry>
+bool dueLater(const Entry& a, const Entry& b) {
+    return a.dueNs > b.dueNs;
+}
+
+} // namespace
+
+BoardScheduler& BoardScheduler::instance() {
+    static BoardScheduler scheduler;
+    return scheduler;
+}
+
+BoardScheduler::BoardScheduler() : threads_(1), nextShard_(0), running_(false) {
+    for (uint32_t timer = 0; timer < MAX_TIMERS; ++timer) {
+        char labels[48];
+        std::snprintf(labels, sizeof(labels), "timer=\"%s\"", CanBoard::TIMER_NAMES[timer]);
+        executionTime_[timer] = MetricHistogram("motor_sim_timer_execution_seconds",
+                                                "Time spent in one board timer callback", labels);
+        overruns_[timer] = MetricCounter("motor_sim_timer_overruns_total",
+                                         "Board timer callbacks that ran past the next period", labels);
+    }
+}
+
+BoardScheduler::~BoardScheduler() {
+    running_ = false;
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+        }
+        shard->wake.notify_all();
+        shard->thread.join();
+    }
+}
+
+void BoardScheduler::setThreads(uint32_t threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shards_.empty()) {
+        LOG_WARNING("BoardScheduler: Timer threads already started, keeping %u", threads_);
+        return;
+    }
+    threads_ = std::min(std::max(1U, threads), MAX_THREADS);
+}
+
+uint32_t BoardScheduler::getThreads() const {
+    return threads_;
+}
+
+void BoardScheduler::startThreads() {
+    running_ = true;
+    for (uint32_t index = 0; index < threads_; ++index) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    for (uint32_t index = 0; index < threads_; ++index) {
+        shards_[index]->thread = std::thread(&BoardScheduler::timerLoop, this, std::ref(*shards_[index]), index);
+    }
+}
+
+uint32_t BoardScheduler::add(CanBoard& board, const int64_t (&periods)[MAX_TIMERS], uint32_t enabled) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shards_.empty()) {
+            startThreads();
+        }
+    }
+    uint32_t index = nextShard_.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(shards_.size());
+    Shard& shard = *shards_[index];
+    int64_t now = Metrics::nowNs();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    uint32_t slot;
+    if (!shard.freeSlots.empty()) {
+        slot = shard.freeSlots.back();
+        shard.freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(shard.slots.size());
+        shard.slots.emplace_back();
+    }
+
+    Slot& entry = shard.slots[slot];
+    entry.board = &board;
+    for (uint32_t timer = 0; timer < MAX_TIMERS; ++timer) {
+        entry.periodNs[timer] = periods[timer];
+        if (enabled & (1U << timer)) {
+            shard.heap.push_back({now, slot, entry.generation, timer});
+            std::push_heap(shard.heap.begin(), shard.heap.end(), dueLater<Entry>);
+        }
+    }
+    shard.wake.notify_one();
+    return index << SLOT_BITS | slot;
+}
+
+void BoardScheduler::remove(uint32_t handle) {
+    if (handle == NO_HANDLE) {
+        return;
+    }
+    Shard& shard = *shards_[handle >> SLOT_BITS];
+    uint32_t slot = handle & ((1U << SLOT_BITS) - 1);
+
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    Slot& entry = shard.slots[slot];
+    const CanBoard* board = entry.board;
+    entry.board = nullptr;
+    ++entry.generation;
+    shard.freeSlots.push_back(slot);
+    shard.idle.wait(lock, [&shard, board]() { return shard.executing != board; });
+}
+
+void BoardScheduler::timerLoop(Shard& shard, uint32_t index) {
+    // Every board on this thread shares its span ring
+    char thread_name[32];
+    std::snprintf(thread_name, sizeof(thread_name), "board timers %u", index);
+    Tracer::nameThread(thread_name, Tracer::DEFAULT_RING_EVENTS * 16);
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
+
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    while (running_) {
+        if (shard.heap.empty()) {
+            shard.wake.wait(lock);
+            continue;
+        }
+
+        Entry entry = shard.heap.front();
+        if (shard.slots[entry.slot].generation != entry.generation) {
+            // Left behind by a removed board
+            std::pop_heap(shard.heap.begin(), shard.heap.end(), dueLater<Entry>);
+            shard.heap.pop_back();
+            continue;
+        }
+        int64_t started = Metrics::nowNs();
+        if (entry.dueNs > started) {
+            // Woken early by add() or shutdown; the heap is checked again either way
+            shard.wake.wait_until(lock, std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(entry.dueNs))));
+            continue;
+        }
+        std::pop_heap(shard.heap.begin(), shard.heap.end(), dueLater<Entry>);
+        shard.heap.pop_back();
+
+        CanBoard* board = shard.slots[entry.slot].board;
+        shard.executing = board;
+        lock.unlock();
+        board->runTimer(entry.timer);
+        int64_t finished = Metrics::nowNs();
+        executionTime_[entry.timer].observe(static_cast<uint64_t>(finished - started));
+        lock.lock();
+        shard.executing = nullptr;
+        shard.idle.notify_all();
+
+        // Reschedule unless the board was removed while its callback ran
+        const Slot& slot = shard.slots[entry.slot];
+        if (slot.generation == entry.generation) {
+            entry.dueNs += slot.periodNs[entry.timer];
+            if (finished > entry.dueNs) {
+                overruns_[entry.timer].add();
+            }
+            shard.heap.push_back(entry);
+            std::push_heap(shard.heap.begin(), shard.heap.end(), dueLater<Entry>);
+        }
+    }
+}
@@ -1,18 +1,52 @@
 #include "CanBoard.h"
 #include "Servo.h"
-#include <iostream>
-#include <iomanip>
+#include "SyncGroup.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include "AllocationTracker.h"
+#include <cstdio>
 #include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+std::atomic<bool> CanBoard::perBoardLatencyMetrics_{false};
+
+CanBoard::CanBoard(Servo& servo, uint32_t can_id, const std::string& can_interface, uint32_t can_bitrate)
+    : servo_(&servo), transport_(CanTransport::create(can_interface)),
+    can_id_(can_id), can_bitrate_(can_bitrate), running_(false), schedulerHandle_(BoardScheduler::NO_HANDLE),
+    cachedEncoderSteps_(0),
+    cachedEncoderRadians_(0.0), currentControlSignal_(1), syncGroup_(nullptr), syncListener_(false),
+    latchSequence_(0), cachedVelocity_(0.0), latchedTick_(0), simTick_(nullptr), tickPeriodUs_(0.0),
+    integrationClock_(nullptr),
+    lastSentEncoderSteps_(0),
+    lastSentSpeed_(0), lastSentControlSignal_(0), statusSent_(false), estimatedSpeed_(0),
+    holdState_(HOLD_OFF), holdDivider_(0), holdCountdown_(0),
+    pendingControl_(NO_PENDING_CONTROL), actuationHoldState_(HOLD_OFF), actuationControl_(NO_PENDING_CONTROL),
+    commandReceivedNs_(0) {
+    // Boards on different interfaces may share a CAN ID
+    char board_id[16];
+    std::snprintf(board_id, sizeof(board_id), "0x%x", can_id_);
+    std::string interface_label = "interface=\"" + transport_->getInterfaceName() + "\"";
+    std::string board_label = "board=\"" + std::string(board_id) + "\"," + interface_label;
+    framesTx_ = MetricCounter("motor_sim_board_frames_tx_total", "Frames sent by the board", board_label);
+    framesRx_ = MetricCounter("motor_sim_board_frames_rx_total", "Frames received by the board", board_label);
+    sendFailures_ = MetricCounter("motor_sim_board_send_failures_total",
+                                  "Frames the transport or bus model refused", board_label);
+    unknownMessages_ = MetricCounter("motor_sim_board_unknown_messages_total",
+                                     "Received frames with an unknown message type", board_label);
+    commandApplyLatency_ = MetricHistogram("motor_sim_board_command_apply_latency_seconds",
+                                           "Effort command receipt to control signal update",
+                                           perBoardLatencyMetrics_ ? board_label : interface_label);
+    receiveCpu_ = CpuAccounting::instance().account(getCpuOwner(), CpuAccounting::Activity::Receive, true);
+    timersCpu_ = CpuAccounting::instance().account(getCpuOwner(), CpuAccounting::Activity::Timers);
 
-CanBoard::CanBoard(Servo& servo, uint32_t can_id, const std::string& can_interface)
-    : servo_(servo), can_socket_(std::make_unique<CanSocket>(can_interface)),
-    can_id_(can_id), running_(false), cachedEncoderSteps_(0),
-    cachedEncoderRadians_(0.0), currentControlSignal_(1) {
     initializeTimers();
 }
 
 CanBoard::~CanBoard() {
     stop();
+    attachBus(nullptr); // Frames submitted while stopped are still queued
 }
 
 void CanBoard::start() {
@@ -20,33 +54,60 @@ void CanBoard::start() {
         return;
     }
 
-    // Open CAN socket
-    if (!can_socket_->open()) {
-        std::cerr << "CanBoard: Failed to open CAN socket, continuing without CAN communication" << std::endl;
+    // Open CAN transport
+    if (!transport_->open()) {
+        LOG_WARNING("CanBoard: Failed to open CAN transport, continuing without CAN communication");
     } else {
         // Set up CAN filter to only receive frames with CanBoard's CAN ID
-        struct can_filter filter;
-        filter.can_id = can_id_;
-        filter.can_mask = CAN_SFF_MASK; // Standard frame format mask
+        // (and the SYNC ID if this board listens for its group)
+        struct can_filter filters[2];
+        filters[0].can_id = can_id_;
+        filters[0].can_mask = CAN_SFF_MASK; // Standard frame format mask
+        size_t filter_count = 1;
+        if (syncGroup_ && syncListener_) {
+            filters[1].can_id = syncGroup_->getSyncId();
+            filters[1].can_mask = CAN_SFF_MASK;
+            filter_count = 2;
+        }
 
-        if (!can_socket_->setFilters(&filter, 1)) {
-            std::cerr << "CanBoard: Failed to set CAN filter" << std::endl;
+        if (!transport_->setFilters(filters, filter_count)) {
+            LOG_ERROR("CanBoard: Failed to set CAN filter");
         }
 
-        // Start CAN receiving
-        can_socket_->startReceiving([this](const struct can_frame& frame) {
+        // Start CAN receiving; with a bus model, frames reach the board once they have crossed it
+        transport_->startReceiving([this](const struct can_frame& frame) {
+            HotPath hot_path;
+            if (CanBus* bus = can_bus_.get()) {
+                bus->receive(frame, *this);
+                return;
+            }
+            CpuScope cpu(receiveCpu_);
             onCanFrameReceived(frame);
         });
     }
 
+    velocityEstimator_.reset();
+    estimatedSpeed_ = 0;
+    holdState_ = HOLD_OFF;
+
     running_ = true;
+    scheduleTimers();
+}
 
-    // Start all enabled timers
-    for (const auto& timer : timers_) {
-        if (timer.enabled) {
-            timerThreads_.emplace_back(&CanBoard::timerLoop, this, timer);
+void CanBoard::scheduleTimers() {
+    // Start all enabled timers; in SYNC mode the group samples and transmits instead
+    int64_t periods[TIMER_COUNT];
+    uint32_t enabled = 0;
+    for (uint32_t timer = 0; timer < TIMER_COUNT; ++timer) {
+        periods[timer] = std::chrono::duration_cast<std::chrono::nanoseconds>(timers_[timer].period).count();
+        if (syncGroup_ && (timer == ENCODER_READ || timer == CAN_TRANSMIT)) {
+            continue;
+        }
+        if (timers_[timer].enabled) {
+            enabled |= 1U << timer;
         }
     }
+    schedulerHandle_ = BoardScheduler::instance().add(*this, periods, enabled);
 }
 
 void CanBoard::stop() {
@@ -56,17 +117,39 @@ void CanBoard::stop() {
 
     running_ = false;
 
+    // Stop the timers first (waiting for a callback in progress), so none runs on a closed transport
+    BoardScheduler::instance().remove(schedulerHandle_);
+    schedulerHandle_ = BoardScheduler::NO_HANDLE;
+
+    // No frame handler may submit once the bus has let go of the board, and the
+    // bus finishes a frame it is handing over before the transport closes
+    transport_->stopReceiving();
+    if (can_bus_) {
+        can_bus_->detach(static_cast<CanBus::Receiver&>(*this));
+        can_bus_->detach(*transport_);
+    }
+
     // Stop CAN communication
-    can_socket_->close();
+    transport_->close();
+}
 
-    // Wait for all timer threads to finish
-    for (auto& thread : timerThreads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
+void CanBoard::pauseTimers() {
+    if (!running_) {
+        return;
     }
+    BoardScheduler::instance().remove(schedulerHandle_);
+    schedulerHandle_ = BoardScheduler::NO_HANDLE;
+}
 
-    timerThreads_.clear();
+void CanBoard::resumeTimers() {
+    if (!running_ || schedulerHandle_ != BoardScheduler::NO_HANDLE) {
+        return;
+    }
+    scheduleTimers();
+}
+
+void CanBoard::setPerBoardLatencyMetrics(bool enabled) {
+    perBoardLatencyMetrics_ = enabled;
 }
 
 bool CanBoard::isRunning() const {
@@ -89,15 +172,266 @@ uint32_t CanBoard::getCanId() const {
     return can_id_;
 }
 
-CanSocket& CanBoard::getCanSocket() {
-    return *can_socket_;
+std::string CanBoard::getCpuOwner() const {
+    char board_id[16];
+    std::snprintf(board_id, sizeof(board_id), "0x%x", can_id_);
+    return "board " + std::string(board_id) + " on " + transport_->getInterfaceName();
+}
+
+CanTransport& CanBoard::getTransport() {
+    return *transport_;
+}
+
+uint32_t CanBoard::getCanBitrate() const {
+    return can_bitrate_;
+}
+
+void CanBoard::attachBus(std::shared_ptr<CanBus> bus) {
+    if (can_bus_ && can_bus_ != bus) {
+        can_bus_->detach(static_cast<CanBus::Receiver&>(*this));
+        can_bus_->detach(*transport_);
+    }
+    can_bus_ = std::move(bus);
+}
+
+void CanBoard::rebind(Servo& servo) {
+    servo_ = &servo;
+}
+
+void CanBoard::setTimerRates(const BoardTimerRates& rates) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    timerRates_ = rates;
+    applyTimerPeriods();
+
+    // The estimator's coefficients depend on its sample rate
+    velocityEstimator_.configure(velocityEstimatorConfig_, servo_->getEncoder().getMaxSteps(), timerRates_.encoderReadHz);
+}
+
+const BoardTimerRates& CanBoard::getTimerRates() const {
+    return timerRates_;
+}
+
+void CanBoard::setTransmitPolicy(const TransmitPolicy& policy) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    transmitPolicy_ = policy;
+    applyTimerPeriods();
+}
+
+void CanBoard::applyTimerPeriods() {
+    auto periodFromRate = [](double rate_hz) {
+        return std::chrono::microseconds(static_cast<long>(1000000.0 / rate_hz));
+    };
+
+    // In OnChange mode the transmit timer becomes the sampling timer
+    auto transmit_period = periodFromRate(timerRates_.canTransmitHz);
+    if (transmitPolicy_.mode == TransmitPolicy::Mode::OnChange && transmitPolicy_.minInterval.count() > 0) {
+        transmit_period = transmitPolicy_.minInterval;
+    }
+
+    timers_[ENCODER_READ].period = periodFromRate(timerRates_.encoderReadHz);
+    timers_[CONTROL_UPDATE].period = periodFromRate(timerRates_.controlUpdateHz);
+    timers_[CAN_TRANSMIT].period = transmit_period;
+}
+
+const TransmitPolicy& CanBoard::getTransmitPolicy() const {
+    return transmitPolicy_;
+}
+
+void CanBoard::setVelocityEstimator(const VelocityEstimator::Config& config) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    velocityEstimatorConfig_ = config;
+    velocityEstimator_.configure(config, servo_->getEncoder().getMaxSteps(), timerRates_.encoderReadHz);
+}
+
+const VelocityEstimator& CanBoard::getVelocityEstimator() const {
+    return velocityEstimator_;
+}
+
+void CanBoard::setPositionHold(const PositionHold::Config& config) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    positionHoldConfig_ = config;
+    if (simTick_) {
+        configureHoldLoop(1000000.0 / tickPeriodUs_);
+    }
+}
+
+bool CanBoard::isHoldingPosition() const {
+    return holdState_.load(std::memory_order_relaxed) == HOLD_ACTIVE;
+}
+
+double CanBoard::getPositionHoldRate() const {
+    return positionHoldConfig_.rateHz;
+}
+
+bool CanBoard::actuationDue() {
+    actuationHoldState_ = holdState_.load(std::memory_order_acquire);
+    actuationControl_ = NO_PENDING_CONTROL;
+    if (actuationHoldState_ != HOLD_OFF && holdDivider_.load(std::memory_order_relaxed) == 0) {
+        // Requested while the hold was being disabled
+        releaseHold();
+        actuationHoldState_ = HOLD_OFF;
+    }
+    if (actuationHoldState_ != HOLD_OFF) {
+        return actuationHoldState_ == HOLD_REQUESTED || holdCountdown_ == 0;
+    }
+
+    if (pendingControl_.load(std::memory_order_relaxed) != NO_PENDING_CONTROL) {
+        actuationControl_ = pendingControl_.exchange(NO_PENDING_CONTROL, std::memory_order_acquire);
+    }
+    return actuationControl_ != NO_PENDING_CONTROL && actuationControl_ != servo_->getControlSignal();
+}
+
+void CanBoard::actuate(long encoder_steps) {
+    if (actuationHoldState_ != HOLD_OFF) {
+        holdTick(encoder_steps);
+        return;
+    }
+    if (actuationControl_ == NO_PENDING_CONTROL) {
+        return;
+    }
+
+    servo_->setControlSignal(actuationControl_);
+    int64_t received_ns = commandReceivedNs_.load(std::memory_order_relaxed);
+    if (received_ns != 0 && commandReceivedNs_.compare_exchange_strong(received_ns, 0, std::memory_order_relaxed)) {
+        commandApplyLatency_.observe(static_cast<uint64_t>(Metrics::nowNs() - received_ns));
+    }
+}
+
+void CanBoard::holdTick(long encoder_steps) {
+    // Acts on the state actuationDue() saw, so a hold requested since then waits a tick
+    int state = actuationHoldState_;
+    if (state == HOLD_REQUESTED) {
+        // Latch the target on the first tick after the stop command
+        positionHold_.engage(encoder_steps);
+        holdCountdown_ = 0;
+        if (!holdState_.compare_exchange_strong(state, HOLD_ACTIVE, std::memory_order_acq_rel)) {
+            return; // Released again before the hold engaged
+        }
+        pendingControl_.store(NO_PENDING_CONTROL, std::memory_order_relaxed); // Handed over before the stop
+    }
+
+    if (holdCountdown_ == 0) {
+        holdCountdown_ = holdDivider_.load(std::memory_order_relaxed);
+        servo_->setControlSignal(positionHold_.update(encoder_steps));
+    }
+    --holdCountdown_;
+}
+
+void CanBoard::setSyncGroup(SyncGroup* group, bool listener) {
+    syncGroup_ = group;
+    syncListener_ = listener;
+}
+
+void CanBoard::attachSimClock(const std::atomic<uint64_t>& tick, double simulation_frequency_hz) {
+    simTick_ = &tick;
+    tickPeriodUs_ = 1000000.0 / simulation_frequency_hz;
+    configureHoldLoop(simulation_frequency_hz);
+}
+
+void CanBoard::attachIntegrationClock(const IntegrationClock* clock) {
+    integrationClock_.store(clock, std::memory_order_release);
+}
+
+void CanBoard::configureHoldLoop(double simulation_frequency_hz) {
+    // The hold loop runs every holdDivider_ physics ticks, so its period is a whole number of ticks
+    if (positionHoldConfig_.rateHz > 0.0) {
+        uint32_t divider = static_cast<uint32_t>(std::max(1.0, std::round(simulation_frequency_hz / positionHoldConfig_.rateHz)));
+        positionHold_.configure(positionHoldConfig_, servo_->getEncoder().getMaxSteps(),
+                                servo_->getEncoder().isDirectionInverted(),
+                                servo_->getMotor().getMaxControlSignal(),
+                                divider / simulation_frequency_hz);
+        holdDivider_.store(divider, std::memory_order_relaxed);
+    } else {
+        holdDivider_.store(0, std::memory_order_relaxed);
+        releaseHold();
+    }
+}
+
+void CanBoard::releaseHold() {
+    // Whichever hold state is current; a board that holds nothing is not written to
+    int state = holdState_.load(std::memory_order_relaxed);
+    while (state != HOLD_OFF &&
+           !holdState_.compare_exchange_weak(state, HOLD_OFF, std::memory_order_acq_rel)) {
+    }
+}
+
+void CanBoard::latchStatus(uint64_t tick) {
+    storeLatch(servo_->getEncoder().getPositionSteps(), servo_->getAngularVelocity(), tick);
+}
+
+void CanBoard::transmitLatchedStatus() {
+    if (!transport_->isOpen()) {
+        return;
+    }
+
+    LatchedStatus latched = loadLatch();
+    sendStatusFrame(latched.encoderSteps, scaleSpeed(latched.velocity), currentControlSignal_.load(), latched.tick);
+}
+
+void CanBoard::storeLatch(long encoder_steps, double velocity, uint64_t tick) {
+    uint32_t sequence = latchSequence_.load(std::memory_order_relaxed);
+    latchSequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    cachedEncoderSteps_.store(encoder_steps, std::memory_order_relaxed);
+    cachedVelocity_.store(velocity, std::memory_order_relaxed);
+    latchedTick_.store(tick, std::memory_order_relaxed);
+
+    latchSequence_.store(sequence + 2, std::memory_order_release);
+}
+
+CanBoard::LatchedStatus CanBoard::loadLatch() const {
+    LatchedStatus latched;
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = latchSequence_.load(std::memory_order_acquire);
+        latched.encoderSteps = cachedEncoderSteps_.load(std::memory_order_relaxed);
+        latched.velocity = cachedVelocity_.load(std::memory_order_relaxed);
+        latched.tick = latchedTick_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = latchSequence_.load(std::memory_order_relaxed);
+    } while ((before & 1U) || before != after);
+    return latched;
+}
+
+CanBoard::LatchedStatus CanBoard::observeServo() const {
+    LatchedStatus state;
+    const IntegrationClock* clock = integrationClock_.load(std::memory_order_acquire);
+    if (!clock) {
+        state.encoderSteps = servo_->getEncoder().getPositionSteps();
+        state.velocity = servo_->getAngularVelocity();
+        state.tick = currentTick();
+        return state;
+    }
+
+    // A coarse-step servo's state is up to a group step behind the engine's tick, so
+    // it is stamped with the group's tick; retry a read that overlapped a step
+    for (;;) {
+        uint32_t before = clock->sequence.load(std::memory_order_acquire);
+        if (before & 1U) {
+            std::this_thread::yield();
+            continue;
+        }
+        state.encoderSteps = servo_->getEncoder().getPositionSteps();
+        state.velocity = servo_->getAngularVelocity();
+        state.tick = clock->tick.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (clock->sequence.load(std::memory_order_relaxed) == before) {
+            return state;
+        }
+    }
+}
+
+uint64_t CanBoard::currentTick() const {
+    return simTick_ ? simTick_->load(std::memory_order_relaxed) : 0;
 }
 
 void CanBoard::setTimerEnabled(const std::string& name, bool enabled) {
     std::lock_guard<std::mutex> lock(dataMutex_);
-    for (auto& timer : timers_) {
-        if (timer.name == name) {
-            timer.enabled = enabled;
+    for (uint32_t timer = 0; timer < TIMER_COUNT; ++timer) {
+        if (name == TIMER_NAMES[timer]) {
+            timers_[timer].enabled = enabled;
             break;
         }
     }
@@ -105,59 +439,99 @@ void CanBoard::setTimerEnabled(const std::string& name, bool enabled) {
 
 void CanBoard::initializeTimers() {
     // Encoder reading timer
-    timers_.push_back({
-        "encoder_read",
-        std::chrono::microseconds(static_cast<long>(1000000.0 / ENCODER_READ_FREQUENCY)),
-        [this]() { encoderReadTimer(); },
+    timers_[ENCODER_READ] = {
+        std::chrono::microseconds(static_cast<long>(1000000.0 / timerRates_.encoderReadHz)),
+        &CanBoard::encoderReadTimer,
         true
-    });
+    };
 
     // Control signal update timer
-    timers_.push_back({
-        "control_update",
-        std::chrono::microseconds(static_cast<long>(1000000.0 / CONTROL_UPDATE_FREQUENCY)),
-        [this]() { controlUpdateTimer(); },
+    timers_[CONTROL_UPDATE] = {
+        std::chrono::microseconds(static_cast<long>(1000000.0 / timerRates_.controlUpdateHz)),
+        &CanBoard::controlUpdateTimer,
         true
-    });
+    };
 
     // CAN transmission timer
-    timers_.push_back({
-        "can_transmit",
-        std::chrono::microseconds(static_cast<long>(1000000.0 / CAN_TRANSMIT_FREQUENCY)),
-        [this]() { canTransmitTimer(); },
+    timers_[CAN_TRANSMIT] = {
+        std::chrono::microseconds(static_cast<long>(1000000.0 / timerRates_.canTransmitHz)),
+        &CanBoard::canTransmitTimer,
         true
-    });
+    };
 }
 
-void CanBoard::timerLoop(const TimerConfig& config) {
-    auto next_execution = std::chrono::steady_clock::now();
-
-    while (running_) {
-        config.callback();
-        next_execution += config.period;
-        std::this_thread::sleep_until(next_execution);
-    }
+void CanBoard::runTimer(uint32_t timer) {
+    TraceSpan span(TIMER_NAMES[timer], can_id_);
+    CpuScope cpu(timersCpu_);
+    HotPath hot_path;
+    (this->*timers_[timer].callback)();
 }
 
 void CanBoard::encoderReadTimer() {
-    cachedEncoderSteps_ = servo_.getEncoder().getPositionSteps();
+    LatchedStatus observed = observeServo();
+    long encoder_steps = observed.encoderSteps;
+    storeLatch(encoder_steps, observed.velocity, observed.tick);
+
+    if (velocityEstimator_.isEnabled()) {
+        velocityEstimator_.update(encoder_steps);
+        estimatedSpeed_.store(velocityEstimator_.getSpeedRPMx100(), std::memory_order_relaxed);
+    }
 }
 
 void CanBoard::controlUpdateTimer() {
-    if (currentControlSignal_ == 1 || currentControlSignal_ == -1) {
-        servo_.setControlSignal(0);
+    if (holdState_.load(std::memory_order_acquire) != HOLD_OFF) {
+        // Applied by the hold loop, not timed; a command releasing the hold since keeps its timestamp
+        int64_t received_ns = commandReceivedNs_.load(std::memory_order_relaxed);
+        if (received_ns != 0 && holdState_.load(std::memory_order_acquire) != HOLD_OFF) {
+            commandReceivedNs_.compare_exchange_strong(received_ns, 0, std::memory_order_relaxed);
+        }
+        return; // The position-hold loop owns the control signal
+    }
+
+    // 1 and -1 mean stop without position hold
+    int control_signal = currentControlSignal_;
+    control_signal = control_signal == 1 || control_signal == -1 ? 0 : control_signal;
+    if (simTick_) {
+        pendingControl_.store(control_signal, std::memory_order_release); // Applied at the next tick boundary
         return;
     }
 
-    servo_.setControlSignal(currentControlSignal_);
+    servo_->setControlSignal(control_signal);
+    int64_t received_ns = commandReceivedNs_.load(std::memory_order_relaxed);
+    if (received_ns != 0 && commandReceivedNs_.compare_exchange_strong(received_ns, 0, std::memory_order_relaxed)) {
+        commandApplyLatency_.observe(static_cast<uint64_t>(Metrics::nowNs() - received_ns));
+    }
 }
 
 void CanBoard::canTransmitTimer() {
-    if (!can_socket_->isOpen()) {
-        std::cout << "CAN socket is not open" << std::endl;
+    if (!transport_->isOpen()) {
+        LOG_WARNING("CanBoard[0x%x]: CAN socket is not open", can_id_);
         return; // CAN not available
     }
 
+    LatchedStatus latched = loadLatch();
+    long cached_steps = latched.encoderSteps;
+    int control_signal = currentControlSignal_.load();
+    int16_t speed_scaled = velocityEstimator_.isEnabled()
+        ? static_cast<int16_t>(estimatedSpeed_.load(std::memory_order_relaxed))
+        : scaleSpeed(latched.velocity);
+
+    if (transmitPolicy_.mode == TransmitPolicy::Mode::OnChange) {
+        auto now = std::chrono::steady_clock::now();
+        if (!statusChanged(cached_steps, speed_scaled, control_signal, now)) {
+            return; // Nothing moved beyond the deadbands and no heartbeat due
+        }
+        lastSentTime_ = now;
+    }
+    lastSentEncoderSteps_ = cached_steps;
+    lastSentSpeed_ = speed_scaled;
+    lastSentControlSignal_ = control_signal;
+    statusSent_ = true;
+
+    sendStatusFrame(cached_steps, speed_scaled, control_signal, latched.tick);
+}
+
+void CanBoard::sendStatusFrame(long encoder_steps, int16_t speed_scaled, int control_signal, uint64_t latched_tick) {
     // Create CAN frame using Linux can_frame structure
     struct can_frame frame;
     frame.can_id = can_id_;
@@ -168,25 +542,97 @@ void CanBoard::canTransmitTimer() {
 
     // Encoder position (16-bit unsigned)
     // Convert encoder steps to a 16-bit value (scale down if necessary)
-    uint32_t encoder_steps = static_cast<uint32_t>(std::abs(cachedEncoderSteps_.load()));
-    uint16_t encoder_16bit = static_cast<uint16_t>(encoder_steps & 0xFFFF);
+    uint32_t encoder_abs = static_cast<uint32_t>(std::abs(encoder_steps));
+    uint16_t encoder_16bit = static_cast<uint16_t>(encoder_abs & 0xFFFF);
     frame.data[1] = (encoder_16bit >> 8) & 0xFF;  // ENCODER_H
     frame.data[2] = encoder_16bit & 0xFF;         // ENCODER_L
 
     // Speed in RPM * 100 (16-bit signed)
-    double velocity_rad_s = servo_.getAngularVelocity(); // TODO: replace with calculated speed from encoder readings
-    double velocity_rpm = velocity_rad_s * (60.0 / (2.0 * M_PI));
-    int16_t speed_scaled = static_cast<int16_t>(velocity_rpm * 100.0);
     frame.data[3] = (speed_scaled >> 8) & 0xFF;   // SPEED_H
     frame.data[4] = speed_scaled & 0xFF;          // SPEED_L
 
     // Effort (8-bit signed, -100 to +100)
-    frame.data[5] = static_cast<uint8_t>(currentControlSignal_.load());
+    frame.data[5] = static_cast<uint8_t>(control_signal);
+
+    transmitFrame(frame);
+
+    if (transmitPolicy_.timestamped) {
+        sendTimestampFrame(latched_tick);
+    }
+}
+
+void CanBoard::sendTimestampFrame(uint64_t latched_tick) {
+    struct can_frame frame;
+    frame.can_id = can_id_;
+    frame.can_dlc = 8;
+
+    // Message type
+    frame.data[0] = 0x14;
+
+    // Physics tick at which the encoder was latched (low 32 bits, big endian)
+    uint32_t tick_32bit = static_cast<uint32_t>(latched_tick);
+    frame.data[1] = (tick_32bit >> 24) & 0xFF;
+    frame.data[2] = (tick_32bit >> 16) & 0xFF;
+    frame.data[3] = (tick_32bit >> 8) & 0xFF;
+    frame.data[4] = tick_32bit & 0xFF;
+
+    // Age of the latched state at transmit in simulated microseconds (24-bit, saturating)
+    uint64_t now_tick = currentTick();
+    uint64_t age_ticks = now_tick > latched_tick ? now_tick - latched_tick : 0;
+    uint32_t age_us = static_cast<uint32_t>(std::min(age_ticks * tickPeriodUs_, 16777215.0));
+    frame.data[5] = (age_us >> 16) & 0xFF;
+    frame.data[6] = (age_us >> 8) & 0xFF;
+    frame.data[7] = age_us & 0xFF;
+
+    transmitFrame(frame);
+}
 
-    can_socket_->sendFrame(frame);
+void CanBoard::transmitFrame(const struct can_frame& frame) {
+    bool sent = can_bus_ ? can_bus_->submit(frame, *transport_) : transport_->sendFrame(frame);
+    (sent ? framesTx_ : sendFailures_).add();
+}
+
+int16_t CanBoard::scaleSpeed(double velocity_rad_s) {
+    double velocity_rpm = velocity_rad_s * (60.0 / (2.0 * M_PI));
+    return static_cast<int16_t>(velocity_rpm * 100.0);
+}
+
+bool CanBoard::statusChanged(long encoder_steps, int16_t speed_scaled, int control_signal,
+                             std::chrono::steady_clock::time_point now) const {
+    if (!statusSent_ || now - lastSentTime_ >= transmitPolicy_.maxInterval) {
+        return true; // First frame or heartbeat
+    }
+
+    if (control_signal != lastSentControlSignal_) {
+        return true;
+    }
+
+    // Shortest distance around the encoder's wraparound point
+    long max_steps = servo_->getEncoder().getMaxSteps();
+    long position_change = std::abs(encoder_steps - lastSentEncoderSteps_) % max_steps;
+    position_change = std::min(position_change, max_steps - position_change);
+    if (position_change > transmitPolicy_.positionDeadbandSteps) {
+        return true;
+    }
+
+    long velocity_deadband = static_cast<long>(transmitPolicy_.velocityDeadbandRPM * 100.0);
+    return std::abs(static_cast<long>(speed_scaled) - lastSentSpeed_) > velocity_deadband;
+}
+
+void CanBoard::onBusFrame(const struct can_frame& frame) {
+    CpuScope cpu(receiveCpu_);
+    onCanFrameReceived(frame);
 }
 
 void CanBoard::onCanFrameReceived(const struct can_frame& frame) {
+    framesRx_.add();
+
+    // SYNC carries no payload (or an optional counter), handle it before the message type
+    if (syncGroup_ && (frame.can_id & CAN_SFF_MASK) == syncGroup_->getSyncId()) {
+        syncGroup_->requestSync();
+        return;
+    }
+
     if (frame.can_dlc < 1) {
         return;
     }
@@ -196,23 +642,29 @@ void CanBoard::onCanFrameReceived(const struct can_frame& frame) {
     switch (message_type) {
         case 0x10: // Effort command
             if (frame.can_dlc == 2) {
+                commandReceivedNs_.store(Metrics::nowNs(), std::memory_order_relaxed);
                 int8_t new_control = static_cast<int8_t>(frame.data[1]);
-                if (new_control == 1 || new_control == -1) { // Stop without position hold
-                    setControlSignal(1);
-
-                } else if (new_control == 0) { // Stop with position hold
-                    setControlSignal(0); // TODO: replace with position hold logic
+                if (new_control == 0) { // Stop with position hold
+                    setControlSignal(0);
+                    int off = HOLD_OFF;
+                    if (holdDivider_.load(std::memory_order_relaxed) > 0) {
+                        holdState_.compare_exchange_strong(off, HOLD_REQUESTED, std::memory_order_acq_rel);
+                    }
                 } else {
-                    setControlSignal(new_control);
+                    releaseHold();
+                    if (new_control == 1 || new_control == -1) { // Stop without position hold
+                        setControlSignal(1);
+                    } else {
+                        setControlSignal(new_control);
+                    }
                 }
             }
             break;
 
         default:
             // Unknown message type, ignore
-            std::cout << "CanBoard[0x" << std::hex << can_id_ << std::dec
-                    << "]: Unknown message type 0x" << std::hex << static_cast<int>(message_type)
-                    << std::dec << std::endl;
+            unknownMessages_.add();
+            LOG_WARNING("CanBoard[0x%x]: Unknown message type 0x%x", can_id_, static_cast<unsigned>(message_type));
             break;
     }
 }
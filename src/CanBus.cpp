@@ -0,0 +1,301 @@
+#include "CanBus.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// CRC delimiter, ACK slot, ACK delimiter, EOF and intermission are never stuffed
+constexpr uint32_t FRAME_TAIL_BITS = 1 + 1 + 1 + 7 + 3;
+
+// Longest stuffable section: extended header (39 bits) + 64 data bits + CRC-15
+constexpr uint32_t MAX_STUFFABLE_BITS = 39 + 64 + 15;
+
+constexpr uint16_t CAN_CRC15_POLYNOMIAL = 0x4599;
+
+struct BitStream {
+    uint8_t bits[MAX_STUFFABLE_BITS];
+    uint32_t count = 0;
+
+    void push(uint32_t value, int width) {
+        for (int i = width - 1; i >= 0; --i) {
+            bits[count++] = static_cast<uint8_t>((value >> i) & 1U);
+        }
+    }
+};
+
+uint16_t crc15(const uint8_t* bits, uint32_t count) {
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        bool crc_next = (bits[i] ^ (crc >> 14)) & 1U;
+        crc = static_cast<uint16_t>((crc << 1) & 0x7FFF);
+        if (crc_next) {
+            crc ^= CAN_CRC15_POLYNOMIAL;
+        }
+    }
+    return crc;
+}
+
+} // namespace
+
+CanBus::CanBus(const std::string& name, uint32_t bitrate)
+    : name_(name), bitrate_(bitrate), nanoseconds_per_bit_(1e9 / static_cast<double>(bitrate)),
+      next_sequence_(0), running_(false), sending_(nullptr), busy_time_(Clock::duration::zero()),
+      total_queue_delay_(Clock::duration::zero()), max_queue_delay_(Clock::duration::zero()),
+      frames_(0), bits_(0), stuff_bits_(0), max_pending_(0), overflows_(0) {
+    // Reserve up front so steady-state submits never reallocate
+    pending_.reserve(MAX_PENDING_FRAMES);
+
+    std::string labels = "bus=\"" + name_ + "\"";
+    frames_metric_ = MetricCounter("motor_sim_bus_frames_total", "Frames put on the modeled bus", labels);
+    pending_metric_ = MetricGauge("motor_sim_bus_pending_frames", "Frames waiting for arbitration", labels);
+    queue_delay_metric_ = MetricHistogram("motor_sim_bus_queue_delay_seconds",
+                                          "Submit to start of transmission on the modeled bus", labels);
+    overflows_metric_ = MetricCounter("motor_sim_bus_tx_overflows_total",
+                                      "Frames refused because the modeled bus queue was full", labels);
+}
+
+CanBus::~CanBus() {
+    stop();
+}
+
+void CanBus::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+
+    started_at_ = Clock::now();
+    running_ = true;
+    bus_thread_ = std::thread(&CanBus::busLoop, this);
+}
+
+void CanBus::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    pending_cv_.notify_all();
+
+    if (bus_thread_.joinable()) {
+        bus_thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+}
+
+bool CanBus::isRunning() const {
+    return running_;
+}
+
+bool CanBus::submit(const struct can_frame& frame, CanTransport& transport) {
+    return enqueue(frame, &transport, nullptr);
+}
+
+bool CanBus::receive(const struct can_frame& frame, Receiver& receiver) {
+    return enqueue(frame, nullptr, &receiver);
+}
+
+bool CanBus::enqueue(const struct can_frame& frame, CanTransport* transport, Receiver* receiver) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        if (pending_.size() >= MAX_PENDING_FRAMES) {
+            ++overflows_;
+            overflows_metric_.add();
+            return false;
+        }
+
+        pending_.push_back({frame, transport, receiver, Clock::now(), arbitrationKey(frame), next_sequence_++});
+        std::push_heap(pending_.begin(), pending_.end(), LowerPriority());
+        max_pending_ = std::max(max_pending_, pending_.size());
+        pending_metric_.set(static_cast<double>(pending_.size()));
+    }
+    pending_cv_.notify_one();
+    return true;
+}
+
+void CanBus::detach(CanTransport& transport) {
+    detachTarget(&transport);
+}
+
+void CanBus::detach(Receiver& receiver) {
+    detachTarget(&receiver);
+}
+
+void CanBus::detachTarget(const void* target) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                  [target](const PendingFrame& pending) {
+                                      return pending.transport == target || pending.receiver == target;
+                                  }),
+                   pending_.end());
+    std::make_heap(pending_.begin(), pending_.end(), LowerPriority());
+    pending_metric_.set(static_cast<double>(pending_.size()));
+
+    sent_cv_.wait(lock, [this, target]() { return sending_ != target; });
+}
+
+const std::string& CanBus::getName() const {
+    return name_;
+}
+
+uint32_t CanBus::getBitrate() const {
+    return bitrate_;
+}
+
+CanBus::Statistics CanBus::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Statistics stats;
+    stats.frames = frames_;
+    stats.bits = bits_;
+    stats.stuffBits = stuff_bits_;
+    stats.maxPending = max_pending_;
+    stats.overflows = overflows_;
+
+    auto elapsed = Clock::now() - started_at_;
+    if (elapsed.count() > 0) {
+        stats.utilization = std::min(1.0, static_cast<double>(busy_time_.count()) / elapsed.count());
+    }
+    if (frames_ > 0) {
+        stats.meanQueueDelayUs = std::chrono::duration<double, std::micro>(total_queue_delay_).count() / frames_;
+    }
+    stats.maxQueueDelayUs = std::chrono::duration<double, std::micro>(max_queue_delay_).count();
+    return stats;
+}
+
+uint32_t CanBus::frameBitCount(const struct can_frame& frame, uint32_t* stuff_bits) {
+    const bool extended = frame.can_id & CAN_EFF_FLAG;
+    const bool remote = frame.can_id & CAN_RTR_FLAG;
+    const uint32_t dlc = std::min<uint32_t>(frame.can_dlc, CAN_MAX_DLEN);
+
+    BitStream stream;
+    stream.push(0, 1); // SOF
+    if (extended) {
+        uint32_t id = frame.can_id & CAN_EFF_MASK;
+        stream.push(id >> 18, 11);   // Base ID
+        stream.push(1, 1);           // SRR
+        stream.push(1, 1);           // IDE
+        stream.push(id & 0x3FFFF, 18);
+        stream.push(remote, 1);      // RTR
+        stream.push(0, 2);           // r1, r0
+    } else {
+        stream.push(frame.can_id & CAN_SFF_MASK, 11);
+        stream.push(remote, 1);      // RTR
+        stream.push(0, 2);           // IDE, r0
+    }
+    stream.push(dlc, 4);
+    if (!remote) {
+        for (uint32_t i = 0; i < dlc; ++i) {
+            stream.push(frame.data[i], 8);
+        }
+    }
+    stream.push(crc15(stream.bits, stream.count), 15);
+
+    // A stuff bit of opposite polarity follows every run of five identical bits,
+    // and itself counts towards the next run
+    uint32_t stuffed = 0;
+    uint32_t run = 0;
+    uint8_t last = 2;
+    for (uint32_t i = 0; i < stream.count; ++i) {
+        if (stream.bits[i] == last) {
+            ++run;
+        } else {
+            last = stream.bits[i];
+            run = 1;
+        }
+        if (run == 5) {
+            ++stuffed;
+            last = static_cast<uint8_t>(!last);
+            run = 1;
+        }
+    }
+
+    if (stuff_bits) {
+        *stuff_bits = stuffed;
+    }
+    return stream.count + stuffed + FRAME_TAIL_BITS;
+}
+
+uint32_t CanBus::arbitrationKey(const struct can_frame& frame) {
+    // Mirrors the on-wire arbitration field: base ID, then RTR/SRR, then IDE,
+    // then the extended ID bits and extended RTR. Dominant (0) bits win.
+    const bool remote = frame.can_id & CAN_RTR_FLAG;
+    if (frame.can_id & CAN_EFF_FLAG) {
+        uint32_t id = frame.can_id & CAN_EFF_MASK;
+        return ((id >> 18) << 21) | (1U << 20) | (1U << 19) | ((id & 0x3FFFF) << 1) | (remote ? 1U : 0U);
+    }
+    return ((frame.can_id & CAN_SFF_MASK) << 21) | (remote ? 1U << 20 : 0U);
+}
+
+void CanBus::busLoop() {
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
+    std::unique_lock<std::mutex> lock(mutex_);
+    Clock::time_point bus_free_at = Clock::now();
+
+    while (running_) {
+        pending_cv_.wait(lock, [this]() { return !running_ || !pending_.empty(); });
+        if (!running_) {
+            break;
+        }
+
+        // Frames submitted while the previous frame is on the wire join the next arbitration round
+        if (bus_free_at > Clock::now()) {
+            pending_cv_.wait_until(lock, bus_free_at, [this]() { return !running_.load(); });
+            if (!running_) {
+                break;
+            }
+        }
+
+        std::pop_heap(pending_.begin(), pending_.end(), LowerPriority());
+        PendingFrame winner = pending_.back();
+        pending_.pop_back();
+
+        uint32_t stuff_bits = 0;
+        uint32_t bits = frameBitCount(winner.frame, &stuff_bits);
+        auto duration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds(std::llround(bits * nanoseconds_per_bit_)));
+
+        // Keep the modeled timeline exact even if this thread wakes up late
+        Clock::time_point start = std::max(bus_free_at, winner.submitted);
+        Clock::time_point end = start + duration;
+        bus_free_at = end;
+
+        auto queue_delay = start - winner.submitted;
+        ++frames_;
+        bits_ += bits;
+        stuff_bits_ += stuff_bits;
+        busy_time_ += duration;
+        total_queue_delay_ += queue_delay;
+        max_queue_delay_ = std::max(max_queue_delay_, queue_delay);
+        frames_metric_.add();
+        pending_metric_.set(static_cast<double>(pending_.size()));
+        queue_delay_metric_.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(queue_delay).count()));
+
+        // detach() waits for this hand-over, so the transport stays open (and the
+        // receiver alive) until it returns
+        sending_ = winner.transport ? static_cast<const void*>(winner.transport) : winner.receiver;
+        lock.unlock();
+        std::this_thread::sleep_until(end);
+        if (winner.receiver) {
+            HotPath hot_path;
+            winner.receiver->onBusFrame(winner.frame);
+        } else if (winner.transport->isOpen()) {
+            HotPath hot_path;
+            winner.transport->sendFrame(winner.frame);
+        }
+        lock.lock();
+        sending_ = nullptr;
+        sent_cv_.notify_all();
+    }
+}
@@ -0,0 +1,410 @@
+#include "CanIoUring.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+struct CanIoUring::Client {
+    int fd;
+    FrameHandler onFrame;
+    SendHandler onSend;
+    bool armed = false;         // A receive is (or is about to be) in flight
+    bool removing = false;
+    unsigned inflight = 0;      // Sends queued or in flight
+};
+
+namespace {
+
+// Low bits of user_data tell completions apart; clients are at least 8-byte aligned
+constexpr uint64_t KIND_MASK = 3;
+constexpr uint64_t KIND_RECEIVE = 0;   // Client pointer
+constexpr uint64_t KIND_SEND = 1;      // Send slot << 2
+constexpr uint64_t KIND_WAKE = 2;
+constexpr uint64_t KIND_CANCEL = 3;
+
+constexpr uint16_t BUFFER_GROUP = 0;
+
+int ioUringSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// Multishot receive arrived in 6.0 (provided-buffer rings in 5.19)
+bool kernelSupportsMultishotReceive() {
+    struct utsname name;
+    unsigned major = 0;
+    if (uname(&name) != 0 || std::sscanf(name.release, "%u.", &major) != 1) {
+        return false;
+    }
+    return major >= 6;
+}
+
+} // namespace
+
+CanIoUring* CanIoUring::instance() {
+    static std::unique_ptr<CanIoUring> reactor = [] {
+        std::unique_ptr<CanIoUring> created(new CanIoUring());
+        if (!created->setup()) {
+            created.reset();
+        }
+        return created;
+    }();
+    return reactor.get();
+}
+
+bool CanIoUring::setup() {
+    if (!kernelSupportsMultishotReceive()) {
+        LOG_WARNING("CanIoUring: Linux 6.0 or newer is needed, using a receive thread per socket");
+        return false;
+    }
+
+    struct io_uring_params params = {};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SUBMIT_ALL;
+    params.cq_entries = SQ_ENTRIES * 4; // Multishot receives post many completions per SQE
+    ring_fd_ = ioUringSetup(SQ_ENTRIES, &params);
+    if (ring_fd_ < 0) {
+        LOG_WARNING("CanIoUring: io_uring_setup failed: %s, using a receive thread per socket", std::strerror(errno));
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        LOG_WARNING("CanIoUring: Kernel io_uring lacks needed features, using a receive thread per socket");
+        return false;
+    }
+
+    // Submission and completion rings share one mapping
+    ring_size_ = std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                                  params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+    ring_memory_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                        IORING_OFF_SQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQES);
+    if (ring_memory_ == MAP_FAILED || sqes == MAP_FAILED) {
+        ring_memory_ = ring_memory_ == MAP_FAILED ? nullptr : ring_memory_;
+        sqes_ = sqes == MAP_FAILED ? nullptr : static_cast<struct io_uring_sqe*>(sqes);
+        LOG_WARNING("CanIoUring: Cannot map rings: %s, using a receive thread per socket", std::strerror(errno));
+        return false;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    char* base = static_cast<char*>(ring_memory_);
+    sq_head_ = reinterpret_cast<uint32_t*>(base + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<uint32_t*>(base + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<uint32_t*>(base + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_tail_local_ = *sq_tail_;
+    uint32_t* sq_array = reinterpret_cast<uint32_t*>(base + params.sq_off.array);
+    for (uint32_t i = 0; i < params.sq_entries; ++i) {
+        sq_array[i] = i; // SQE slots are used in ring order
+    }
+    cq_head_ = reinterpret_cast<uint32_t*>(base + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32_t*>(base + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32_t*>(base + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(base + params.cq_off.cqes);
+
+    // Receive buffers, handed to the kernel through a provided-buffer ring
+    void* buffer_ring = mmap(nullptr, RECEIVE_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ring == MAP_FAILED) {
+        LOG_WARNING("CanIoUring: Cannot map buffer ring: %s, using a receive thread per socket", std::strerror(errno));
+        return false;
+    }
+    buffer_ring_ = static_cast<struct io_uring_buf*>(buffer_ring);
+    struct io_uring_buf_reg registration = {};
+    registration.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_);
+    registration.ring_entries = RECEIVE_BUFFERS;
+    registration.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        LOG_WARNING("CanIoUring: Cannot register receive buffers: %s, using a receive thread per socket",
+                    std::strerror(errno));
+        return false;
+    }
+    receive_frames_.resize(RECEIVE_BUFFERS);
+    for (uint32_t buffer = 0; buffer < RECEIVE_BUFFERS; ++buffer) {
+        recycleBuffer(static_cast<uint16_t>(buffer));
+    }
+    __atomic_store_n(&buffer_ring_[0].resv, buffer_tail_, __ATOMIC_RELEASE);
+
+    send_slots_.resize(MAX_OUTSTANDING_SENDS);
+    for (uint32_t slot = MAX_OUTSTANDING_SENDS; slot > 0; --slot) {
+        free_send_slots_.push_back(slot - 1);
+    }
+    // Sends are bounded, so the request queue never grows while sending
+    requests_.reserve(MAX_OUTSTANDING_SENDS);
+
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        LOG_WARNING("CanIoUring: Cannot create eventfd: %s, using a receive thread per socket", std::strerror(errno));
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&CanIoUring::completionLoop, this);
+    LOG_INFO("CanIoUring: Serving CAN sockets from one io_uring completion thread");
+    return true;
+}
+
+CanIoUring::~CanIoUring() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        eventfd_write(wake_fd_, 1);
+        thread_.join();
+    }
+
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+    }
+    if (ring_fd_ >= 0) {
+        close(ring_fd_); // Cancels whatever is still in flight
+    }
+    if (buffer_ring_) {
+        munmap(buffer_ring_, RECEIVE_BUFFERS * sizeof(struct io_uring_buf));
+    }
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (ring_memory_) {
+        munmap(ring_memory_, ring_size_);
+    }
+}
+
+CanIoUring::Client* CanIoUring::addSocket(int fd, FrameHandler on_frame, SendHandler on_send) {
+    auto client = std::make_unique<Client>();
+    client->fd = fd;
+    client->onFrame = std::move(on_frame);
+    client->onSend = std::move(on_send);
+    Client* added = client.get();
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        added->armed = true;
+        clients_.push_back(std::move(client));
+        requests_.push_back({Request::Kind::Arm, added, {}});
+        wake = !wake_posted_;
+        wake_posted_ = true;
+    }
+    if (wake) {
+        eventfd_write(wake_fd_, 1);
+    }
+    return added;
+}
+
+void CanIoUring::removeSocket(Client* client) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    client->removing = true;
+    requests_.push_back({Request::Kind::Cancel, client, {}});
+    bool wake = !wake_posted_;
+    wake_posted_ = true;
+    lock.unlock();
+    if (wake) {
+        eventfd_write(wake_fd_, 1);
+    }
+
+    lock.lock();
+    removed_.wait(lock, [client] { return !client->armed && client->inflight == 0; });
+    clients_.remove_if([client](const std::unique_ptr<Client>& entry) { return entry.get() == client; });
+}
+
+bool CanIoUring::send(Client* client, const struct can_frame& frame) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (outstanding_sends_ >= MAX_OUTSTANDING_SENDS || client->removing) {
+            return false;
+        }
+        ++outstanding_sends_;
+        ++client->inflight;
+        requests_.push_back({Request::Kind::Send, client, frame});
+
+        // One wakeup per batch: later senders find it already posted
+        wake = !wake_posted_;
+        wake_posted_ = true;
+    }
+    if (wake) {
+        eventfd_write(wake_fd_, 1);
+    }
+    return true;
+}
+
+void CanIoUring::completionLoop() {
+    Tracer::nameThread("can io_uring");
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
+    prepareWakeRead();
+
+    std::vector<Request> requests;
+    requests.reserve(MAX_OUTSTANDING_SENDS);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            requests.swap(requests_);
+            wake_posted_ = false;
+        }
+        prepareRequests(requests);
+        requests.clear();
+
+        // Submit the batch and sleep until something completes
+        if (submit(1) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            LOG_ERROR("CanIoUring: io_uring_enter failed: %s", std::strerror(errno));
+        }
+
+        uint32_t head = *cq_head_;
+        uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            handleCompletion(cqes_[head & cq_mask_]);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        __atomic_store_n(&buffer_ring_[0].resv, buffer_tail_, __ATOMIC_RELEASE);
+    }
+}
+
+void CanIoUring::prepareRequests(std::vector<Request>& requests) {
+    for (const Request& request : requests) {
+        switch (request.kind) {
+        case Request::Kind::Arm:
+            prepareReceive(request.client);
+            break;
+
+        case Request::Kind::Send: {
+            // Outstanding sends are capped at the slot count, so a slot is free
+            uint32_t slot = free_send_slots_.back();
+            free_send_slots_.pop_back();
+            send_slots_[slot] = {request.frame, request.client};
+
+            struct io_uring_sqe* sqe = nextSqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = request.client->fd;
+            sqe->addr = reinterpret_cast<uint64_t>(&send_slots_[slot].frame);
+            sqe->len = sizeof(struct can_frame);
+            sqe->user_data = (static_cast<uint64_t>(slot) << 2) | KIND_SEND;
+            break;
+        }
+
+        case Request::Kind::Cancel: {
+            // The receive's final completion (without IORING_CQE_F_MORE) follows
+            struct io_uring_sqe* sqe = nextSqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<uint64_t>(request.client) | KIND_RECEIVE;
+            sqe->user_data = KIND_CANCEL;
+            break;
+        }
+        }
+    }
+}
+
+void CanIoUring::handleCompletion(const struct io_uring_cqe& cqe) {
+    switch (cqe.user_data & KIND_MASK) {
+    case KIND_RECEIVE: {
+        Client* client = reinterpret_cast<Client*>(cqe.user_data & ~KIND_MASK);
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            uint16_t buffer = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            if (cqe.res == sizeof(struct can_frame)) {
+                client->onFrame(receive_frames_[buffer]);
+            }
+            recycleBuffer(buffer);
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            // The multishot receive ended: cancelled, out of buffers, or failed
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!client->removing && (cqe.res >= 0 || cqe.res == -ENOBUFS)) {
+                prepareReceive(client);
+            } else {
+                if (!client->removing) {
+                    LOG_ERROR("CanIoUring: Receive on socket %d failed: %s", client->fd, std::strerror(-cqe.res));
+                }
+                client->armed = false;
+                removed_.notify_all();
+            }
+        }
+        break;
+    }
+
+    case KIND_SEND: {
+        uint32_t slot = static_cast<uint32_t>(cqe.user_data >> 2);
+        Client* client = send_slots_[slot].client;
+        client->onSend(cqe.res);
+        free_send_slots_.push_back(slot);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        --outstanding_sends_;
+        if (--client->inflight == 0 && client->removing) {
+            removed_.notify_all();
+        }
+        break;
+    }
+
+    case KIND_WAKE:
+        prepareWakeRead();
+        break;
+
+    case KIND_CANCEL:
+        break;
+    }
+}
+
+struct io_uring_sqe* CanIoUring::nextSqe() {
+    if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        submit(0); // Full: hand the prepared entries over now
+    }
+    struct io_uring_sqe* sqe = &sqes_[sq_tail_local_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sq_tail_local_;
+    return sqe;
+}
+
+int CanIoUring::submit(unsigned wait_for) {
+    __atomic_store_n(sq_tail_, sq_tail_local_, __ATOMIC_RELEASE);
+    unsigned to_submit = sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    return ioUringEnter(ring_fd_, to_submit, wait_for, wait_for > 0 ? IORING_ENTER_GETEVENTS : 0);
+}
+
+void CanIoUring::prepareReceive(Client* client) {
+    struct io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = client->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = reinterpret_cast<uint64_t>(client) | KIND_RECEIVE;
+}
+
+void CanIoUring::prepareWakeRead() {
+    struct io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&wake_value_);
+    sqe->len = sizeof(wake_value_);
+    sqe->user_data = KIND_WAKE;
+}
+
+void CanIoUring::recycleBuffer(uint16_t buffer) {
+    struct io_uring_buf& entry = buffer_ring_[buffer_tail_ & (RECEIVE_BUFFERS - 1)];
+    entry.addr = reinterpret_cast<uint64_t>(&receive_frames_[buffer]);
+    entry.len = sizeof(struct can_frame);
+    entry.bid = buffer;
+    ++buffer_tail_;
+}
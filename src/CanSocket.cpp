@@ -1,5 +1,6 @@
 #include "CanSocket.h"
-#include <iostream>
+#include "Logger.h"
+#include "Tracer.h"
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -8,8 +9,20 @@
 #include <poll.h>
 #include <errno.h>
 
+std::atomic<CanSocket::IoBackend> CanSocket::io_backend_{CanSocket::IoBackend::Threads};
+
+void CanSocket::setIoBackend(IoBackend backend) {
+    io_backend_ = backend;
+}
+
 CanSocket::CanSocket(const std::string& interface_name)
-    : socket_fd_(-1), interface_name_(interface_name), receiving_(false) {
+    : socket_fd_(-1), interface_name_(interface_name), receiving_(false), uring_client_(nullptr) {
+    std::string labels = "interface=\"" + interface_name_ + "\"";
+    frames_tx_ = MetricCounter("motor_sim_socket_frames_tx_total", "Frames written to SocketCAN", labels);
+    frames_rx_ = MetricCounter("motor_sim_socket_frames_rx_total", "Frames read from SocketCAN", labels);
+    send_failures_ = MetricCounter("motor_sim_socket_send_failures_total", "Failed SocketCAN writes", labels);
+    send_enobufs_ = MetricCounter("motor_sim_socket_send_enobufs_total",
+                                  "SocketCAN writes refused with ENOBUFS (transmit queue full)", labels);
 }
 
 CanSocket::~CanSocket() {
@@ -26,7 +39,7 @@ bool CanSocket::open() {
     // Create socket
     socket_fd_ = socket(PF_CAN, SOCK_RAW, CAN_RAW);
     if (socket_fd_ < 0) {
-        std::cerr << "CanSocket: Failed to create socket: " << getLastError() << std::endl;
+        LOG_ERROR("CanSocket: Failed to create socket: %s", getLastError().c_str());
         return false;
     }
 
@@ -36,7 +49,7 @@ bool CanSocket::open() {
     ifr.ifr_name[IFNAMSIZ - 1] = '\0';
 
     if (ioctl(socket_fd_, SIOCGIFINDEX, &ifr) < 0) {
-        std::cerr << "CanSocket: Interface " << interface_name_ << " not found: " << getLastError() << std::endl;
+        LOG_ERROR("CanSocket: Interface %s not found: %s", interface_name_.c_str(), getLastError().c_str());
         ::close(socket_fd_);
         socket_fd_ = -1;
         return false;
@@ -48,7 +61,7 @@ bool CanSocket::open() {
     addr.can_ifindex = ifr.ifr_ifindex;
 
     if (bind(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        std::cerr << "CanSocket: Failed to bind to interface " << interface_name_ << ": " << getLastError() << std::endl;
+        LOG_ERROR("CanSocket: Failed to bind to interface %s: %s", interface_name_.c_str(), getLastError().c_str());
         ::close(socket_fd_);
         socket_fd_ = -1;
         return false;
@@ -73,21 +86,37 @@ bool CanSocket::isOpen() const {
 }
 
 bool CanSocket::sendFrame(const struct can_frame& frame) {
+    TraceSpan span("sendFrame", frame.can_id & CAN_EFF_MASK);
     int fd;
     {
         std::lock_guard<std::mutex> lock(socket_mutex_);
         if (socket_fd_ < 0) {
-            std::cerr << "CanSocket: Socket not open" << std::endl;
+            LOG_ERROR("CanSocket: Socket not open");
             return false;
         }
         fd = socket_fd_;
+
+        // Queued for the reactor's next batch; counted when the write completes
+        if (uring_client_) {
+            if (!CanIoUring::instance()->send(uring_client_, frame)) {
+                send_failures_.add();
+                LOG_ERROR("CanSocket: io_uring send queue full, frame dropped");
+                return false;
+            }
+            return true;
+        }
     }
 
     ssize_t bytes_sent = write(fd, &frame, sizeof(frame));
     if (bytes_sent != sizeof(frame)) {
-        std::cerr << "CanSocket: Failed to send frame: " << getLastError() << std::endl;
+        send_failures_.add();
+        if (errno == ENOBUFS) {
+            send_enobufs_.add();
+        }
+        LOG_ERROR("CanSocket: Failed to send frame: %s", getLastError().c_str());
         return false;
     }
+    frames_tx_.add();
 
     return true;
 }
@@ -98,13 +127,21 @@ bool CanSocket::startReceiving(ReceiveCallback callback) {
     }
 
     if (!isOpen()) {
-        std::cerr << "CanSocket: Cannot start receiving, socket not open" << std::endl;
+        LOG_ERROR("CanSocket: Cannot start receiving, socket not open");
         return false;
     }
 
     receive_callback_ = callback;
     receiving_ = true;
-    receive_thread_ = std::thread(&CanSocket::receiveLoop, this);
+
+    CanIoUring* reactor = io_backend_ == IoBackend::IoUring ? CanIoUring::instance() : nullptr;
+    if (reactor) {
+        std::lock_guard<std::mutex> lock(socket_mutex_);
+        uring_client_ = reactor->addSocket(socket_fd_, [this](const struct can_frame& frame) { deliverFrame(frame); },
+                                           [this](int result) { onSendResult(result); });
+    } else {
+        receive_thread_ = std::thread(&CanSocket::receiveLoop, this);
+    }
 
     return true;
 }
@@ -116,6 +153,17 @@ void CanSocket::stopReceiving() {
 
     receiving_ = false;
 
+    // Senders check uring_client_ under the mutex, so none can still be using it
+    CanIoUring::Client* client;
+    {
+        std::lock_guard<std::mutex> lock(socket_mutex_);
+        client = uring_client_;
+        uring_client_ = nullptr;
+    }
+    if (client) {
+        CanIoUring::instance()->removeSocket(client);
+    }
+
     if (receive_thread_.joinable()) {
         receive_thread_.join();
     }
@@ -163,13 +211,13 @@ bool CanSocket::setFilters(const struct can_filter* filters, size_t filter_count
     std::lock_guard<std::mutex> lock(socket_mutex_);
 
     if (socket_fd_ < 0) {
-        std::cerr << "CanSocket: Socket not open" << std::endl;
+        LOG_ERROR("CanSocket: Socket not open");
         return false;
     }
 
     if (setsockopt(socket_fd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters,
                    filter_count * sizeof(struct can_filter)) < 0) {
-        std::cerr << "CanSocket: Failed to set filters: " << getLastError() << std::endl;
+        LOG_ERROR("CanSocket: Failed to set filters: %s", getLastError().c_str());
         return false;
     }
 
@@ -177,17 +225,38 @@ bool CanSocket::setFilters(const struct can_filter* filters, size_t filter_count
 }
 
 void CanSocket::receiveLoop() {
+    Tracer::nameThread("can rx " + interface_name_);
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
     while (receiving_) {
         struct can_frame frame;
 
         if (receiveFrame(frame, 10)) {
-            if (receive_callback_ && receiving_) {
-                receive_callback_(frame);
-            }
+            deliverFrame(frame);
         }
     }
 }
 
+void CanSocket::deliverFrame(const struct can_frame& frame) {
+    frames_rx_.add();
+    if (receive_callback_ && receiving_) {
+        TraceSpan span("receive", frame.can_id & CAN_EFF_MASK);
+        receive_callback_(frame);
+    }
+}
+
+void CanSocket::onSendResult(int result) {
+    if (result == sizeof(struct can_frame)) {
+        frames_tx_.add();
+        return;
+    }
+    send_failures_.add();
+    if (result == -ENOBUFS) {
+        send_enobufs_.add();
+    }
+    LOG_ERROR("CanSocket: Failed to send frame: %s", std::strerror(result < 0 ? -result : EIO));
+}
+
 std::string CanSocket::getLastError() const {
     return std::strerror(errno);
 }
\ No newline at end of file
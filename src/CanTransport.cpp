@@ -0,0 +1,14 @@
+#include "CanTransport.h"
+#include "CanSocket.h"
+#include "LoopbackTransport.h"
+#include "ShmTransport.h"
+
+std::unique_ptr<CanTransport> CanTransport::create(const std::string& interface_name) {
+    if (LoopbackTransport::isLoopbackInterface(interface_name)) {
+        return std::make_unique<LoopbackTransport>(interface_name);
+    }
+    if (ShmTransport::isShmInterface(interface_name)) {
+        return std::make_unique<ShmTransport>(interface_name);
+    }
+    return std::make_unique<CanSocket>(interface_name);
+}
@@ -7,19 +7,11 @@
 std::vector<ServoConfig> ConfigLoader::loadFromFile(const std::string& filename) {
     std::vector<ServoConfig> configs;
     
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "ConfigLoader: Cannot open file: " << filename << std::endl;
+    std::string json_content = readFile(filename);
+    if (json_content.empty()) {
         return configs;
     }
     
-    std::string json_content;
-    std::string line;
-    while (std::getline(file, line)) {
-        json_content += line + "\n";
-    }
-    file.close();
-    
     // Parse JSON array of servo objects
     std::vector<std::string> servo_objects = splitJsonObjects(json_content);
     
@@ -34,6 +26,41 @@ std::vector<ServoConfig> ConfigLoader::loadFromFile(const std::string& filename)
         parseJsonValue(servo_json, "encoderDirectionInverted", config.encoderDirectionInverted);
         parseJsonValue(servo_json, "canId", config.canId);
         parseJsonValue(servo_json, "canInterface", config.canInterface);
+        parseJsonValue(servo_json, "canBitrate", config.canBitrate);
+        parseJsonValue(servo_json, "transmitMode", config.transmitMode);
+        parseJsonValue(servo_json, "positionDeadbandSteps", config.positionDeadbandSteps);
+        parseJsonValue(servo_json, "velocityDeadbandRPM", config.velocityDeadbandRPM);
+        parseJsonValue(servo_json, "minTransmitIntervalMs", config.minTransmitIntervalMs);
+        parseJsonValue(servo_json, "maxTransmitIntervalMs", config.maxTransmitIntervalMs);
+        parseJsonValue(servo_json, "timestampedStatus", config.timestampedStatus);
+        parseJsonValue(servo_json, "velocityEstimator", config.velocityEstimator);
+        parseJsonValue(servo_json, "velocityAverageWindow", config.velocityAverageWindow);
+        parseJsonValue(servo_json, "velocityTrackingBandwidthHz", config.velocityTrackingBandwidthHz);
+        parseJsonValue(servo_json, "holdRateHz", config.holdRateHz);
+        parseJsonValue(servo_json, "holdKp", config.holdKp);
+        parseJsonValue(servo_json, "holdKi", config.holdKi);
+        parseJsonValue(servo_json, "holdKd", config.holdKd);
+        parseJsonValue(servo_json, "fixedPoint", config.fixedPoint);
+        parseJsonValue(servo_json, "motorModel", config.motorModel);
+        parseJsonValue(servo_json, "supplyVoltageV", config.electromechanical.supplyVoltageV);
+        parseJsonValue(servo_json, "resistanceOhm", config.electromechanical.resistanceOhm);
+        parseJsonValue(servo_json, "inductanceH", config.electromechanical.inductanceH);
+        parseJsonValue(servo_json, "torqueConstantNmPerA", config.electromechanical.torqueConstantNmPerA);
+        parseJsonValue(servo_json, "backEmfConstantVsPerRad", config.electromechanical.backEmfConstantVsPerRad);
+        parseJsonValue(servo_json, "inertiaKgM2", config.electromechanical.inertiaKgM2);
+        parseJsonValue(servo_json, "viscousFrictionNms", config.electromechanical.viscousFrictionNms);
+        parseJsonValue(servo_json, "coulombFrictionNm", config.electromechanical.coulombFrictionNm);
+        parseJsonValue(servo_json, "loadTorqueNm", config.electromechanical.loadTorqueNm);
+        parseJsonValue(servo_json, "currentLimitA", config.electromechanical.currentLimitA);
+        parseJsonValue(servo_json, "encoderReadHz", config.encoderReadHz);
+        parseJsonValue(servo_json, "controlUpdateHz", config.controlUpdateHz);
+        parseJsonValue(servo_json, "canTransmitHz", config.canTransmitHz);
+        parseJsonValue(servo_json, "loadProfile", config.loadProfile);
+        parseJsonValue(servo_json, "loadProfileChannel", config.loadProfileChannel);
+        parseJsonValue(servo_json, "loadProfileScale", config.loadProfileScale);
+        parseJsonValue(servo_json, "loadProfileLoop", config.loadProfileLoop);
+        parseJsonValue(servo_json, "loadDampingNms", config.loadDampingNms);
+        parseJsonValue(servo_json, "telemetry", config.telemetry);
         
         configs.push_back(config);
         std::cout << "ConfigLoader: Loaded servo '" << config.name << "' with CAN ID 0x" 
@@ -44,11 +71,119 @@ std::vector<ServoConfig> ConfigLoader::loadFromFile(const std::string& filename)
     return configs;
 }
 
+SimulationConfig ConfigLoader::loadSimulationConfig(const std::string& filename) {
+    SimulationConfig config;
+
+    std::string json_content = readFile(filename);
+    size_t servos_start = json_content.find('[');
+    if (json_content.empty() || servos_start == std::string::npos) {
+        return config;
+    }
+
+    // Only an object-form file has engine settings, and they live outside the servo array
+    size_t object_start = json_content.find('{');
+    if (object_start == std::string::npos || object_start > servos_start) {
+        return config;
+    }
+    size_t servos_end = json_content.rfind(']');
+    std::string top_level = json_content.substr(0, servos_start);
+    if (servos_end != std::string::npos) {
+        top_level += json_content.substr(servos_end + 1);
+    }
+
+    double frequency_hz;
+    if (parseJsonValue(top_level, "simulationFrequencyHz", frequency_hz)) {
+        if (frequency_hz > 0.0) {
+            config.simulationFrequencyHz = frequency_hz;
+        } else {
+            std::cerr << "ConfigLoader: Invalid simulationFrequencyHz " << frequency_hz
+                      << ", using " << config.simulationFrequencyHz << " Hz" << std::endl;
+        }
+    }
+    double accuracy;
+    if (parseJsonValue(top_level, "integrationAccuracy", accuracy)) {
+        config.integrationAccuracy = std::max(0.0, accuracy);
+    }
+    int chain_threads;
+    if (parseJsonValue(top_level, "chainThreads", chain_threads)) {
+        config.chainThreads = static_cast<uint32_t>(std::max(1, chain_threads));
+    }
+    int timer_threads;
+    if (parseJsonValue(top_level, "timerThreads", timer_threads)) {
+        config.timerThreads = static_cast<uint32_t>(std::max(1, timer_threads));
+    }
+    return config;
+}
+
+std::vector<KinematicChain::Config> ConfigLoader::loadChainsFromFile(const std::string& filename) {
+    std::vector<KinematicChain::Config> chains;
+
+    // Chains are optional
+    if (!std::ifstream(filename).good()) {
+        return chains;
+    }
+
+    std::string json_content = readFile(filename);
+    for (const auto& chain_json : splitJsonObjects(json_content)) {
+        KinematicChain::Config chain;
+
+        // Chain-level keys precede the joint array, so joint keys cannot shadow them
+        size_t joints_pos = chain_json.find("\"joints\"");
+        if (joints_pos == std::string::npos) {
+            std::cerr << "ConfigLoader: Chain without \"joints\" in " << filename << ", skipping" << std::endl;
+            continue;
+        }
+        std::string header = chain_json.substr(0, joints_pos);
+        parseJsonValue(header, "name", chain.name);
+        parseJsonValue(header, "gravity", chain.gravity);
+
+        for (const auto& joint_json : splitJsonObjects(chain_json.substr(joints_pos))) {
+            KinematicChain::JointConfig joint;
+            parseJsonValue(joint_json, "servo", joint.servo);
+            parseJsonValue(joint_json, "origin", joint.origin);
+            parseJsonValue(joint_json, "rpy", joint.rpy);
+            parseJsonValue(joint_json, "axis", joint.axis);
+            parseJsonValue(joint_json, "mass", joint.mass);
+            parseJsonValue(joint_json, "com", joint.com);
+            parseJsonValue(joint_json, "inertia", joint.inertia);
+            parseJsonValue(joint_json, "maxTorqueNm", joint.maxTorqueNm);
+            parseJsonValue(joint_json, "velocityGainNms", joint.velocityGainNms);
+            chain.joints.push_back(joint);
+        }
+
+        if (chain.joints.empty() || chain.joints.size() > KinematicChain::MAX_JOINTS) {
+            std::cerr << "ConfigLoader: Chain '" << chain.name << "' needs 1.." << KinematicChain::MAX_JOINTS
+                      << " joints, skipping" << std::endl;
+            continue;
+        }
+        chains.push_back(chain);
+        std::cout << "ConfigLoader: Loaded chain '" << chain.name << "' with " << chain.joints.size()
+                  << " joints" << std::endl;
+    }
+    return chains;
+}
+
+bool ConfigLoader::resolveChainServos(const KinematicChain::Config& chain, const std::vector<ServoConfig>& servos,
+                                      std::vector<size_t>& indices) {
+    indices.clear();
+    for (const auto& joint : chain.joints) {
+        auto servo = std::find_if(servos.begin(), servos.end(),
+                                  [&joint](const ServoConfig& config) { return config.name == joint.servo; });
+        if (servo == servos.end()) {
+            std::cerr << "ConfigLoader: Chain '" << chain.name << "' references unknown servo '"
+                      << joint.servo << "'" << std::endl;
+            return false;
+        }
+        indices.push_back(static_cast<size_t>(servo - servos.begin()));
+    }
+    return true;
+}
+
 std::vector<Servo> ConfigLoader::createServos(const std::vector<ServoConfig>& configs) {
     std::vector<Servo> servos;
     
     for (const auto& config : configs) {
-        auto servo = Servo::builder()
+        auto builder = Servo::builder()
             .maxVelocityRPM(config.maxVelocityRPM)
             .maxControlSignal(config.maxControlSignal)
             .timeConstant(config.timeConstant)
@@ -56,7 +191,20 @@ std::vector<Servo> ConfigLoader::createServos(const std::vector<ServoConfig>& co
             .encoderDirectionInverted(config.encoderDirectionInverted)
             .canId(config.canId)
             .canInterface(config.canInterface)
-            .build();
+            .canBitrate(config.canBitrate)
+            .transmitPolicy(transmitPolicyFromConfig(config))
+            .velocityEstimator(velocityEstimatorFromConfig(config))
+            .positionHold(positionHoldFromConfig(config))
+            .fixedPoint(config.fixedPoint)
+            .timerRates(timerRatesFromConfig(config))
+            .loadDamping(config.loadDampingNms);
+        if (config.motorModel == "electromechanical") {
+            builder.electromechanical(config.electromechanical);
+        } else if (config.motorModel != "firstOrder") {
+            std::cerr << "ConfigLoader: Unknown motorModel '" << config.motorModel
+                      << "' for servo '" << config.name << "', using first-order model" << std::endl;
+        }
+        auto servo = builder.build();
             
         servos.push_back(std::move(servo));
     }
@@ -87,7 +235,42 @@ bool ConfigLoader::saveToFile(const std::vector<ServoConfig>& configs, const std
         file << "    \"encoderBitResolution\": " << config.encoderBitResolution << ",\n";
         file << "    \"encoderDirectionInverted\": " << (config.encoderDirectionInverted ? "true" : "false") << ",\n";
         file << "    \"canId\": " << config.canId << ",\n";
-        file << "    \"canInterface\": \"" << config.canInterface << "\"\n";
+        file << "    \"canInterface\": \"" << config.canInterface << "\",\n";
+        file << "    \"canBitrate\": " << config.canBitrate << ",\n";
+        file << "    \"transmitMode\": \"" << config.transmitMode << "\",\n";
+        file << "    \"positionDeadbandSteps\": " << config.positionDeadbandSteps << ",\n";
+        file << "    \"velocityDeadbandRPM\": " << config.velocityDeadbandRPM << ",\n";
+        file << "    \"minTransmitIntervalMs\": " << config.minTransmitIntervalMs << ",\n";
+        file << "    \"maxTransmitIntervalMs\": " << config.maxTransmitIntervalMs << ",\n";
+        file << "    \"timestampedStatus\": " << (config.timestampedStatus ? "true" : "false") << ",\n";
+        file << "    \"velocityEstimator\": \"" << config.velocityEstimator << "\",\n";
+        file << "    \"velocityAverageWindow\": " << config.velocityAverageWindow << ",\n";
+        file << "    \"velocityTrackingBandwidthHz\": " << config.velocityTrackingBandwidthHz << ",\n";
+        file << "    \"holdRateHz\": " << config.holdRateHz << ",\n";
+        file << "    \"holdKp\": " << config.holdKp << ",\n";
+        file << "    \"holdKi\": " << config.holdKi << ",\n";
+        file << "    \"holdKd\": " << config.holdKd << ",\n";
+        file << "    \"fixedPoint\": " << (config.fixedPoint ? "true" : "false") << ",\n";
+        file << "    \"motorModel\": \"" << config.motorModel << "\",\n";
+        file << "    \"supplyVoltageV\": " << config.electromechanical.supplyVoltageV << ",\n";
+        file << "    \"resistanceOhm\": " << config.electromechanical.resistanceOhm << ",\n";
+        file << "    \"inductanceH\": " << config.electromechanical.inductanceH << ",\n";
+        file << "    \"torqueConstantNmPerA\": " << config.electromechanical.torqueConstantNmPerA << ",\n";
+        file << "    \"backEmfConstantVsPerRad\": " << config.electromechanical.backEmfConstantVsPerRad << ",\n";
+        file << "    \"inertiaKgM2\": " << config.electromechanical.inertiaKgM2 << ",\n";
+        file << "    \"viscousFrictionNms\": " << config.electromechanical.viscousFrictionNms << ",\n";
+        file << "    \"coulombFrictionNm\": " << config.electromechanical.coulombFrictionNm << ",\n";
+        file << "    \"loadTorqueNm\": " << config.electromechanical.loadTorqueNm << ",\n";
+        file << "    \"currentLimitA\": " << config.electromechanical.currentLimitA << ",\n";
+        file << "    \"encoderReadHz\": " << config.encoderReadHz << ",\n";
+        file << "    \"controlUpdateHz\": " << config.controlUpdateHz << ",\n";
+        file << "    \"canTransmitHz\": " << config.canTransmitHz << ",\n";
+        file << "    \"loadProfile\": \"" << config.loadProfile << "\",\n";
+        file << "    \"loadProfileChannel\": " << config.loadProfileChannel << ",\n";
+        file << "    \"loadProfileScale\": " << config.loadProfileScale << ",\n";
+        file << "    \"loadProfileLoop\": " << (config.loadProfileLoop ? "true" : "false") << ",\n";
+        file << "    \"loadDampingNms\": " << config.loadDampingNms << ",\n";
+        file << "    \"telemetry\": " << (config.telemetry ? "true" : "false") << "\n";
         file << "  }";
         if (i < configs.size() - 1) {
             file << ",";
@@ -141,6 +324,15 @@ bool ConfigLoader::parseJsonValue(const std::string& json, const std::string& ke
     return false;
 }
 
+bool ConfigLoader::parseJsonValue(const std::string& json, const std::string& key, long& value) {
+    double temp;
+    if (parseJsonValue(json, key, temp)) {
+        value = static_cast<long>(temp);
+        return true;
+    }
+    return false;
+}
+
 bool ConfigLoader::parseJsonValue(const std::string& json, const std::string& key, bool& value) {
     std::string search = "\"" + key + "\"";
     size_t pos = json.find(search);
@@ -184,6 +376,111 @@ bool ConfigLoader::parseJsonValue(const std::string& json, const std::string& ke
     return true;
 }
 
+bool ConfigLoader::parseJsonValue(const std::string& json, const std::string& key, double (&value)[3]) {
+    std::string search = "\"" + key + "\"";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) return false;
+
+    pos = json.find(':', pos);
+    if (pos == std::string::npos) return false;
+
+    pos = json.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string::npos || json[pos] != '[') return false;
+
+    size_t end = json.find(']', pos);
+    if (end == std::string::npos) return false;
+
+    double parsed[3];
+    std::stringstream elements(json.substr(pos + 1, end - pos - 1));
+    std::string element;
+    int count = 0;
+    while (std::getline(elements, element, ',')) {
+        if (count == 3) return false;
+        try {
+            parsed[count++] = std::stod(trimWhitespace(element));
+        } catch (...) {
+            return false;
+        }
+    }
+    if (count != 3) return false;
+
+    std::copy(parsed, parsed + 3, value);
+    return true;
+}
+
+TransmitPolicy ConfigLoader::transmitPolicyFromConfig(const ServoConfig& config) {
+    TransmitPolicy policy;
+    if (config.transmitMode == "onChange") {
+        policy.mode = TransmitPolicy::Mode::OnChange;
+    } else if (config.transmitMode != "fixed") {
+        std::cerr << "ConfigLoader: Unknown transmitMode '" << config.transmitMode
+                  << "' for servo '" << config.name << "', using fixed rate" << std::endl;
+    }
+    policy.positionDeadbandSteps = config.positionDeadbandSteps;
+    policy.velocityDeadbandRPM = config.velocityDeadbandRPM;
+    policy.minInterval = std::chrono::microseconds(static_cast<long>(config.minTransmitIntervalMs * 1000.0));
+    policy.maxInterval = std::chrono::microseconds(static_cast<long>(config.maxTransmitIntervalMs * 1000.0));
+    policy.timestamped = config.timestampedStatus;
+    return policy;
+}
+
+VelocityEstimator::Config ConfigLoader::velocityEstimatorFromConfig(const ServoConfig& config) {
+    VelocityEstimator::Config estimator;
+    if (config.velocityEstimator == "difference") {
+        estimator.method = VelocityEstimator::Method::FiniteDifference;
+    } else if (config.velocityEstimator == "average") {
+        estimator.method = VelocityEstimator::Method::MovingAverage;
+    } else if (config.velocityEstimator == "tracking") {
+        estimator.method = VelocityEstimator::Method::TrackingLoop;
+    } else if (config.velocityEstimator != "model") {
+        std::cerr << "ConfigLoader: Unknown velocityEstimator '" << config.velocityEstimator
+                  << "' for servo '" << config.name << "', using model velocity" << std::endl;
+    }
+    estimator.averageWindow = config.velocityAverageWindow;
+    estimator.trackingBandwidthHz = config.velocityTrackingBandwidthHz;
+    return estimator;
+}
+
+PositionHold::Config ConfigLoader::positionHoldFromConfig(const ServoConfig& config) {
+    PositionHold::Config hold;
+    hold.rateHz = config.holdRateHz;
+    hold.kp = config.holdKp;
+    hold.ki = config.holdKi;
+    hold.kd = config.holdKd;
+    return hold;
+}
+
+BoardTimerRates ConfigLoader::timerRatesFromConfig(const ServoConfig& config) {
+    BoardTimerRates rates;
+    auto useRate = [&config](const char* key, double value, double& rate) {
+        if (value > 0.0) {
+            rate = value;
+        } else {
+            std::cerr << "ConfigLoader: Invalid " << key << " " << value << " for servo '"
+                      << config.name << "', using " << rate << " Hz" << std::endl;
+        }
+    };
+    useRate("encoderReadHz", config.encoderReadHz, rates.encoderReadHz);
+    useRate("controlUpdateHz", config.controlUpdateHz, rates.controlUpdateHz);
+    useRate("canTransmitHz", config.canTransmitHz, rates.canTransmitHz);
+    return rates;
+}
+
+std::string ConfigLoader::readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "ConfigLoader: Cannot open file: " << filename << std::endl;
+        return "";
+    }
+
+    std::string json_content;
+    std::string line;
+    while (std::getline(file, line)) {
+        json_content += line + "\n";
+    }
+    return json_content;
+}
+
 std::string ConfigLoader::trimWhitespace(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\r\n");
     if (first == std::string::npos) return "";
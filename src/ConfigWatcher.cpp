@@ -0,0 +1,282 @@
+#include "ConfigWatcher.h"
+#include "SimulationEngine.h"
+#include "Logger.h"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+// Servos are identified the way a controller sees them
+std::string servoKey(const ServoConfig& config) {
+    return config.canInterface + "/" + std::to_string(config.canId);
+}
+
+// Settings that need a new Servo object to change
+bool sameModel(const ServoConfig& a, const ServoConfig& b) {
+    const ElectromechanicalModel::Parameters& ea = a.electromechanical;
+    const ElectromechanicalModel::Parameters& eb = b.electromechanical;
+    return a.encoderBitResolution == b.encoderBitResolution &&
+           a.encoderDirectionInverted == b.encoderDirectionInverted && a.canBitrate == b.canBitrate &&
+           a.fixedPoint == b.fixedPoint && a.motorModel == b.motorModel &&
+           ea.supplyVoltageV == eb.supplyVoltageV && ea.resistanceOhm == eb.resistanceOhm &&
+           ea.inductanceH == eb.inductanceH && ea.torqueConstantNmPerA == eb.torqueConstantNmPerA &&
+           ea.backEmfConstantVsPerRad == eb.backEmfConstantVsPerRad && ea.inertiaKgM2 == eb.inertiaKgM2 &&
+           ea.viscousFrictionNms == eb.viscousFrictionNms && ea.coulombFrictionNm == eb.coulombFrictionNm &&
+           ea.loadTorqueNm == eb.loadTorqueNm && ea.currentLimitA == eb.currentLimitA &&
+           a.loadProfile == b.loadProfile && a.loadProfileChannel == b.loadProfileChannel &&
+           a.loadProfileScale == b.loadProfileScale && a.loadProfileLoop == b.loadProfileLoop &&
+           a.telemetry == b.telemetry;
+}
+
+// Read by the physics thread
+bool sameMotor(const ServoConfig& a, const ServoConfig& b) {
+    return a.maxVelocityRPM == b.maxVelocityRPM && a.maxControlSignal == b.maxControlSignal &&
+           a.timeConstant == b.timeConstant && a.loadDampingNms == b.loadDampingNms;
+}
+
+bool sameHold(const ServoConfig& a, const ServoConfig& b) {
+    return a.holdRateHz == b.holdRateHz && a.holdKp == b.holdKp && a.holdKi == b.holdKi && a.holdKd == b.holdKd;
+}
+
+// Read by the board's timer callbacks
+bool sameTimers(const ServoConfig& a, const ServoConfig& b) {
+    return a.encoderReadHz == b.encoderReadHz && a.controlUpdateHz == b.controlUpdateHz &&
+           a.canTransmitHz == b.canTransmitHz && a.transmitMode == b.transmitMode &&
+           a.positionDeadbandSteps == b.positionDeadbandSteps && a.velocityDeadbandRPM == b.velocityDeadbandRPM &&
+           a.minTransmitIntervalMs == b.minTransmitIntervalMs && a.maxTransmitIntervalMs == b.maxTransmitIntervalMs &&
+           a.timestampedStatus == b.timestampedStatus && a.velocityEstimator == b.velocityEstimator &&
+           a.velocityAverageWindow == b.velocityAverageWindow &&
+           a.velocityTrackingBandwidthHz == b.velocityTrackingBandwidthHz;
+}
+
+} // namespace
+
+ConfigWatcher::ConfigWatcher(SimulationEngine& engine, const std::string& path,
+                             const std::vector<ServoConfig>& running)
+    : engine_(engine), path_(path), configs_(running), inotifyFd_(-1), watching_(false),
+      reloads_("motor_sim_config_reloads_total", "Edits of the servo configuration applied while running"),
+      rejectedReloads_("motor_sim_config_reloads_rejected_total",
+                       "Edits of the servo configuration that could not be loaded") {}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start() {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        LOG_ERROR("ConfigWatcher: inotify_init1 failed: %s", std::strerror(errno));
+        return false;
+    }
+
+    std::filesystem::path directory = std::filesystem::path(path_).parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    if (inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_ERROR("ConfigWatcher: Cannot watch %s: %s", directory.c_str(), std::strerror(errno));
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+
+    watching_ = true;
+    thread_ = std::thread(&ConfigWatcher::watchLoop, this);
+    LOG_INFO("ConfigWatcher: Watching %s", path_.c_str());
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    watching_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (inotifyFd_ >= 0) {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+}
+
+void ConfigWatcher::watchLoop() {
+    const std::string file_name = std::filesystem::path(path_).filename().string();
+    alignas(struct inotify_event) char buffer[4096];
+    bool changed = false;
+    auto changed_at = std::chrono::steady_clock::now();
+
+    while (watching_) {
+        // Wake at least every 100 ms to notice stop() and settled writes
+        struct pollfd events = {inotifyFd_, POLLIN, 0};
+        if (poll(&events, 1, 100) > 0) {
+            ssize_t length;
+            while ((length = read(inotifyFd_, buffer, sizeof(buffer))) > 0) {
+                for (char* next = buffer; next < buffer + length;) {
+                    const auto* event = reinterpret_cast<const struct inotify_event*>(next);
+                    if (event->len > 0 && file_name == event->name) {
+                        changed = true;
+                        changed_at = std::chrono::steady_clock::now();
+                    }
+                    next += sizeof(struct inotify_event) + event->len;
+                }
+            }
+        }
+
+        if (changed && std::chrono::steady_clock::now() - changed_at >= std::chrono::milliseconds(SETTLE_MS)) {
+            changed = false;
+            reload();
+        }
+    }
+}
+
+bool ConfigWatcher::reload() {
+    std::vector<ServoConfig> loaded = ConfigLoader::loadFromFile(path_);
+    if (loaded.empty()) {
+        LOG_WARNING("ConfigWatcher: %s has no servos, keeping the running ones", path_.c_str());
+        rejectedReloads_.add();
+        return false;
+    }
+    std::map<std::string, size_t> loaded_by_key;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        if (!loaded_by_key.emplace(servoKey(loaded[i]), i).second) {
+            LOG_WARNING("ConfigWatcher: %s lists CAN ID 0x%x on %s twice, keeping the running servos",
+                        path_.c_str(), static_cast<unsigned>(loaded[i].canId), loaded[i].canInterface.c_str());
+            rejectedReloads_.add();
+            return false;
+        }
+    }
+
+    // Servos missing from the file, or whose model changed, go first; later indices
+    // shift down as they do in the engine
+    std::vector<bool> placed(loaded.size(), false);
+    std::vector<size_t> replacements;       // Positions in loaded, created after removal
+    size_t removed = 0;
+    for (size_t index = configs_.size(); index-- > 0;) {
+        auto found = loaded_by_key.find(servoKey(configs_[index]));
+        if (found != loaded_by_key.end()) {
+            placed[found->second] = true;
+            if (sameModel(configs_[index], loaded[found->second])) {
+                continue;
+            }
+        }
+
+        try {
+            engine_.removeServo(index);
+        } catch (const std::exception& e) {
+            LOG_WARNING("ConfigWatcher: Keeping servo '%s' as it is until restart: %s", configs_[index].name.c_str(),
+                        e.what());
+            continue;
+        }
+        configs_.erase(configs_.begin() + static_cast<std::ptrdiff_t>(index));
+        if (found != loaded_by_key.end()) {
+            replacements.push_back(found->second);
+        } else {
+            ++removed;
+        }
+    }
+
+    // Settings of the remaining servos change in place, together
+    std::vector<size_t> updated;
+    std::vector<ServoConfig> updated_configs;
+    for (size_t index = 0; index < configs_.size(); ++index) {
+        auto found = loaded_by_key.find(servoKey(configs_[index]));
+        if (found == loaded_by_key.end()) {
+            continue; // Removed from the file, but the engine kept it
+        }
+        const ServoConfig& config = loaded[found->second];
+        if (!sameMotor(configs_[index], config) || !sameHold(configs_[index], config) ||
+            !sameTimers(configs_[index], config)) {
+            updated.push_back(index);
+            updated_configs.push_back(config);
+        } else {
+            configs_[index] = config; // At most a new name, or a model change the engine refused
+        }
+    }
+    applySettings(updated, updated_configs);
+
+    // New and replaced servos, in file order
+    size_t added = 0;
+    size_t replaced = 0;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        bool replacement = std::find(replacements.begin(), replacements.end(), i) != replacements.end();
+        if (placed[i] && !replacement) {
+            continue;
+        }
+        const ServoConfig& config = loaded[i];
+        if (!config.loadProfile.empty()) {
+            LOG_WARNING("ConfigWatcher: Servo '%s' plays a load profile, add it with a restart", config.name.c_str());
+            continue;
+        }
+        std::vector<Servo> servos = ConfigLoader::createServos({config});
+        try {
+            engine_.addServo(std::move(servos.front()));
+        } catch (const std::exception& e) {
+            LOG_WARNING("ConfigWatcher: Servo '%s' not added until restart: %s", config.name.c_str(), e.what());
+            continue;
+        }
+        configs_.push_back(config);
+        ++(replacement ? replaced : added);
+    }
+
+    reloads_.add();
+    LOG_INFO("ConfigWatcher: Reloaded %s: %zu updated, %zu added, %zu removed, %zu replaced", path_.c_str(),
+             updated.size(), added, removed, replaced);
+    return true;
+}
+
+void ConfigWatcher::applySettings(const std::vector<size_t>& indices, const std::vector<ServoConfig>& configs) {
+    if (indices.empty()) {
+        return;
+    }
+
+    // Boards whose timer settings change stop their timers meanwhile; every other board keeps its phase
+    std::vector<CanBoard*> paused;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        CanBoard* board = engine_.getServo(indices[i]).getCanBoard();
+        if (board && !sameTimers(configs_[indices[i]], configs[i])) {
+            board->pauseTimers();
+            paused.push_back(board);
+        }
+    }
+
+    engine_.runBetweenTicks([&]() {
+        for (size_t i = 0; i < indices.size(); ++i) {
+            Servo& servo = engine_.getServo(indices[i]);
+            const ServoConfig& running = configs_[indices[i]];
+            const ServoConfig& config = configs[i];
+            CanBoard* board = servo.getCanBoard();
+
+            if (!sameMotor(running, config)) {
+                Motor& motor = servo.getMotor();
+                motor.setMaxAngularVelocity(config.maxVelocityRPM);
+                motor.setMaxControlSignal(config.maxControlSignal);
+                motor.setMotorTimeConstant(config.timeConstant);
+                motor.setLoadDamping(config.loadDampingNms);
+                if (FixedPointModel* fixed_point = servo.getFixedPointModel()) {
+                    fixed_point->reset(); // Derives its coefficients from the motor again
+                }
+            }
+            if (board && (!sameHold(running, config) || running.maxControlSignal != config.maxControlSignal)) {
+                board->setPositionHold(ConfigLoader::positionHoldFromConfig(config));
+            }
+            if (board && !sameTimers(running, config)) {
+                board->setTimerRates(ConfigLoader::timerRatesFromConfig(config));
+                board->setTransmitPolicy(ConfigLoader::transmitPolicyFromConfig(config));
+                board->setVelocityEstimator(ConfigLoader::velocityEstimatorFromConfig(config));
+            }
+        }
+    });
+
+    for (CanBoard* board : paused) {
+        board->resumeTimers();
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        configs_[indices[i]] = configs[i];
+    }
+}
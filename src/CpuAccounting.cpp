@@ -0,0 +1,159 @@
+#include "CpuAccounting.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <map>
+
+std::atomic<bool> CpuAccounting::enabled_{false};
+
+CpuAccounting& CpuAccounting::instance() {
+    static CpuAccounting accounting;
+    return accounting;
+}
+
+CpuAccounting::Account* CpuAccounting::account(const std::string& owner, Activity activity, bool shared) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.emplace_back();
+    entries_.back().owner = owner;
+    entries_.back().activity = activity;
+    entries_.back().account.shared = shared;
+    return &entries_.back().account;
+}
+
+void CpuAccounting::enable(size_t top_n) {
+    if (sampler_running_) {
+        return;
+    }
+    top_n_ = top_n;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.clear();
+        samples_.push_back(takeSample());
+    }
+    enabled_ = true;
+
+    sem_init(&report_request_, 0, 0);
+    sampler_running_ = true;
+    sampler_ = std::thread(&CpuAccounting::samplerLoop, this);
+
+    struct sigaction action = {};
+    action.sa_handler = &CpuAccounting::onReportSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &action, &previous_action_);
+}
+
+void CpuAccounting::disable() {
+    if (!sampler_running_.exchange(false)) {
+        return;
+    }
+    sigaction(SIGUSR2, &previous_action_, nullptr);
+    sem_post(&report_request_);
+    sampler_.join();
+    sem_destroy(&report_request_);
+    enabled_ = false;
+}
+
+void CpuAccounting::onReportSignal(int) {
+    // The instance exists once enabled; only async-signal-safe work here
+    sem_post(&instance().report_request_);
+}
+
+void CpuAccounting::samplerLoop() {
+    auto next_sample = std::chrono::steady_clock::now() + std::chrono::milliseconds(WINDOW_MS);
+    while (sampler_running_) {
+        // sem_timedwait takes a CLOCK_REALTIME deadline
+        auto remaining = std::max(next_sample - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration(0));
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        long long nanoseconds = deadline.tv_nsec + std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        deadline.tv_sec += static_cast<time_t>(nanoseconds / 1000000000);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+
+        if (sem_timedwait(&report_request_, &deadline) == 0) {
+            if (sampler_running_) {
+                std::string table = report(top_n_);
+                std::fwrite(table.data(), 1, table.size(), stdout);
+                std::fflush(stdout);
+            }
+        } else if (errno == ETIMEDOUT) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            samples_.push_back(takeSample());
+            if (samples_.size() > WINDOWS) {
+                samples_.pop_front();
+            }
+            next_sample += std::chrono::milliseconds(WINDOW_MS);
+        }
+    }
+}
+
+CpuAccounting::Sample CpuAccounting::takeSample() const {
+    Sample sample;
+    sample.cycles = readCycles();
+    sample.time = std::chrono::steady_clock::now();
+    sample.accounts.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+        sample.accounts.push_back(entry.account.cycles.load(std::memory_order_relaxed));
+    }
+    return sample;
+}
+
+std::string CpuAccounting::report(size_t top_n) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty()) {
+        return "CPU accounting is not enabled\n";
+    }
+    const Sample now = takeSample();
+    const Sample& base = samples_.front();
+    double window_cycles = static_cast<double>(std::max<uint64_t>(now.cycles - base.cycles, 1));
+
+    // Accounts registered after the base sample started from zero
+    std::map<std::string, std::array<double, ACTIVITIES>> owners;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        uint64_t before = i < base.accounts.size() ? base.accounts[i] : 0;
+        double& share = owners[entries_[i].owner][static_cast<size_t>(entries_[i].activity)];
+        share += static_cast<double>(now.accounts[i] - before) / window_cycles * 100.0;
+    }
+
+    struct Row {
+        const std::string* owner;
+        const std::array<double, ACTIVITIES>* shares;
+        double total;
+    };
+    std::vector<Row> rows;
+    double totals[ACTIVITIES + 1] = {};
+    for (const auto& owner : owners) {
+        double total = 0.0;
+        for (size_t activity = 0; activity < ACTIVITIES; ++activity) {
+            total += owner.second[activity];
+            totals[activity] += owner.second[activity];
+        }
+        totals[ACTIVITIES] += total;
+        rows.push_back({&owner.first, &owner.second, total});
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.total > b.total; });
+    rows.resize(std::min(rows.size(), top_n));
+    int width = 12;
+    for (const Row& row : rows) {
+        width = std::max(width, static_cast<int>(row.owner->size()));
+    }
+
+    char line[256];
+    std::string text;
+    std::snprintf(line, sizeof(line), "CPU use over the last %.1f s, %% of one core (top %zu of %zu owners):\n",
+                  std::chrono::duration<double>(now.time - base.time).count(), rows.size(), owners.size());
+    text += line;
+    std::snprintf(line, sizeof(line), "%-*s %9s %9s %9s %9s\n", width, "owner", "total", "physics", "timers", "receive");
+    text += line;
+    for (const Row& row : rows) {
+        std::snprintf(line, sizeof(line), "%-*s %8.2f%% %8.2f%% %8.2f%% %8.2f%%\n", width, row.owner->c_str(), row.total,
+                      (*row.shares)[0], (*row.shares)[1], (*row.shares)[2]);
+        text += line;
+    }
+    std::snprintf(line, sizeof(line), "%-*s %8.2f%% %8.2f%% %8.2f%% %8.2f%%\n", width, "all", totals[ACTIVITIES],
+                  totals[0], totals[1], totals[2]);
+    text += line;
+    return text;
+}
@@ -0,0 +1,73 @@
+#include "ElectromechanicalModel.h"
+#include <algorithm>
+#include <cmath>
+
+ElectromechanicalModel::ElectromechanicalModel() : ElectromechanicalModel(Parameters()) {
+}
+
+ElectromechanicalModel::ElectromechanicalModel(const Parameters& parameters)
+    : parameters_(parameters), dt_(0.0), inverse_{1.0, 0.0, 0.0, 1.0}, velocity_denominator_(1.0),
+      current_(0.0) {
+}
+
+void ElectromechanicalModel::reset() {
+    current_ = 0.0;
+}
+
+void ElectromechanicalModel::configure(double dt) {
+    const Parameters& p = parameters_;
+
+    // (I - dt A) for state [i, w], A = [[-R/L, -Ke/L], [Kt/J, -b/J]]
+    double a = 1.0 + dt * p.resistanceOhm / p.inductanceH;
+    double b = dt * p.backEmfConstantVsPerRad / p.inductanceH;
+    double c = -dt * p.torqueConstantNmPerA / p.inertiaKgM2;
+    double d = 1.0 + dt * p.viscousFrictionNms / p.inertiaKgM2;
+    double inverse_determinant = 1.0 / (a * d - b * c);
+
+    inverse_[0] = d * inverse_determinant;
+    inverse_[1] = -b * inverse_determinant;
+    inverse_[2] = -c * inverse_determinant;
+    inverse_[3] = a * inverse_determinant;
+    velocity_denominator_ = d;
+    dt_ = dt;
+}
+
+void ElectromechanicalModel::update(Motor& motor, double dt) {
+    if (dt != dt_) {
+        configure(dt);
+    }
+    const Parameters& p = parameters_;
+
+    double voltage = p.supplyVoltageV * static_cast<double>(motor.getControlSignal())
+                     / static_cast<double>(motor.getMaxControlSignal());
+    double velocity = motor.getAngularVelocity();
+
+    // Implicit step without Coulomb friction
+    double rhs_current = current_ + dt * voltage / p.inductanceH;
+    double rhs_velocity = velocity - dt * (p.loadTorqueNm + motor.getLoad()) / p.inertiaKgM2;
+    double next_current = inverse_[0] * rhs_current + inverse_[1] * rhs_velocity;
+    double next_velocity = inverse_[2] * rhs_current + inverse_[3] * rhs_velocity;
+
+    // The step is linear in the friction torque, whose response is the second column
+    double friction_scale = -dt / p.inertiaKgM2;
+    double current_per_torque = inverse_[1] * friction_scale;
+    double velocity_per_torque = inverse_[3] * friction_scale;
+
+    if (p.currentLimitA > 0.0 && std::abs(next_current) > p.currentLimitA) {
+        // The driver regulates the current, leaving a first-order mechanical step
+        next_current = std::clamp(next_current, -p.currentLimitA, p.currentLimitA);
+        rhs_velocity += dt * p.torqueConstantNmPerA * next_current / p.inertiaKgM2;
+        next_velocity = rhs_velocity / velocity_denominator_;
+        current_per_torque = 0.0;
+        velocity_per_torque = friction_scale / velocity_denominator_;
+    }
+
+    // Coulomb friction opposes motion, or sticks if it can stop the shaft within the step
+    double stopping_torque = -next_velocity / velocity_per_torque;
+    double friction = std::clamp(stopping_torque, -p.coulombFrictionNm, p.coulombFrictionNm);
+    next_current += current_per_torque * friction;
+    next_velocity += velocity_per_torque * friction;
+
+    current_ = next_current;
+    motor.setState(next_velocity, motor.getAngularPosition() + next_velocity * dt);
+}
@@ -5,6 +5,7 @@ Encoder::Encoder(int bit_resolution, bool direction_inverted)
     : position_steps_(0), fractional_steps_(0.0), bit_resolution_(bit_resolution),
       direction_inverted_(direction_inverted) {
     max_steps_ = maxStepsFromBits(bit_resolution_);
+    step_mask_ = max_steps_ - 1;
 
     // Cache expensive calculations
     steps_per_radian_ = static_cast<double>(max_steps_) / (2.0 * M_PI);
@@ -12,31 +13,10 @@ Encoder::Encoder(int bit_resolution, bool direction_inverted)
 }
 
 void Encoder::update(double angular_velocity, double dt) {
-    // Calculate position change in radians
-    double position_change_radians = angular_velocity * dt;
-
-    // Apply direction inversion if needed
     if (direction_inverted_) {
-        position_change_radians = -position_change_radians;
-    }
-
-    // Convert position change to fractional steps using cached conversion
-    double fractional_steps_change = position_change_radians * steps_per_radian_;
-
-    // Accumulate fractional steps
-    fractional_steps_ += fractional_steps_change;
-
-    // Extract whole steps and update position
-    long whole_steps = static_cast<long>(fractional_steps_);
-    if (whole_steps != 0) {
-        position_steps_ += whole_steps;
-        fractional_steps_ -= whole_steps; // Keep only the fractional part
-
-        // Handle wraparound: absolute encoders wrap around at max_steps
-        position_steps_ = position_steps_ % max_steps_;
-        if (position_steps_ < 0) {
-            position_steps_ += max_steps_;
-        }
+        step<true>(angular_velocity, dt);
+    } else {
+        step<false>(angular_velocity, dt);
     }
 }
 
@@ -48,6 +28,11 @@ double Encoder::getPositionRadians() const {
     return stepsToRadians(position_steps_);
 }
 
+void Encoder::setPositionSteps(long steps) {
+    position_steps_ = steps;
+    fractional_steps_ = 0.0;
+}
+
 void Encoder::reset() {
     position_steps_ = 0;
     fractional_steps_ = 0.0;
@@ -0,0 +1,96 @@
+#include "FixedPointLanes.h"
+#include "Servo.h"
+#include <algorithm>
+
+namespace {
+
+// Clones for the vector widths of x86-64, resolved once at load time; 64-bit lane
+// compares need SSE4.2, so the default clone stays scalar
+#if defined(__x86_64__) && defined(__GNUC__)
+#define FIXED_POINT_CLONES __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+#define FIXED_POINT_CLONES
+#endif
+
+FIXED_POINT_CLONES
+void stepLanes(size_t count, const int64_t* __restrict control, const int64_t* __restrict velocity_per_signal,
+               const int64_t* __restrict max_velocity, const int64_t* __restrict alpha,
+               const int64_t* __restrict revolution_mask, int64_t* __restrict velocity,
+               int64_t* __restrict position, int64_t* __restrict revolutions) {
+    for (size_t i = 0; i < count; ++i) {
+        // First-order velocity response towards the commanded steady state, then limit
+        int64_t target = control[i] * velocity_per_signal[i];
+        int64_t lane_velocity = velocity[i] + FixedPointModel::mulQ32(target - velocity[i], alpha[i]);
+        lane_velocity = lane_velocity < -max_velocity[i] ? -max_velocity[i] : lane_velocity;
+        lane_velocity = lane_velocity > max_velocity[i] ? max_velocity[i] : lane_velocity;
+        velocity[i] = lane_velocity;
+
+        // Less than a revolution per step, so the carry is -1, 0 or 1 (the shift of
+        // FixedPointModel::step(), as compares that vectorize)
+        int64_t lane_position = position[i] + lane_velocity;
+        revolutions[i] += static_cast<int64_t>(lane_position > revolution_mask[i]) -
+                          static_cast<int64_t>(lane_position < 0);
+        position[i] = lane_position & revolution_mask[i];
+    }
+}
+
+} // namespace
+
+void FixedPointLanes::load(const std::vector<Servo*>& servos, double dt) {
+    servos_ = servos;
+    size_t count = servos_.size();
+    velocityPerSignal_.resize(count);
+    maxVelocity_.resize(count);
+    alpha_.resize(count);
+    revolutionMask_.resize(count);
+    control_.resize(count);
+    velocity_.resize(count);
+    position_.resize(count);
+    revolutions_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        FixedPointModel& model = *servos_[i]->getFixedPointModel();
+        if (model.dt_ != dt) {
+            model.configure(servos_[i]->getMotor(), servos_[i]->getEncoder(), dt);
+        }
+        velocityPerSignal_[i] = model.velocity_per_signal_q32_;
+        // A revolution per step is over a million RPM at the default rate
+        maxVelocity_[i] = std::min(model.max_velocity_q32_, model.revolution_mask_q32_);
+        alpha_[i] = model.alpha_q32_;
+        revolutionMask_[i] = model.revolution_mask_q32_;
+        control_[i] = servos_[i]->getControlSignal();
+        velocity_[i] = model.velocity_q32_;
+        position_[i] = model.position_q32_;
+        revolutions_[i] = model.revolutions_;
+    }
+}
+
+void FixedPointLanes::step() {
+    stepLanes(servos_.size(), control_.data(), velocityPerSignal_.data(), maxVelocity_.data(), alpha_.data(),
+              revolutionMask_.data(), velocity_.data(), position_.data(), revolutions_.data());
+}
+
+void FixedPointLanes::publish() const {
+    for (size_t i = 0; i < servos_.size(); ++i) {
+        Servo& servo = *servos_[i];
+        FixedPointModel& model = *servo.getFixedPointModel();
+        model.velocity_q32_ = velocity_[i];
+        model.position_q32_ = position_[i];
+        model.revolutions_ = revolutions_[i];
+        if (servo.getEncoder().isDirectionInverted()) {
+            model.publish<true>(servo.getMotor(), servo.getEncoder());
+        } else {
+            model.publish<false>(servo.getMotor(), servo.getEncoder());
+        }
+    }
+}
+
+void FixedPointLanes::reloadControlSignal(size_t lane) {
+    control_[lane] = servos_[lane]->getControlSignal();
+}
+
+long FixedPointLanes::getEncoderSteps(size_t lane) const {
+    int64_t encoder_q32 = servos_[lane]->getEncoder().isDirectionInverted()
+        ? (-position_[lane] & revolutionMask_[lane]) : position_[lane];
+    return static_cast<long>(encoder_q32 >> FixedPointModel::FRACTION_BITS);
+}
@@ -0,0 +1,50 @@
+#include "FixedPointModel.h"
+#include <cmath>
+
+namespace {
+
+constexpr double Q32_ONE = 4294967296.0;
+
+} // namespace
+
+FixedPointModel::FixedPointModel()
+    : dt_(0.0), velocity_per_signal_q32_(0), max_velocity_q32_(0), alpha_q32_(0), bit_resolution_(0),
+      revolution_mask_q32_(0), radians_per_q32_(0.0),
+      radians_per_second_per_q32_(0.0), velocity_q32_(0), position_q32_(0), revolutions_(0) {
+}
+
+void FixedPointModel::reset() {
+    dt_ = 0.0;
+}
+
+void FixedPointModel::configure(const Motor& motor, const Encoder& encoder, double dt) {
+    bit_resolution_ = encoder.getBitResolution();
+    long max_steps = encoder.getMaxSteps();
+    revolution_mask_q32_ = (static_cast<int64_t>(max_steps) << FRACTION_BITS) - 1;
+
+    double steps_per_radian = static_cast<double>(max_steps) / (2.0 * M_PI);
+    double steps_per_tick_per_rad_s = steps_per_radian * dt;
+    radians_per_q32_ = 1.0 / (steps_per_radian * Q32_ONE);
+    radians_per_second_per_q32_ = 1.0 / (steps_per_tick_per_rad_s * Q32_ONE);
+
+    max_velocity_q32_ = std::llround(motor.getMaxAngularVelocity() * steps_per_tick_per_rad_s * Q32_ONE);
+    velocity_per_signal_q32_ = std::llround(motor.getMaxAngularVelocity() / motor.getMaxControlSignal()
+                                            * steps_per_tick_per_rad_s * Q32_ONE);
+    alpha_q32_ = std::llround(std::min(dt / motor.getMotorTimeConstant(), 1.0) * Q32_ONE);
+
+    // Seed (or, after a step size change, rescale) the state from the double model
+    velocity_q32_ = std::llround(motor.getAngularVelocity() * steps_per_tick_per_rad_s * Q32_ONE);
+    int64_t total_q32 = std::llround(motor.getAngularPosition() * steps_per_radian * Q32_ONE);
+    revolutions_ = total_q32 >> (FRACTION_BITS + bit_resolution_);
+    position_q32_ = total_q32 & revolution_mask_q32_;
+
+    dt_ = dt;
+}
+
+void FixedPointModel::update(Motor& motor, Encoder& encoder, double dt) {
+    if (encoder.isDirectionInverted()) {
+        step<true>(motor, encoder, dt);
+    } else {
+        step<false>(motor, encoder, dt);
+    }
+}
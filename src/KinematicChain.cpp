@@ -0,0 +1,292 @@
+#include "KinematicChain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+void skew(const double v[3], double out[3][3]) {
+    out[0][0] = 0.0;    out[0][1] = -v[2]; out[0][2] = v[1];
+    out[1][0] = v[2];   out[1][1] = 0.0;   out[1][2] = -v[0];
+    out[2][0] = -v[1];  out[2][1] = v[0];  out[2][2] = 0.0;
+}
+
+void multiply3(const double a[3][3], const double b[3][3], double out[3][3]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        }
+    }
+}
+
+// Rotation taking parent coordinates to child coordinates, for a child frame
+// rotated by angle about a unit axis (Rodrigues, transposed)
+void axisRotation(const double axis[3], double angle, double out[3][3]) {
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+    double t = 1.0 - c;
+    double x = axis[0], y = axis[1], z = axis[2];
+    out[0][0] = t * x * x + c;      out[0][1] = t * x * y + s * z;  out[0][2] = t * x * z - s * y;
+    out[1][0] = t * x * y - s * z;  out[1][1] = t * y * y + c;      out[1][2] = t * y * z + s * x;
+    out[2][0] = t * x * z + s * y;  out[2][1] = t * y * z - s * x;  out[2][2] = t * z * z + c;
+}
+
+// Parent -> child coordinate rotation for a child frame with roll/pitch/yaw in the parent
+void rpyRotation(const double rpy[3], double out[3][3]) {
+    const double x_axis[3] = {1.0, 0.0, 0.0};
+    const double y_axis[3] = {0.0, 1.0, 0.0};
+    const double z_axis[3] = {0.0, 0.0, 1.0};
+    double roll[3][3], pitch[3][3], yaw[3][3], yaw_pitch[3][3];
+    axisRotation(x_axis, rpy[0], roll);
+    axisRotation(y_axis, rpy[1], pitch);
+    axisRotation(z_axis, rpy[2], yaw);
+    // Child orientation is Rz * Ry * Rx, so the coordinate transform is Rx^T Ry^T Rz^T
+    multiply3(pitch, yaw, yaw_pitch);
+    multiply3(roll, yaw_pitch, out);
+}
+
+} // namespace
+
+KinematicChain::KinematicChain(const Config& config, const std::vector<Servo*>& servos)
+    : name_(config.name) {
+    if (config.joints.empty() || config.joints.size() > MAX_JOINTS || servos.size() != config.joints.size()) {
+        throw std::invalid_argument("KinematicChain '" + config.name + "': needs 1.." +
+                                    std::to_string(MAX_JOINTS) + " joints, each with a servo");
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        base_acceleration_.v[i] = 0.0;
+        base_acceleration_.v[3 + i] = -config.gravity[i];
+    }
+
+    joints_.resize(config.joints.size());
+    for (size_t i = 0; i < joints_.size(); ++i) {
+        const JointConfig& joint_config = config.joints[i];
+        Joint& joint = joints_[i];
+        std::memset(&joint, 0, sizeof(Joint));
+        joint.servo = servos[i];
+
+        rpyRotation(joint_config.rpy, joint.tree_rotation);
+        double axis_norm = std::sqrt(joint_config.axis[0] * joint_config.axis[0] +
+                                     joint_config.axis[1] * joint_config.axis[1] +
+                                     joint_config.axis[2] * joint_config.axis[2]);
+        for (int k = 0; k < 3; ++k) {
+            joint.tree_translation[k] = joint_config.origin[k];
+            joint.axis[k] = axis_norm > 0.0 ? joint_config.axis[k] / axis_norm : (k == 2 ? 1.0 : 0.0);
+        }
+
+        // Spatial inertia about the joint origin: [Ic + m cx cx^T, m cx; m cx^T, m 1]
+        double cx[3][3];
+        skew(joint_config.com, cx);
+        double m = joint_config.mass;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                double cx_cxt = cx[r][0] * cx[c][0] + cx[r][1] * cx[c][1] + cx[r][2] * cx[c][2];
+                joint.inertia.m[r][c] = (r == c ? joint_config.inertia[r] : 0.0) + m * cx_cxt;
+                joint.inertia.m[r][3 + c] = m * cx[r][c];
+                joint.inertia.m[3 + r][c] = m * cx[c][r];
+                joint.inertia.m[3 + r][3 + c] = r == c ? m : 0.0;
+            }
+        }
+
+        const Motor& motor = joint.servo->getMotor();
+        joint.max_torque = joint_config.maxTorqueNm;
+        joint.target_per_signal = motor.getMaxAngularVelocity() / motor.getMaxControlSignal();
+        joint.velocity_gain = joint_config.velocityGainNms;
+        joint.position = motor.getAngularPosition();
+        joint.velocity = motor.getAngularVelocity();
+    }
+
+    // Default gains: articulated inertia seen by each joint at the start pose / time constant
+    std::vector<double> accelerations(joints_.size());
+    computeAccelerations(accelerations.data());
+    for (size_t i = 0; i < joints_.size(); ++i) {
+        if (config.joints[i].velocityGainNms <= 0.0) {
+            joints_[i].velocity_gain = joints_[i].axis_inertia / joints_[i].servo->getMotor().getMotorTimeConstant();
+        }
+    }
+}
+
+void KinematicChain::computeAccelerations(double* accelerations) {
+    const size_t count = joints_.size();
+
+    // Pass 1 (base to tip): transforms, velocities, velocity-product terms
+    for (size_t i = 0; i < count; ++i) {
+        Joint& joint = joints_[i];
+
+        double joint_rotation[3][3], rotation[3][3];
+        axisRotation(joint.axis, joint.position, joint_rotation);
+        multiply3(joint_rotation, joint.tree_rotation, rotation);
+
+        // Plücker transform [E 0; -E rx E]
+        double rx[3][3], e_rx[3][3];
+        skew(joint.tree_translation, rx);
+        multiply3(rotation, rx, e_rx);
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                joint.transform.m[r][c] = rotation[r][c];
+                joint.transform.m[r][3 + c] = 0.0;
+                joint.transform.m[3 + r][c] = -e_rx[r][c];
+                joint.transform.m[3 + r][3 + c] = rotation[r][c];
+            }
+        }
+
+        // v_i = X v_parent + S qd
+        SpatialVector& v = joint.spatial_velocity;
+        for (int r = 0; r < 6; ++r) {
+            double sum = 0.0;
+            if (i > 0) {
+                for (int c = 0; c < 6; ++c) {
+                    sum += joint.transform.m[r][c] * joints_[i - 1].spatial_velocity.v[c];
+                }
+            }
+            v.v[r] = sum;
+        }
+        for (int k = 0; k < 3; ++k) {
+            v.v[k] += joint.axis[k] * joint.velocity;
+        }
+
+        // c_i = v x (S qd): angular w x s, linear vlin x s
+        const double s[3] = {joint.axis[0] * joint.velocity, joint.axis[1] * joint.velocity,
+                             joint.axis[2] * joint.velocity};
+        const double* w = v.v;
+        const double* vl = v.v + 3;
+        joint.bias_acceleration.v[0] = w[1] * s[2] - w[2] * s[1];
+        joint.bias_acceleration.v[1] = w[2] * s[0] - w[0] * s[2];
+        joint.bias_acceleration.v[2] = w[0] * s[1] - w[1] * s[0];
+        joint.bias_acceleration.v[3] = vl[1] * s[2] - vl[2] * s[1];
+        joint.bias_acceleration.v[4] = vl[2] * s[0] - vl[0] * s[2];
+        joint.bias_acceleration.v[5] = vl[0] * s[1] - vl[1] * s[0];
+
+        // pA_i = v x* (I v)
+        joint.articulated_inertia = joint.inertia;
+        double h[6];
+        for (int r = 0; r < 6; ++r) {
+            h[r] = 0.0;
+            for (int c = 0; c < 6; ++c) {
+                h[r] += joint.inertia.m[r][c] * v.v[c];
+            }
+        }
+        // Force cross product: [w x h_ang + vlin x h_lin; w x h_lin]
+        joint.articulated_bias.v[0] = w[1] * h[2] - w[2] * h[1] + vl[1] * h[5] - vl[2] * h[4];
+        joint.articulated_bias.v[1] = w[2] * h[0] - w[0] * h[2] + vl[2] * h[3] - vl[0] * h[5];
+        joint.articulated_bias.v[2] = w[0] * h[1] - w[1] * h[0] + vl[0] * h[4] - vl[1] * h[3];
+        joint.articulated_bias.v[3] = w[1] * h[5] - w[2] * h[4];
+        joint.articulated_bias.v[4] = w[2] * h[3] - w[0] * h[5];
+        joint.articulated_bias.v[5] = w[0] * h[4] - w[1] * h[3];
+    }
+
+    // Pass 2 (tip to base): articulated inertias and bias forces
+    for (size_t i = count; i-- > 0;) {
+        Joint& joint = joints_[i];
+        const SpatialMatrix& ia = joint.articulated_inertia;
+
+        // S = [axis; 0], so U = IA S is a weighted sum of IA's first three columns
+        for (int r = 0; r < 6; ++r) {
+            joint.inertia_axis.v[r] = ia.m[r][0] * joint.axis[0] + ia.m[r][1] * joint.axis[1] + ia.m[r][2] * joint.axis[2];
+        }
+        joint.axis_inertia = joint.axis[0] * joint.inertia_axis.v[0] + joint.axis[1] * joint.inertia_axis.v[1] +
+                             joint.axis[2] * joint.inertia_axis.v[2];
+        joint.bias_torque = joint.torque - (joint.axis[0] * joint.articulated_bias.v[0] +
+                                            joint.axis[1] * joint.articulated_bias.v[1] +
+                                            joint.axis[2] * joint.articulated_bias.v[2]);
+
+        if (i == 0) {
+            continue;
+        }
+
+        // Ia = IA - U U^T / d, pa = pA + Ia c + U u / d
+        const double inverse_d = 1.0 / joint.axis_inertia;
+        SpatialMatrix ia_reduced;
+        for (int r = 0; r < 6; ++r) {
+            for (int c = 0; c < 6; ++c) {
+                ia_reduced.m[r][c] = ia.m[r][c] - joint.inertia_axis.v[r] * joint.inertia_axis.v[c] * inverse_d;
+            }
+        }
+        double pa[6];
+        for (int r = 0; r < 6; ++r) {
+            double sum = joint.articulated_bias.v[r] + joint.inertia_axis.v[r] * joint.bias_torque * inverse_d;
+            for (int c = 0; c < 6; ++c) {
+                sum += ia_reduced.m[r][c] * joint.bias_acceleration.v[c];
+            }
+            pa[r] = sum;
+        }
+
+        // Parent accumulates X^T Ia X and X^T pa; X's upper-right block is zero
+        const SpatialMatrix& x = joint.transform;
+        double ia_x[6][6];
+        for (int r = 0; r < 6; ++r) {
+            for (int c = 0; c < 6; ++c) {
+                double sum = 0.0;
+                for (int k = c < 3 ? 0 : 3; k < 6; ++k) {
+                    sum += ia_reduced.m[r][k] * x.m[k][c];
+                }
+                ia_x[r][c] = sum;
+            }
+        }
+        Joint& parent = joints_[i - 1];
+        for (int r = 0; r < 6; ++r) {
+            const int first = r < 3 ? 0 : 3;
+            for (int c = 0; c < 6; ++c) {
+                double sum = 0.0;
+                for (int k = first; k < 6; ++k) {
+                    sum += x.m[k][r] * ia_x[k][c];
+                }
+                parent.articulated_inertia.m[r][c] += sum;
+            }
+            double force = 0.0;
+            for (int k = first; k < 6; ++k) {
+                force += x.m[k][r] * pa[k];
+            }
+            parent.articulated_bias.v[r] += force;
+        }
+    }
+
+    // Pass 3 (base to tip): accelerations
+    for (size_t i = 0; i < count; ++i) {
+        Joint& joint = joints_[i];
+        const SpatialVector& parent_acceleration = i > 0 ? joints_[i - 1].acceleration : base_acceleration_;
+
+        SpatialVector& a = joint.acceleration;
+        for (int r = 0; r < 6; ++r) {
+            double sum = joint.bias_acceleration.v[r];
+            for (int c = 0; c < 6; ++c) {
+                sum += joint.transform.m[r][c] * parent_acceleration.v[c];
+            }
+            a.v[r] = sum;
+        }
+
+        double u_dot_a = 0.0;
+        for (int r = 0; r < 6; ++r) {
+            u_dot_a += joint.inertia_axis.v[r] * a.v[r];
+        }
+        double qdd = (joint.bias_torque - u_dot_a) / joint.axis_inertia;
+        for (int k = 0; k < 3; ++k) {
+            a.v[k] += joint.axis[k] * qdd;
+        }
+        accelerations[i] = qdd;
+    }
+}
+
+void KinematicChain::step(double dt) {
+    // Velocity-regulating drives, limited to their torque rating
+    for (Joint& joint : joints_) {
+        const Motor& motor = joint.servo->getMotor();
+        double target = motor.getControlSignal() * joint.target_per_signal;
+        joint.torque = std::clamp(joint.velocity_gain * (target - joint.velocity), -joint.max_torque, joint.max_torque)
+                       - motor.getLoad();
+    }
+
+    double accelerations[MAX_JOINTS];
+    computeAccelerations(accelerations);
+
+    // Semi-implicit Euler, then publish through the servos' regular interfaces
+    for (size_t i = 0; i < joints_.size(); ++i) {
+        Joint& joint = joints_[i];
+        joint.velocity += accelerations[i] * dt;
+        joint.position += joint.velocity * dt;
+        joint.servo->getMotor().setState(joint.velocity, joint.position);
+        joint.servo->getEncoder().update(joint.velocity, dt);
+    }
+}
@@ -0,0 +1,252 @@
+#include "LoadProfile.h"
+#include "Logger.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+LoadProfile::LoadProfile(const std::string& path, uint32_t channel, bool loop)
+    : path_(path), channel_(channel), loop_(loop), fd_(-1), header_(), frames_per_chunk_(0),
+      chunks_(), current_(nullptr), frame_(0), last_mapped_(nullptr), next_(nullptr), retired_(nullptr),
+      underruns_(0) {}
+
+LoadProfile::~LoadProfile() {
+    close();
+}
+
+bool LoadProfile::open() {
+    if (fd_ >= 0) {
+        return true; // Already open
+    }
+
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        LOG_ERROR("LoadProfile: Cannot open %s: %s", path_.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat file_stat;
+    if (pread(fd_, &header_, sizeof(header_), 0) != static_cast<ssize_t>(sizeof(header_)) ||
+        fstat(fd_, &file_stat) != 0 || header_.magic != LOAD_PROFILE_MAGIC ||
+        header_.version != LOAD_PROFILE_VERSION || header_.channels == 0 || header_.frameCount == 0 ||
+        !(header_.sampleRateHz > 0.0)) {
+        LOG_ERROR("LoadProfile: %s is not a load profile", path_.c_str());
+        close();
+        return false;
+    }
+
+    uint64_t frame_bytes = header_.channels * sizeof(float);
+    if (static_cast<uint64_t>(file_stat.st_size) < sizeof(header_) + header_.frameCount * frame_bytes) {
+        LOG_ERROR("LoadProfile: %s is truncated", path_.c_str());
+        close();
+        return false;
+    }
+    if (channel_ >= header_.channels) {
+        LOG_ERROR("LoadProfile: %s has no channel %u", path_.c_str(), channel_);
+        close();
+        return false;
+    }
+    frames_per_chunk_ = std::max<uint64_t>(1, CHUNK_BYTES / frame_bytes);
+
+    // Map the first two chunks up front, so playback starts without waiting
+    if (!mapChunk(chunks_[0], 0)) {
+        close();
+        return false;
+    }
+    current_ = &chunks_[0];
+    last_mapped_ = current_;
+    frame_ = 0;
+    service();
+    return true;
+}
+
+void LoadProfile::close() {
+    for (Chunk& chunk : chunks_) {
+        unmapChunk(chunk);
+    }
+    current_ = nullptr;
+    last_mapped_ = nullptr;
+    next_.store(nullptr, std::memory_order_relaxed);
+    retired_.store(nullptr, std::memory_order_relaxed);
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool LoadProfile::nextSample(float& sample) {
+    if (frame_ >= current_->firstFrame + current_->frameCount) {
+        if (!loop_ && frame_ >= header_.frameCount) {
+            return false; // Hold the last sample
+        }
+
+        Chunk* next = next_.load(std::memory_order_acquire);
+        if (!next) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // The streamer frees the previous retired chunk before it maps the next one,
+        // so the retired slot is always empty here
+        next_.store(nullptr, std::memory_order_relaxed);
+        retired_.store(current_, std::memory_order_release);
+        current_ = next;
+        frame_ = current_->firstFrame;
+    }
+
+    sample = current_->frames[(frame_ - current_->firstFrame) * header_.channels + channel_];
+    ++frame_;
+    return true;
+}
+
+void LoadProfile::service() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (Chunk* retired = retired_.load(std::memory_order_acquire)) {
+        unmapChunk(*retired);
+        retired_.store(nullptr, std::memory_order_release);
+    }
+
+    if (next_.load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+
+    uint64_t first_frame = nextChunkStart(*last_mapped_);
+    if (first_frame == NO_CHUNK) {
+        return;
+    }
+    for (Chunk& chunk : chunks_) {
+        if (chunk.mapping == nullptr) {
+            if (mapChunk(chunk, first_frame)) {
+                last_mapped_ = &chunk;
+                next_.store(&chunk, std::memory_order_release);
+            }
+            return;
+        }
+    }
+}
+
+bool LoadProfile::mapChunk(Chunk& chunk, uint64_t first_frame) {
+    static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+
+    const uint64_t frame_bytes = header_.channels * sizeof(float);
+    uint64_t frame_count = std::min(frames_per_chunk_, header_.frameCount - first_frame);
+    uint64_t offset = sizeof(header_) + first_frame * frame_bytes;
+    uint64_t aligned_offset = offset & ~(page_size - 1);
+    size_t length = static_cast<size_t>(offset - aligned_offset + frame_count * frame_bytes);
+
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, static_cast<off_t>(aligned_offset));
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("LoadProfile: Cannot map %s: %s", path_.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Fault every page in now, so reading the chunk later never blocks on the disk
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    madvise(mapping, length, MADV_WILLNEED);
+    const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(mapping);
+    for (size_t touched = 0; touched < length; touched += page_size) {
+        (void)bytes[touched];
+    }
+
+    chunk.mapping = mapping;
+    chunk.mappingLength = length;
+    chunk.frames = reinterpret_cast<const float*>(static_cast<const uint8_t*>(mapping) + (offset - aligned_offset));
+    chunk.firstFrame = first_frame;
+    chunk.frameCount = frame_count;
+    return true;
+}
+
+void LoadProfile::unmapChunk(Chunk& chunk) {
+    if (chunk.mapping == nullptr) {
+        return;
+    }
+
+    // Played data is not needed again soon, so keep long runs from filling the page cache
+    const uint64_t frame_bytes = header_.channels * sizeof(float);
+    posix_fadvise(fd_, static_cast<off_t>(sizeof(header_) + chunk.firstFrame * frame_bytes),
+                  static_cast<off_t>(chunk.frameCount * frame_bytes), POSIX_FADV_DONTNEED);
+    munmap(chunk.mapping, chunk.mappingLength);
+    chunk.mapping = nullptr;
+}
+
+uint64_t LoadProfile::nextChunkStart(const Chunk& chunk) const {
+    uint64_t next = chunk.firstFrame + chunk.frameCount;
+    if (next < header_.frameCount) {
+        return next;
+    }
+    return loop_ ? 0 : NO_CHUNK;
+}
+
+bool LoadProfile::convertCsv(const std::string& csv_path, const std::string& profile_path, double sample_rate_hz) {
+    std::ifstream csv(csv_path);
+    if (!csv.is_open()) {
+        LOG_ERROR("LoadProfile: Cannot open %s", csv_path.c_str());
+        return false;
+    }
+    if (!(sample_rate_hz > 0.0)) {
+        LOG_ERROR("LoadProfile: Invalid sample rate %g Hz", sample_rate_hz);
+        return false;
+    }
+    std::ofstream profile(profile_path, std::ios::binary | std::ios::trunc);
+    if (!profile.is_open()) {
+        LOG_ERROR("LoadProfile: Cannot create %s", profile_path.c_str());
+        return false;
+    }
+
+    LoadProfileHeader header = {LOAD_PROFILE_MAGIC, LOAD_PROFILE_VERSION, sample_rate_hz, 0, 0, 0};
+    profile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Streamed line by line, so recordings of any length convert in constant memory
+    std::string line;
+    std::vector<float> frame;
+    uint64_t line_number = 0;
+    while (std::getline(csv, line)) {
+        ++line_number;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        frame.clear();
+        std::stringstream columns(line);
+        std::string column;
+        while (std::getline(columns, column, ',')) {
+            try {
+                frame.push_back(std::stof(column));
+            } catch (...) {
+                LOG_ERROR("LoadProfile: %s:%llu: invalid number '%s'", csv_path.c_str(),
+                          static_cast<unsigned long long>(line_number), column.c_str());
+                return false;
+            }
+        }
+
+        if (header.channels == 0) {
+            header.channels = static_cast<uint32_t>(frame.size());
+        } else if (frame.size() != header.channels) {
+            LOG_ERROR("LoadProfile: %s:%llu: expected %u columns", csv_path.c_str(),
+                      static_cast<unsigned long long>(line_number), header.channels);
+            return false;
+        }
+        profile.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size() * sizeof(float)));
+        ++header.frameCount;
+    }
+
+    if (header.frameCount == 0) {
+        LOG_ERROR("LoadProfile: %s has no samples", csv_path.c_str());
+        return false;
+    }
+
+    profile.seekp(0);
+    profile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return profile.good();
+}
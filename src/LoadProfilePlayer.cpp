@@ -0,0 +1,107 @@
+#include "LoadProfilePlayer.h"
+#include <algorithm>
+#include <chrono>
+
+LoadProfilePlayer::LoadProfilePlayer() : streaming_(false) {}
+
+LoadProfilePlayer::~LoadProfilePlayer() {
+    stop();
+}
+
+void LoadProfilePlayer::add(std::unique_ptr<LoadProfile> profile, Motor* motor, double scale) {
+    profiles_.push_back(std::move(profile));
+    motors_.push_back(motor);
+    scales_.push_back(scale);
+}
+
+bool LoadProfilePlayer::drives(const Motor* motor) const {
+    return std::find(motors_.begin(), motors_.end(), motor) != motors_.end();
+}
+
+void LoadProfilePlayer::start(double tick_rate_hz) {
+    if (streaming_ || profiles_.empty()) {
+        return;
+    }
+
+    const size_t count = profiles_.size();
+    const size_t blocks = (count + KERNEL_LANES - 1) / KERNEL_LANES;
+    const Lanes zero = {};
+    phase_.assign(blocks, zero);
+    increment_.assign(blocks, zero);
+    start_.assign(blocks, zero);
+    delta_.assign(blocks, zero);
+    value_.assign(blocks, zero);
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t block = i / KERNEL_LANES;
+        const size_t lane = i % KERNEL_LANES;
+        increment_[block][lane] = profiles_[i]->getSampleRate() / tick_rate_hz;
+
+        float first = 0.0f;
+        profiles_[i]->nextSample(first);
+        float second = first;
+        profiles_[i]->nextSample(second);
+        start_[block][lane] = first * scales_[i];
+        delta_[block][lane] = (second - first) * scales_[i];
+        value_[block][lane] = start_[block][lane];
+        motors_[i]->setLoad(value_[block][lane]);
+    }
+
+    streaming_ = true;
+    streamer_ = std::thread(&LoadProfilePlayer::streamLoop, this);
+}
+
+void LoadProfilePlayer::stop() {
+    streaming_ = false;
+    if (streamer_.joinable()) {
+        streamer_.join();
+    }
+}
+
+void LoadProfilePlayer::tick() {
+    const size_t blocks = phase_.size();
+    for (size_t block = 0; block < blocks; ++block) {
+        phase_[block] += increment_[block];
+        value_[block] = start_[block] + delta_[block] * phase_[block];
+    }
+
+    const size_t count = profiles_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const size_t block = i / KERNEL_LANES;
+        const size_t lane = i % KERNEL_LANES;
+        if (phase_[block][lane] >= 1.0) {
+            advanceSample(block, lane, i);
+        }
+        motors_[i]->setLoad(value_[block][lane]);
+    }
+}
+
+void LoadProfilePlayer::advanceSample(size_t block, size_t lane, size_t index) {
+    // Profiles sampled faster than the tick rate cross several samples per tick
+    while (phase_[block][lane] >= 1.0) {
+        phase_[block][lane] -= 1.0;
+        double previous = start_[block][lane] + delta_[block][lane];
+        float sample;
+        double next = profiles_[index]->nextSample(sample) ? sample * scales_[index] : previous;
+        start_[block][lane] = previous;
+        delta_[block][lane] = next - previous;
+    }
+    value_[block][lane] = start_[block][lane] + delta_[block][lane] * phase_[block][lane];
+}
+
+uint64_t LoadProfilePlayer::getUnderruns() const {
+    uint64_t underruns = 0;
+    for (const auto& profile : profiles_) {
+        underruns += profile->getUnderruns();
+    }
+    return underruns;
+}
+
+void LoadProfilePlayer::streamLoop() {
+    while (streaming_) {
+        for (auto& profile : profiles_) {
+            profile->service();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(STREAM_POLL_MS));
+    }
+}
@@ -0,0 +1,227 @@
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <time.h>
+
+std::atomic<LogLevel> Logger::level_(LogLevel::Info);
+
+namespace {
+
+// Millisecond resolution is plenty for rate windows, and costs no more than a load
+uint64_t coarseNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+bool LogSite::admit(uint32_t& suppressed) {
+    uint64_t window = coarseNowNs() / WINDOW_NS;
+    uint64_t current = window_.load(std::memory_order_relaxed);
+    if (window != current && window_.compare_exchange_strong(current, window, std::memory_order_relaxed)) {
+        count_.store(0, std::memory_order_relaxed);
+    }
+
+    if (count_.fetch_add(1, std::memory_order_relaxed) < BURST) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : retired_dropped_(0), last_level_(LogLevel::Info), repeats_(0), reported_dropped_(0),
+      flush_requested_(0), flush_completed_(0), running_(true) {
+    writer_thread_ = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        running_ = false;
+    }
+    flush_cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+}
+
+Logger::ThreadRing::~ThreadRing() {
+    if (ring) {
+        ring->retired.store(true, std::memory_order_release);
+    }
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    static const struct { const char* name; LogLevel level; } levels[] = {
+        {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning}, {"error", LogLevel::Error}};
+    for (const auto& entry : levels) {
+        if (name == entry.name) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger::Ring* Logger::threadRing() {
+    thread_local ThreadRing thread_ring;
+    if (!thread_ring.ring) {
+        thread_ring.ring = std::make_shared<Ring>();
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(thread_ring.ring);
+    }
+    return thread_ring.ring.get();
+}
+
+void Logger::log(LogLevel level, uint32_t suppressed, const char* format, ...) {
+    Ring* ring = threadRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_RECORDS) {
+        ring->dropped.fetch_add(1 + suppressed, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = ring->records[head % RING_RECORDS];
+    record.timeNs = nowNs();
+    record.suppressed = suppressed;
+    record.level = level;
+
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    record.length = static_cast<uint16_t>(std::min<size_t>(length < 0 ? 0 : static_cast<size_t>(length),
+                                                           sizeof(record.text) - 1));
+
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    uint64_t ticket = ++flush_requested_;
+    flush_cv_.notify_all();
+    flush_cv_.wait(lock, [this, ticket] { return flush_completed_ >= ticket || !running_; });
+}
+
+uint64_t Logger::getDropped() const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    uint64_t dropped = retired_dropped_;
+    for (const auto& ring : rings_) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    while (true) {
+        bool stopping = !running_;
+        uint64_t ticket = flush_requested_;
+        lock.unlock();
+
+        drain(stopping || ticket != flush_completed_);
+
+        lock.lock();
+        flush_completed_ = ticket;
+        flush_cv_.notify_all();
+        if (stopping) {
+            break;
+        }
+        flush_cv_.wait_for(lock, std::chrono::milliseconds(WRITER_IDLE_MS),
+                           [this, ticket] { return flush_requested_ != ticket || !running_; });
+    }
+}
+
+void Logger::drain(bool flushing) {
+    // Take every ring's pending records, then write them in time order
+    std::vector<std::shared_ptr<Ring>> rings;
+    uint64_t dropped;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+        dropped = retired_dropped_;
+    }
+
+    batch_.clear();
+    for (const auto& ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            batch_.push_back(ring->records[tail % RING_RECORDS]);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    std::stable_sort(batch_.begin(), batch_.end(),
+                     [](const Record& a, const Record& b) { return a.timeNs < b.timeNs; });
+
+    for (const Record& record : batch_) {
+        write(record);
+    }
+    if (batch_.empty() || flushing) {
+        flushRepeats(); // Nothing new, or asked for everything: report a pending repeat count now
+    }
+    if (dropped != reported_dropped_) {
+        flushRepeats();
+        std::fprintf(stderr, "Logger: %llu messages dropped, log rings full\n",
+                     static_cast<unsigned long long>(dropped - reported_dropped_));
+        reported_dropped_ = dropped;
+    }
+    std::fflush(stdout);
+    std::fflush(stderr);
+
+    // Free the rings of exited threads once they are drained
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [this](const std::shared_ptr<Ring>& ring) {
+        bool done = ring->retired.load(std::memory_order_acquire) &&
+                    ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+        if (done) {
+            retired_dropped_ += ring->dropped.load(std::memory_order_relaxed);
+        }
+        return done;
+    }), rings_.end());
+}
+
+void Logger::write(const Record& record) {
+    if (record.suppressed == 0 && record.level == last_level_ &&
+        last_line_.compare(0, std::string::npos, record.text, record.length) == 0) {
+        ++repeats_;
+        return;
+    }
+    flushRepeats();
+
+    FILE* stream = record.level >= LogLevel::Warning ? stderr : stdout;
+    std::fwrite(record.text, 1, record.length, stream);
+    if (record.suppressed > 0) {
+        std::fprintf(stream, " (%u similar messages suppressed)", record.suppressed);
+    }
+    std::fputc('\n', stream);
+
+    last_line_.assign(record.text, record.length);
+    last_level_ = record.level;
+}
+
+void Logger::flushRepeats() {
+    if (repeats_ > 0) {
+        std::fprintf(last_level_ >= LogLevel::Warning ? stderr : stdout, "(last message repeated %llu times)\n",
+                     static_cast<unsigned long long>(repeats_));
+        repeats_ = 0;
+    }
+}
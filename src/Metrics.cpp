@@ -0,0 +1,205 @@
+#include "Metrics.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+
+thread_local Metrics::Shard* Metrics::thread_shard_ = nullptr;
+thread_local Metrics::ThreadShard Metrics::thread_shard_owner_;
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Shard::~Shard() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+Metrics::ThreadShard::~ThreadShard() {
+    if (shard) {
+        thread_shard_ = nullptr;
+        shard->retired.store(true, std::memory_order_release);
+    }
+}
+
+uint32_t Metrics::counterSlot(const std::string& name, const std::string& help, const std::string& labels) {
+    return allocateSlots(name, help, labels, Type::Counter, 1);
+}
+
+uint32_t Metrics::histogramSlot(const std::string& name, const std::string& help, const std::string& labels) {
+    return allocateSlots(name, help, labels, Type::Histogram, HISTOGRAM_BUCKETS + 2);
+}
+
+uint32_t Metrics::allocateSlots(const std::string& name, const std::string& help, const std::string& labels,
+                                Type type, uint32_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& family = families_[name];
+    if (family.series.empty()) {
+        family.help = help;
+        family.type = type;
+    } else if (family.type != type) {
+        LOG_ERROR("Metrics: %s is registered with another type", name.c_str());
+        return UINT32_MAX;
+    }
+
+    auto existing = family.series.find(labels);
+    if (existing != family.series.end()) {
+        return existing->second.slot;
+    }
+
+    // A histogram's slots must not straddle two chunks
+    uint32_t slot = next_slot_;
+    if (slot / CHUNK_SLOTS != (slot + count - 1) / CHUNK_SLOTS) {
+        slot = (slot / CHUNK_SLOTS + 1) * CHUNK_SLOTS;
+    }
+    if (slot + count > MAX_CHUNKS * CHUNK_SLOTS) {
+        // Large fleets run out here once per board; say so once
+        if (!slots_exhausted_) {
+            slots_exhausted_ = true;
+            LOG_ERROR("Metrics: Out of counter slots, %s{%s} and later series are not recorded",
+                      name.c_str(), labels.c_str());
+        }
+        return UINT32_MAX;
+    }
+    next_slot_ = slot + count;
+    family.series.emplace(labels, Series{slot, nullptr});
+    return slot;
+}
+
+std::atomic<double>* Metrics::gaugeValue(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& family = families_[name];
+    if (family.series.empty()) {
+        family.help = help;
+        family.type = Type::Gauge;
+    } else if (family.type != Type::Gauge) {
+        LOG_ERROR("Metrics: %s is registered with another type", name.c_str());
+        return nullptr;
+    }
+
+    auto existing = family.series.find(labels);
+    if (existing != family.series.end()) {
+        return existing->second.gauge;
+    }
+    gauges_.emplace_back(0.0);
+    family.series.emplace(labels, Series{0, &gauges_.back()});
+    return &gauges_.back();
+}
+
+std::atomic<uint64_t>* Metrics::allocateChunk(uint32_t chunk) {
+    if (!thread_shard_) {
+        thread_shard_owner_.shard = std::make_shared<Shard>();
+        thread_shard_ = thread_shard_owner_.shard.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        shards_.push_back(thread_shard_owner_.shard);
+    }
+
+    std::atomic<uint64_t>* slots = thread_shard_->chunks[chunk].load(std::memory_order_relaxed);
+    if (!slots) {
+        slots = new std::atomic<uint64_t>[CHUNK_SLOTS]();
+        thread_shard_->chunks[chunk].store(slots, std::memory_order_release);
+    }
+    return slots;
+}
+
+void Metrics::prepareThread() {
+    Metrics& metrics = instance();
+    uint32_t chunks;
+    {
+        std::lock_guard<std::mutex> lock(metrics.mutex_);
+        chunks = std::min(metrics.next_slot_ / CHUNK_SLOTS + 2, MAX_CHUNKS);
+    }
+    for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+        metrics.allocateChunk(chunk);
+    }
+}
+
+uint64_t Metrics::total(uint32_t slot) const {
+    uint64_t sum = slot < retired_totals_.size() ? retired_totals_[slot] : 0;
+    for (const auto& shard : shards_) {
+        if (const std::atomic<uint64_t>* chunk = shard->chunks[slot / CHUNK_SLOTS].load(std::memory_order_acquire)) {
+            sum += chunk[slot % CHUNK_SLOTS].load(std::memory_order_relaxed);
+        }
+    }
+    return sum;
+}
+
+void Metrics::foldRetiredShards() const {
+    retired_totals_.resize(next_slot_, 0);
+    shards_.erase(std::remove_if(shards_.begin(), shards_.end(), [this](const std::shared_ptr<Shard>& shard) {
+        if (!shard->retired.load(std::memory_order_acquire)) {
+            return false;
+        }
+        for (uint32_t slot = 0; slot < next_slot_; ++slot) {
+            if (const std::atomic<uint64_t>* chunk = shard->chunks[slot / CHUNK_SLOTS].load(std::memory_order_acquire)) {
+                retired_totals_[slot] += chunk[slot % CHUNK_SLOTS].load(std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }), shards_.end());
+}
+
+uint64_t Metrics::counterValue(const std::string& name, const std::string& labels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto family = families_.find(name);
+    if (family == families_.end() || family->second.type != Type::Counter) {
+        return 0;
+    }
+    auto series = family->second.series.find(labels);
+    return series != family->second.series.end() ? total(series->second.slot) : 0;
+}
+
+std::string Metrics::render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    foldRetiredShards();
+
+    static const char* type_names[] = {"counter", "gauge", "histogram"};
+    auto braces = [](const std::string& labels, const std::string& extra) {
+        std::string joined = labels.empty() ? extra : (extra.empty() ? labels : labels + "," + extra);
+        return joined.empty() ? std::string() : "{" + joined + "}";
+    };
+
+    std::string text;
+    char number[64];
+    for (const auto& entry : families_) {
+        const std::string& name = entry.first;
+        const Family& family = entry.second;
+        text += "# HELP " + name + " " + family.help + "\n";
+        text += "# TYPE " + name + " " + type_names[static_cast<int>(family.type)] + "\n";
+
+        for (const auto& labelled : family.series) {
+            const std::string& labels = labelled.first;
+            const Series& series = labelled.second;
+            if (family.type == Type::Counter) {
+                std::snprintf(number, sizeof(number), " %llu\n", static_cast<unsigned long long>(total(series.slot)));
+                text += name + braces(labels, "") + number;
+            } else if (family.type == Type::Gauge) {
+                std::snprintf(number, sizeof(number), " %.17g\n", series.gauge->load(std::memory_order_relaxed));
+                text += name + braces(labels, "") + number;
+            } else {
+                // Prometheus buckets are cumulative
+                uint64_t cumulative = 0;
+                for (uint32_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+                    cumulative += total(series.slot + bucket);
+                    std::string bound = "+Inf";
+                    if (bucket < HISTOGRAM_BUCKETS - 1) {
+                        std::snprintf(number, sizeof(number), "%g",
+                                      static_cast<double>(HISTOGRAM_FIRST_BOUND_NS << bucket) * 1e-9);
+                        bound = number;
+                    }
+                    std::snprintf(number, sizeof(number), " %llu\n", static_cast<unsigned long long>(cumulative));
+                    text += name + "_bucket" + braces(labels, "le=\"" + bound + "\"") + number;
+                }
+                std::snprintf(number, sizeof(number), " %.9g\n",
+                              static_cast<double>(total(series.slot + HISTOGRAM_BUCKETS)) * 1e-9);
+                text += name + "_sum" + braces(labels, "") + number;
+                std::snprintf(number, sizeof(number), " %llu\n",
+                              static_cast<unsigned long long>(total(series.slot + HISTOGRAM_BUCKETS + 1)));
+                text += name + "_count" + braces(labels, "") + number;
+            }
+        }
+    }
+    return text;
+}
@@ -0,0 +1,168 @@
+#include "MetricsExporter.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+MetricsExporter::MetricsExporter(const Config& config)
+    : config_(config), unix_fd_(-1), http_fd_(-1), running_(false) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (running_) {
+        return true;
+    }
+
+    if (!config_.unixSocketPath.empty()) {
+        struct sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (config_.unixSocketPath.size() >= sizeof(addr.sun_path)) {
+            LOG_ERROR("MetricsExporter: Socket path %s is too long", config_.unixSocketPath.c_str());
+            return false;
+        }
+        std::strncpy(addr.sun_path, config_.unixSocketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(config_.unixSocketPath.c_str()); // Left over from a previous run
+
+        unix_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (unix_fd_ < 0 || bind(unix_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(unix_fd_, 8) < 0) {
+            LOG_ERROR("MetricsExporter: Cannot listen on %s: %s", config_.unixSocketPath.c_str(), std::strerror(errno));
+            stop();
+            return false;
+        }
+    }
+
+    if (config_.httpPort != 0) {
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config_.httpPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int reuse = 1;
+        http_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (http_fd_ < 0 || setsockopt(http_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+            bind(http_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(http_fd_, 8) < 0) {
+            LOG_ERROR("MetricsExporter: Cannot listen on 127.0.0.1:%u: %s", config_.httpPort, std::strerror(errno));
+            stop();
+            return false;
+        }
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsExporter::serveLoop, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    bool was_running = running_.exchange(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    if (unix_fd_ >= 0) {
+        close(unix_fd_);
+        unix_fd_ = -1;
+        unlink(config_.unixSocketPath.c_str());
+    }
+    if (http_fd_ >= 0) {
+        close(http_fd_);
+        http_fd_ = -1;
+    }
+
+    if (was_running) {
+        dump(); // Final counts
+    }
+}
+
+void MetricsExporter::serveLoop() {
+    struct pollfd fds[2];
+    nfds_t fd_count = 0;
+    for (int fd : {unix_fd_, http_fd_}) {
+        if (fd >= 0) {
+            fds[fd_count].fd = fd;
+            fds[fd_count].events = POLLIN;
+            ++fd_count;
+        }
+    }
+
+    const auto dump_interval = std::chrono::milliseconds(config_.dumpIntervalMs);
+    auto next_dump = std::chrono::steady_clock::now();
+    while (running_) {
+        auto now = std::chrono::steady_clock::now();
+        if (!config_.dumpPath.empty() && now >= next_dump) {
+            dump();
+            next_dump = now + dump_interval;
+        }
+
+        // Wake at least every 100 ms to notice stop()
+        if (poll(fds, fd_count, 100) <= 0) {
+            continue;
+        }
+        for (nfds_t i = 0; i < fd_count; ++i) {
+            if (fds[i].revents & POLLIN) {
+                int client_fd = accept4(fds[i].fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client_fd >= 0) {
+                    respond(client_fd);
+                    close(client_fd);
+                }
+            }
+        }
+    }
+}
+
+void MetricsExporter::respond(int client_fd) {
+    // The request itself is not interpreted: every path returns the metrics. Wait
+    // briefly for it, so the client does not see a reset for unread request bytes.
+    struct pollfd request = {client_fd, POLLIN, 0};
+    if (poll(&request, 1, REQUEST_TIMEOUT_MS) > 0) {
+        char buffer[1024];
+        (void)!read(client_fd, buffer, sizeof(buffer));
+    }
+
+    std::string body = Metrics::instance().render();
+    std::string response = "HTTP/1.0 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    const char* data = response.data();
+    size_t remaining = response.size();
+    while (remaining > 0) {
+        ssize_t written = send(client_fd, data, remaining, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return; // Client went away
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+void MetricsExporter::dump() {
+    if (config_.dumpPath.empty()) {
+        return;
+    }
+
+    std::string temporary = config_.dumpPath + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("MetricsExporter: Cannot create %s: %s", temporary.c_str(), std::strerror(errno));
+        return;
+    }
+    std::string text = Metrics::instance().render();
+    bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), config_.dumpPath.c_str()) != 0) {
+        LOG_ERROR("MetricsExporter: Cannot write %s: %s", config_.dumpPath.c_str(), std::strerror(errno));
+    }
+}
@@ -0,0 +1,51 @@
+#include "PositionHold.h"
+#include <algorithm>
+#include <cmath>
+
+PositionHold::PositionHold()
+    : max_steps_(1), direction_(1.0), radians_per_step_(0.0), max_effort_(0), period_(0.0),
+      target_steps_(0), integral_(0.0), previous_error_(0.0), primed_(false) {
+}
+
+void PositionHold::configure(const Config& config, long max_steps, bool direction_inverted,
+                             int max_effort, double period) {
+    config_ = config;
+    max_steps_ = max_steps;
+    direction_ = direction_inverted ? -1.0 : 1.0;
+    radians_per_step_ = (2.0 * M_PI) / static_cast<double>(max_steps);
+    max_effort_ = max_effort;
+    period_ = period;
+    engage(target_steps_);
+}
+
+void PositionHold::engage(long target_steps) {
+    target_steps_ = target_steps;
+    integral_ = 0.0;
+    previous_error_ = 0.0;
+    primed_ = false;
+}
+
+int PositionHold::update(long encoder_steps) {
+    // Shortest signed distance to the target around the wraparound point
+    long error_steps = (target_steps_ - encoder_steps) % max_steps_;
+    if (error_steps > max_steps_ / 2) {
+        error_steps -= max_steps_;
+    } else if (error_steps < -max_steps_ / 2) {
+        error_steps += max_steps_;
+    }
+    double error = direction_ * static_cast<double>(error_steps) * radians_per_step_;
+
+    double derivative = primed_ ? (error - previous_error_) / period_ : 0.0;
+    previous_error_ = error;
+    primed_ = true;
+
+    // Anti-windup: the integral term alone never exceeds the effort limit
+    if (config_.ki > 0.0) {
+        double integral_limit = max_effort_ / config_.ki;
+        integral_ = std::clamp(integral_ + error * period_, -integral_limit, integral_limit);
+    }
+
+    double effort = config_.kp * error + config_.ki * integral_ + config_.kd * derivative;
+    long rounded = std::lround(effort);
+    return static_cast<int>(std::clamp<long>(rounded, -max_effort_, max_effort_));
+}
@@ -1,20 +1,44 @@
 #include "Servo.h"
 #include "CanBoard.h"
+#include "Logger.h"
 
 Servo::Servo(double max_velocity_rpm, int max_control_signal, double motor_time_constant,
              int bit_resolution, bool direction_inverted, bool enable_can, uint32_t can_id, 
-             const std::string& can_interface)
-    : motor_(std::make_shared<Motor>(Motor::builder()
-                                     .maxVelocityRPM(max_velocity_rpm)
-                                     .maxControlSignal(max_control_signal)
-                                     .timeConstant(motor_time_constant))),
-      encoder_(std::make_shared<Encoder>(Encoder::builder()
-                                         .bitResolution(bit_resolution)
-                                         .directionInverted(direction_inverted))) {
+             const std::string& can_interface, uint32_t can_bitrate,
+             const TransmitPolicy& transmit_policy,
+             const VelocityEstimator::Config& velocity_estimator,
+             const PositionHold::Config& position_hold, bool fixed_point,
+             const BoardTimerRates& timer_rates, bool electromechanical,
+             const ElectromechanicalModel::Parameters& electromechanical_parameters)
+    : physics_(new Physics{Motor::builder()
+                               .maxVelocityRPM(max_velocity_rpm)
+                               .maxControlSignal(max_control_signal)
+                               .timeConstant(motor_time_constant),
+                           Encoder::builder()
+                               .bitResolution(bit_resolution)
+                               .directionInverted(direction_inverted)}) {
+
+    // The fixed-point path implements the first-order model only
+    if (electromechanical) {
+        electromechanical_ = std::make_unique<ElectromechanicalModel>(electromechanical_parameters);
+        if (fixed_point) {
+            LOG_WARNING("Servo: Fixed-point physics is not available with the electromechanical model, "
+                        "using double precision");
+        }
+    } else if (fixed_point && bit_resolution > FixedPointModel::MAX_BIT_RESOLUTION) {
+        LOG_WARNING("Servo: Fixed-point physics supports encoders up to %d bits, using double precision for %d bits",
+                    FixedPointModel::MAX_BIT_RESOLUTION, bit_resolution);
+    } else if (fixed_point) {
+        fixed_point_ = std::make_unique<FixedPointModel>();
+    }
     
     // Create CanBoard if CAN is enabled
     if (enable_can) {
-        can_board_ = std::make_unique<CanBoard>(*this, can_id, can_interface);
+        can_board_ = std::make_unique<CanBoard>(*this, can_id, can_interface, can_bitrate);
+        can_board_->setTimerRates(timer_rates);
+        can_board_->setTransmitPolicy(transmit_policy);
+        can_board_->setVelocityEstimator(velocity_estimator);
+        can_board_->setPositionHold(position_hold);
     }
 }
 
@@ -24,43 +48,33 @@ Servo::~Servo() {
 }
 
 Servo::Servo(Servo&& other) noexcept 
-    : motor_(std::move(other.motor_)),
-      encoder_(std::move(other.encoder_)) {
+    : physics_(std::move(other.physics_)),
+      can_board_(std::move(other.can_board_)),
+      fixed_point_(std::move(other.fixed_point_)),
+      electromechanical_(std::move(other.electromechanical_)) {
     
-    // If the other servo has a CanBoard, we need to create a new one
-    // because CanBoard holds a reference to the Servo object
-    if (other.can_board_) {
-        uint32_t can_id = other.can_board_->getCanId();
-        // Stop the old CanBoard first
-        other.can_board_->stop();
-        
-        // Create new CanBoard for this servo
-        // We need to extract the CAN interface from the old CanBoard
-        can_board_ = std::make_unique<CanBoard>(*this, can_id, "vcan0");
-        
-        // Clear the other's CanBoard
-        other.can_board_.reset();
+    // CanBoard points back at its owning Servo, so rebind it to this one.
+    // The board is stopped first, as its timers may still be using the old Servo.
+    if (can_board_) {
+        can_board_->stop();
+        can_board_->rebind(*this);
     }
 }
 
 Servo& Servo::operator=(Servo&& other) noexcept {
     if (this != &other) {
-        motor_ = std::move(other.motor_);
-        encoder_ = std::move(other.encoder_);
+        physics_ = std::move(other.physics_);
+        fixed_point_ = std::move(other.fixed_point_);
+        electromechanical_ = std::move(other.electromechanical_);
         
-        // Handle CanBoard properly due to reference issue
-        if (other.can_board_) {
-            uint32_t can_id = other.can_board_->getCanId();
-            // Stop the old CanBoard first
-            other.can_board_->stop();
-            
-            // Create new CanBoard for this servo
-            can_board_ = std::make_unique<CanBoard>(*this, can_id, "vcan0");
-            
-            // Clear the other's CanBoard
-            other.can_board_.reset();
-        } else {
-            can_board_.reset();
+        // Rebind the moved CanBoard to this Servo, as in the move constructor
+        if (can_board_) {
+            can_board_->stop();
+        }
+        can_board_ = std::move(other.can_board_);
+        if (can_board_) {
+            can_board_->stop();
+            can_board_->rebind(*this);
         }
     }
     return *this;
@@ -0,0 +1,75 @@
+#include "ShmClient.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ShmClient::ShmClient(const std::string& name, bool busy_poll)
+    : name_(name), busy_poll_(busy_poll), segment_(nullptr) {
+}
+
+ShmClient::~ShmClient() {
+    disconnect();
+}
+
+bool ShmClient::connect() {
+    if (segment_) {
+        return true;
+    }
+
+    int fd = shm_open(shmSegmentPath(name_).c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(ShmSegment)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    auto* segment = static_cast<ShmSegment*>(mapping);
+    if (segment->magic.load(std::memory_order_acquire) != SHM_SEGMENT_MAGIC ||
+        segment->version != SHM_SEGMENT_VERSION || segment->ring_capacity != SHM_RING_CAPACITY) {
+        munmap(mapping, sizeof(ShmSegment));
+        return false;
+    }
+
+    segment_ = segment;
+    return true;
+}
+
+void ShmClient::disconnect() {
+    if (segment_) {
+        munmap(segment_, sizeof(ShmSegment));
+        segment_ = nullptr;
+    }
+}
+
+bool ShmClient::isConnected() const {
+    return segment_ != nullptr;
+}
+
+bool ShmClient::send(const struct can_frame& frame) {
+    return segment_ && segment_->to_simulator.push(frame);
+}
+
+bool ShmClient::tryReceive(struct can_frame& frame) {
+    return segment_ && segment_->to_client.pop(frame);
+}
+
+bool ShmClient::receive(struct can_frame& frame, int timeout_ms) {
+    if (!segment_) {
+        return false;
+    }
+    if (segment_->to_client.pop(frame)) {
+        return true;
+    }
+    return segment_->to_client.waitForFrame(busy_poll_, timeout_ms) && segment_->to_client.pop(frame);
+}
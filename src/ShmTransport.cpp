@@ -0,0 +1,229 @@
+#include "ShmTransport.h"
+#include "ShmFrameRing.h"
+#include "Logger.h"
+#include "AllocationTracker.h"
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Process-wide owner of one shared-memory segment and its dispatch thread
+ *
+ * Created by the first ShmTransport opened on a name. The registry keeps it, so a
+ * controller's mapping survives boards closing and reopening their transports;
+ * ShmTransport::releaseSegments() drops it at engine shutdown, and the segment is
+ * unlinked once no open transport uses it either.
+ */
+class ShmChannel : public CanEndpointList {
+private:
+    std::string path_;
+    bool busy_poll_;
+    ShmSegment* segment_;
+    std::atomic<bool> running_;
+    std::thread dispatch_thread_;
+
+    static constexpr int DISPATCH_WAIT_MS = 10;
+
+public:
+    ShmChannel(const std::string& name, bool busy_poll)
+        : path_(shmSegmentPath(name)), busy_poll_(busy_poll), segment_(nullptr), running_(false) {
+    }
+
+    ~ShmChannel() {
+        running_ = false;
+        if (dispatch_thread_.joinable()) {
+            dispatch_thread_.join();
+        }
+        if (segment_) {
+            segment_->magic.store(0, std::memory_order_release);
+            munmap(segment_, sizeof(ShmSegment));
+            shm_unlink(path_.c_str());
+        }
+    }
+
+    static std::shared_ptr<ShmChannel> get(const std::string& name, bool busy_poll) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::shared_ptr<ShmChannel>& channel = registry()[name];
+        if (!channel) {
+            auto created = std::make_shared<ShmChannel>(name, busy_poll);
+            if (!created->create()) {
+                registry().erase(name);
+                return nullptr;
+            }
+            channel = created;
+        } else if (channel->busy_poll_ != busy_poll) {
+            // One dispatch thread serves the segment, it cannot both park and spin
+            LOG_ERROR("ShmTransport: Segment %s is open in %s mode, cannot open it in %s mode",
+                      channel->path_.c_str(), channel->busy_poll_ ? "shm-poll" : "shm",
+                      busy_poll ? "shm-poll" : "shm");
+            return nullptr;
+        }
+        return channel;
+    }
+
+    static void releaseAll() {
+        std::map<std::string, std::shared_ptr<ShmChannel>> released;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            released.swap(registry());
+        }
+        // Channels still used by an open transport go when it closes
+    }
+
+    bool send(const struct can_frame& frame) {
+        return segment_->to_client.push(frame);
+    }
+
+private:
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::map<std::string, std::shared_ptr<ShmChannel>>& registry() {
+        static std::map<std::string, std::shared_ptr<ShmChannel>> channels;
+        return channels;
+    }
+
+    bool create() {
+        int fd = shm_open(path_.c_str(), O_CREAT | O_RDWR, 0660);
+        if (fd < 0) {
+            LOG_ERROR("ShmTransport: Failed to create segment %s: %s", path_.c_str(), std::strerror(errno));
+            return false;
+        }
+
+        if (ftruncate(fd, sizeof(ShmSegment)) < 0) {
+            LOG_ERROR("ShmTransport: Failed to size segment %s: %s", path_.c_str(), std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            LOG_ERROR("ShmTransport: Failed to map segment %s: %s", path_.c_str(), std::strerror(errno));
+            return false;
+        }
+
+        // The simulator owns the segment: reset whatever a previous run left behind,
+        // then publish it by writing the magic last
+        segment_ = static_cast<ShmSegment*>(mapping);
+        segment_->magic.store(0, std::memory_order_relaxed);
+        segment_->version = SHM_SEGMENT_VERSION;
+        segment_->ring_capacity = SHM_RING_CAPACITY;
+        segment_->to_client.initialize();
+        segment_->to_simulator.initialize();
+        segment_->magic.store(SHM_SEGMENT_MAGIC, std::memory_order_release);
+
+        running_ = true;
+        dispatch_thread_ = std::thread(&ShmChannel::dispatchLoop, this);
+        return true;
+    }
+
+    void dispatchLoop() {
+        Logger::instance().prepareThread();
+        Metrics::prepareThread();
+        struct can_frame frame;
+        while (running_) {
+            while (segment_->to_simulator.pop(frame)) {
+                HotPath hot_path;
+                broadcast(nullptr, frame);
+            }
+            segment_->to_simulator.waitForFrame(busy_poll_, DISPATCH_WAIT_MS);
+        }
+    }
+};
+
+ShmTransport::ShmTransport(const std::string& interface_name)
+    : interface_name_(interface_name), busy_poll_(interface_name.compare(0, 9, "shm-poll:") == 0),
+      open_channel_(nullptr), endpoint_(std::make_shared<CanEndpoint>()) {
+    segment_name_ = interface_name_.substr(interface_name_.find(':') + 1);
+    endpoint_->filter_drops = MetricCounter("motor_sim_transport_filter_drops_total",
+                                            "Frames dropped by receive filters",
+                                            "interface=\"" + interface_name_ + "\"");
+}
+
+ShmTransport::~ShmTransport() {
+    close();
+}
+
+bool ShmTransport::open() {
+    std::lock_guard<std::mutex> lock(transport_mutex_);
+
+    if (channel_) {
+        return true; // Already open
+    }
+
+    channel_ = ShmChannel::get(segment_name_, busy_poll_);
+    if (!channel_) {
+        return false;
+    }
+    channel_->attach(endpoint_);
+    open_channel_.store(channel_.get());
+    return true;
+}
+
+void ShmTransport::close() {
+    stopReceiving();
+
+    std::lock_guard<std::mutex> lock(transport_mutex_);
+
+    if (channel_) {
+        // The channel may go with channel_, so sends that read the pointer finish first
+        open_channel_.store(nullptr);
+        endpoint_->waitForSends();
+        channel_->detach(endpoint_);
+        channel_.reset();
+    }
+}
+
+bool ShmTransport::isOpen() const {
+    return open_channel_.load(std::memory_order_acquire) != nullptr;
+}
+
+bool ShmTransport::sendFrame(const struct can_frame& frame) {
+    // Announce the send before reading the channel pointer, so close() can wait it out
+    endpoint_->sends_in_flight.fetch_add(1);
+    ShmChannel* channel = open_channel_.load();
+    bool sent = channel && channel->send(frame);
+    endpoint_->sends_in_flight.fetch_sub(1);
+    return sent;
+}
+
+bool ShmTransport::startReceiving(ReceiveCallback callback) {
+    std::lock_guard<std::mutex> lock(transport_mutex_);
+
+    if (!channel_) {
+        return false;
+    }
+
+    return endpoint_->startReceiving(std::move(callback));
+}
+
+void ShmTransport::stopReceiving() {
+    endpoint_->stopReceiving();
+}
+
+bool ShmTransport::isReceiving() const {
+    return endpoint_->receiving;
+}
+
+bool ShmTransport::setFilters(const struct can_filter* filters, size_t filter_count) {
+    return endpoint_->setFilters(filters, filter_count);
+}
+
+const std::string& ShmTransport::getInterfaceName() const {
+    return interface_name_;
+}
+
+bool ShmTransport::isShmInterface(const std::string& interface_name) {
+    return interface_name.compare(0, 4, "shm:") == 0 || interface_name.compare(0, 9, "shm-poll:") == 0;
+}
+
+void ShmTransport::releaseSegments() {
+    ShmChannel::releaseAll();
+}
@@ -1,14 +1,171 @@
 #include "SimulationEngine.h"
+#include "CanBoard.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include "ShmTransport.h"
+#include "AllocationTracker.h"
+#include <malloc.h>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
-SimulationEngine::SimulationEngine() : running_(false) {}
+namespace {
+
+// Spin iterations before a chain thread waiting for its peers yields the CPU
+constexpr int CHAIN_SPIN_BEFORE_YIELD = 2000;
+
+void cpuRelax(int& spins) {
+    if (++spins < CHAIN_SPIN_BEFORE_YIELD) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+std::string toHex(uint32_t value) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%x", value);
+    return text;
+}
+
+// Bytes handed out by malloc and not yet freed (0 where the allocator cannot tell)
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+SimulationEngine::SimulationEngine()
+    : chainThreads_(1), chainWorkersRunning_(false), chainRound_(0), chainPending_(0), telemetryRing_(nullptr),
+      pendingEdit_(nullptr), editPending_(false), physicsRunning_(false), running_(false), tick_(0),
+      tickOverruns_("motor_sim_tick_overruns_total", "Physics ticks that ran past the start of the next tick"),
+      tickDuration_("motor_sim_tick_duration_seconds", "Time spent computing one physics tick"),
+      heapBytesPerServo_("motor_sim_heap_bytes_per_servo", "Heap in use divided by the number of servos"),
+      syncId_(0), simulationFrequencyHz_(DEFAULT_SIMULATION_FREQUENCY_HZ),
+      dt_(1.0 / DEFAULT_SIMULATION_FREQUENCY_HZ), integrationAccuracy_(DEFAULT_INTEGRATION_ACCURACY) {}
 
 SimulationEngine::~SimulationEngine() {
     stop();
 }
 
 void SimulationEngine::addServo(Servo&& servo) {
-    servos_.emplace_back(std::move(servo));
+    if (running_ && (stateMirror_ || syncId_ != 0)) {
+        throw std::logic_error("The servo set is fixed while the state mirror or SYNC mode is active");
+    }
+    claimCanBitrate(servo);
+    auto added = std::make_unique<Servo>(std::move(servo));
+    if (!running_) {
+        servos_.push_back(std::move(added));
+        publishAllLanes();
+        kernelGroups_.clear();
+        chains_.clear();
+        return;
+    }
+
+    // Running: the servo joins at a tick boundary and its board starts as in start()
+    Servo* servo_ptr = added.get();
+    CanBoard* board = added->getCanBoard();
+    if (board) {
+        board->attachSimClock(tick_, simulationFrequencyHz_);
+        attachCanBus(*board);
+        for (auto& entry : canBuses_) {
+            entry.second->start(); // A new interface gets its bus model
+        }
+    }
+    runBetweenTicks([&]() { servos_.push_back(std::move(added)); });
+    servo_ptr->startCAN();
+}
+
+void SimulationEngine::removeServo(size_t index) {
+    Servo& servo = getServo(index);
+    for (const auto& spec : chainSpecs_) {
+        if (std::find(spec.servoIndices.begin(), spec.servoIndices.end(), index) != spec.servoIndices.end()) {
+            throw std::invalid_argument("Servo " + std::to_string(index) + " drives chain '" + spec.config.name +
+                                        "'");
+        }
+    }
+    if (loadProfiles_.drives(&servo.getMotor())) {
+        throw std::invalid_argument("Servo " + std::to_string(index) + " plays a load profile");
+    }
+    if (telemetry_ && capturesTelemetry(index)) {
+        throw std::invalid_argument("Servo " + std::to_string(index) + " is captured by telemetry");
+    }
+    if (running_ && (stateMirror_ || syncId_ != 0)) {
+        throw std::logic_error("The servo set is fixed while the state mirror or SYNC mode is active");
+    }
+
+    // The board stops first, so no timer or received frame touches the servo once it is gone
+    servo.stop();
+    std::unique_ptr<Servo> removed;
+    runBetweenTicks([&]() {
+        removed = std::move(servos_[index]);
+        servos_.erase(servos_.begin() + static_cast<std::ptrdiff_t>(index));
+        if (index < physicsCpu_.size()) {
+            physicsCpu_.erase(physicsCpu_.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+
+        // Later servos move down one position
+        for (auto& spec : chainSpecs_) {
+            for (size_t& chain_index : spec.servoIndices) {
+                chain_index -= chain_index > index ? 1 : 0;
+            }
+        }
+        telemetryIndices_.erase(std::remove(telemetryIndices_.begin(), telemetryIndices_.end(), index),
+                                telemetryIndices_.end());
+        for (size_t& telemetry_index : telemetryIndices_) {
+            telemetry_index -= telemetry_index > index ? 1 : 0;
+        }
+    });
+    // The servo is destroyed here, off the physics thread
+}
+
+void SimulationEngine::runBetweenTicks(const std::function<void()>& edit) {
+    std::unique_lock<std::mutex> lock(editMutex_);
+    editDone_.wait(lock, [this]() { return pendingEdit_ == nullptr; }); // Another caller's edit
+    if (!physicsRunning_) {
+        publishAllLanes();
+        edit();
+        kernelGroups_.clear();
+        chains_.clear();
+        return;
+    }
+    pendingEdit_ = &edit;
+    editPending_.store(true, std::memory_order_release);
+    editDone_.wait(lock, [this, &edit]() { return pendingEdit_ != &edit; });
+}
+
+void SimulationEngine::applyPendingEdit() {
+    std::lock_guard<std::mutex> lock(editMutex_);
+    if (!pendingEdit_) {
+        return;
+    }
+
+    // Coarse-step groups catch up first and lanes are published, so regrouping loses
+    // no simulated time and the edit sees every servo's current state
+    uint64_t tick = tick_.load(std::memory_order_relaxed);
+    for (auto& group : kernelGroups_) {
+        if (group.lastTick != tick) {
+            stepKernelGroup(group, tick);
+        }
+    }
+    publishAllLanes();
+    (*pendingEdit_)();
+    createKernelGroups();
+
+    pendingEdit_ = nullptr;
+    editPending_.store(false, std::memory_order_relaxed);
+    editDone_.notify_all();
 }
 
 size_t SimulationEngine::getServoCount() const {
@@ -19,48 +176,309 @@ Servo& SimulationEngine::getServo(size_t index) {
     if (index >= servos_.size()) {
         throw std::out_of_range("Servo index out of range");
     }
-    return servos_[index];
+    return *servos_[index];
 }
 
 const Servo& SimulationEngine::getServo(size_t index) const {
     if (index >= servos_.size()) {
         throw std::out_of_range("Servo index out of range");
     }
-    return servos_[index];
+    return *servos_[index];
 }
 
 void SimulationEngine::start() {
+    // The mirror is sized for the servo set present at start
+    if (!stateMirrorName_.empty() && !stateMirror_) {
+        stateMirror_ = std::make_unique<StateMirror>(stateMirrorName_);
+        if (!stateMirror_->open(static_cast<uint32_t>(servos_.size()), simulationFrequencyHz_)) {
+            stateMirror_.reset();
+        }
+    }
+
+    // Boards timestamp latched encoder state with the physics tick and run
+    // their position-hold loops from it
+    for (auto& servo : servos_) {
+        if (CanBoard* board = servo->getCanBoard()) {
+            board->attachSimClock(tick_, simulationFrequencyHz_);
+        }
+    }
+
+    createKernelGroups();
+    startChainWorkers();
+    loadProfiles_.start(simulationFrequencyHz_);
+    startTelemetry();
+
+    {
+        std::lock_guard<std::mutex> lock(editMutex_);
+        physicsRunning_ = true;
+    }
     running_ = true;
     simulationThread_ = std::thread(&SimulationEngine::simulationLoop, this);
 
+    // Bus models and SYNC groups must be running before boards start transmitting
+    createCanBuses();
+    createSyncGroups();
+
     // Start CAN for all servos
     for (auto& servo : servos_) {
-        servo.startCAN();
+        servo->startCAN();
     }
 
+    // Setup is done: from here on, ticks, timers and frame handling must not allocate
+    AllocationTracker::arm();
 }
 
 void SimulationEngine::stop() {
+    AllocationTracker::disarm();
     running_ = false;
     for (auto& servo : servos_) {
-        servo.stop();
+        servo->stop();
     }
 
     if (simulationThread_.joinable()) {
         simulationThread_.join();
     }
+    publishAllLanes();
+    stopChainWorkers();
+    loadProfiles_.stop();
+    if (telemetry_) {
+        telemetry_->stop();
+        telemetryRing_ = nullptr;
+    }
 
     // Stop CAN for all servos
     for (auto& servo : servos_) {
-        servo.stopCAN();
+        servo->stopCAN();
+    }
+
+    // Boards are stopped, so no further frames can be submitted
+    for (auto& group : syncGroups_) {
+        group->stop();
+    }
+    for (auto& entry : canBuses_) {
+        entry.second->stop();
     }
+
+    // Shared-memory segments outlive boards restarting, not the run
+    ShmTransport::releaseSegments();
 }
 
 void SimulationEngine::update() {
-    constexpr double dt = 1.0 / simulationFrequencyHz_;
-    for (auto& servo : servos_) {
-        servo.update(dt);
+    if (kernelGroups_.empty() && chains_.empty()) {
+        createKernelGroups();
+    }
+
+    // Board firmware loops see the encoder as of the end of the previous tick. A
+    // coarse-step group integrates up to it before a board changes its control
+    // signal, so the old signal drives the servo until now and the new one after.
+    // Lanes hand the encoder position over directly and take the new signal back.
+    // Servos playing a load profile are stepped every tick.
+    uint64_t completed = tick_.load(std::memory_order_relaxed);
+    for (auto& group : kernelGroups_) {
+        for (size_t i = 0; i < group.boards.size(); ++i) {
+            CanBoard* board = group.boards[i];
+            if (!board->actuationDue()) {
+                board->actuate(0);
+                continue;
+            }
+            if (group.lastTick != completed) {
+                stepKernelGroup(group, completed);
+            }
+            uint32_t slot = group.boardServos[i];
+            if (group.lanes) {
+                board->actuate(group.lanes->getEncoderSteps(slot));
+                group.lanes->reloadControlSignal(slot);
+            } else {
+                board->actuate(group.servos[slot]->getEncoderPosition());
+            }
+        }
+    }
+    for (auto& instance : chains_) {
+        for (size_t i = 0; i < instance.boards.size(); ++i) {
+            bool due = instance.boards[i]->actuationDue();
+            instance.boards[i]->actuate(due ? instance.boardServos[i]->getEncoderPosition() : 0);
+        }
     }
+    loadProfiles_.tick();
+
+    // Only the physics thread writes tick_
+    uint64_t tick = completed + 1;
+    for (auto& group : kernelGroups_) {
+        if (tick - group.lastTick >= group.decimation) {
+            stepKernelGroup(group, tick);
+        }
+    }
+    if (!chains_.empty()) {
+        chainClock_.beginStep();
+        stepChains();
+        chainClock_.endStep(tick);
+    }
+    tick_.store(tick, std::memory_order_relaxed);
+
+    // Latch every board of a group from this same tick when a SYNC arrived,
+    // bringing coarse-step servos up to this tick first
+    bool sync_requested = false;
+    for (const auto& group : syncGroups_) {
+        sync_requested = sync_requested || group->isSyncRequested();
+    }
+    if (sync_requested) {
+        for (auto& group : kernelGroups_) {
+            if (group.lastTick != tick) {
+                stepKernelGroup(group, tick);
+            }
+        }
+        publishAllLanes();
+    }
+    for (auto& group : syncGroups_) {
+        group->latchIfRequested(tick);
+    }
+
+    // Mirror entries change when their group publishes, and carry the tick they belong to
+    if (stateMirror_) {
+        for (const auto& group : kernelGroups_) {
+            if (group.publishedTick != tick) {
+                continue;
+            }
+            for (size_t i = 0; i < group.servos.size(); ++i) {
+                stateMirror_->publish(group.indices[i], *group.servos[i], tick);
+            }
+        }
+        for (const auto& instance : chains_) {
+            for (uint32_t index : instance.indices) {
+                stateMirror_->publish(index, *servos_[index], tick);
+            }
+        }
+        stateMirror_->commitTick(tick);
+    }
+
+    if (telemetryRing_) {
+        telemetry_->capture(*telemetryRing_, tick);
+    }
+}
+
+void SimulationEngine::stepKernelGroup(KernelGroup& group, uint64_t tick) {
+    uint64_t started = CpuAccounting::isEnabled() ? CpuAccounting::readCycles() : 0;
+    if (group.lanes) {
+        for (uint64_t step = group.lastTick; step < tick; ++step) {
+            group.lanes->step();
+        }
+        group.lastTick = tick;
+        if (tick - group.publishedTick >= group.publishDivider) {
+            publishLanes(group);
+        }
+    } else {
+        group.clock->beginStep();
+        group.kernel(group.servos.data(), group.servos.size(), static_cast<double>(tick - group.lastTick) * dt_);
+        group.lastTick = tick;
+        group.publishedTick = tick;
+        group.clock->endStep(tick);
+    }
+    if (started != 0) {
+        chargePhysics(group.indices, CpuAccounting::readCycles() - started);
+    }
+}
+
+void SimulationEngine::publishLanes(KernelGroup& group) {
+    group.clock->beginStep();
+    group.lanes->publish();
+    group.publishedTick = group.lastTick;
+    group.clock->endStep(group.lastTick);
+}
+
+void SimulationEngine::publishAllLanes() {
+    for (auto& group : kernelGroups_) {
+        if (group.lanes && group.publishedTick != group.lastTick) {
+            publishLanes(group);
+        }
+    }
+}
+
+void SimulationEngine::chargePhysics(const std::vector<uint32_t>& indices, uint64_t cycles) {
+    // A kernel group or chain is stepped as a whole; its servos share the cost evenly
+    uint64_t share = cycles / indices.size();
+    for (uint32_t index : indices) {
+        CpuAccounting::charge(physicsCpu_[index], share);
+    }
+}
+
+void SimulationEngine::stepChains() {
+    if (chainWorkers_.empty()) {
+        stepChainShare(0, 1);
+        return;
+    }
+
+    // Workers spin on chainRound_, so a round costs no syscalls
+    const uint32_t workers = static_cast<uint32_t>(chainWorkers_.size()) + 1;
+    chainPending_.store(workers - 1, std::memory_order_relaxed);
+    chainRound_.fetch_add(1, std::memory_order_release);
+    stepChainShare(0, workers);
+    int spins = 0;
+    while (chainPending_.load(std::memory_order_acquire) != 0) {
+        cpuRelax(spins);
+    }
+}
+
+void SimulationEngine::stepChainShare(uint32_t worker, uint32_t workers) {
+    for (size_t i = worker; i < chains_.size(); i += workers) {
+        uint64_t started = CpuAccounting::isEnabled() ? CpuAccounting::readCycles() : 0;
+        chains_[i].chain->step(dt_);
+        if (started != 0) {
+            chargePhysics(chains_[i].indices, CpuAccounting::readCycles() - started);
+        }
+    }
+}
+
+void SimulationEngine::startChainWorkers() {
+    if (!chainWorkers_.empty()) {
+        return;
+    }
+
+    // Spinning peers only pay off with a core each
+    uint32_t workers = std::min<uint32_t>(chainThreads_, static_cast<uint32_t>(chains_.size()));
+    workers = std::min(workers, std::max(1U, std::thread::hardware_concurrency()));
+    if (workers < 2) {
+        return;
+    }
+
+    chainWorkersRunning_ = true;
+    for (uint32_t worker = 1; worker < workers; ++worker) {
+        chainWorkers_.emplace_back(&SimulationEngine::chainWorkerLoop, this, worker, workers);
+    }
+}
+
+void SimulationEngine::stopChainWorkers() {
+    chainWorkersRunning_ = false;
+    for (auto& worker : chainWorkers_) {
+        worker.join();
+    }
+    chainWorkers_.clear();
+}
+
+void SimulationEngine::chainWorkerLoop(uint32_t worker, uint32_t workers) {
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
+    uint64_t seen = chainRound_.load(std::memory_order_acquire);
+    int spins = 0;
+    while (chainWorkersRunning_.load(std::memory_order_relaxed)) {
+        uint64_t round = chainRound_.load(std::memory_order_acquire);
+        if (round == seen) {
+            cpuRelax(spins);
+            continue;
+        }
+        seen = round;
+        spins = 0;
+        {
+            HotPath hot_path;
+            stepChainShare(worker, workers);
+        }
+        chainPending_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+size_t SimulationEngine::measureHeapBytesPerServo() {
+    size_t bytes = servos_.empty() ? 0 : heapInUse() / servos_.size();
+    heapBytesPerServo_.set(static_cast<double>(bytes));
+    return bytes;
 }
 
 bool SimulationEngine::isRunning() const {
@@ -75,6 +493,76 @@ double SimulationEngine::getSimulationFrequency() const {
     return simulationFrequencyHz_;
 }
 
+void SimulationEngine::setIntegrationAccuracy(double accuracy) {
+    integrationAccuracy_ = std::max(0.0, accuracy);
+    kernelGroups_.clear();
+}
+
+uint32_t SimulationEngine::getIntegrationDecimation(size_t index) const {
+    getServo(index); // Range check
+    return integrationDecimation(index);
+}
+
+void SimulationEngine::setSimulationFrequency(double frequency_hz) {
+    if (frequency_hz <= 0.0) {
+        LOG_WARNING("SimulationEngine: Invalid simulation frequency %g Hz, keeping %g Hz", frequency_hz,
+                    simulationFrequencyHz_);
+        return;
+    }
+    simulationFrequencyHz_ = frequency_hz;
+    dt_ = 1.0 / frequency_hz;
+    kernelGroups_.clear();
+}
+
+void SimulationEngine::addChain(const KinematicChain::Config& config, const std::vector<size_t>& servo_indices) {
+    if (servo_indices.size() != config.joints.size()) {
+        throw std::invalid_argument("Chain '" + config.name + "' needs one servo per joint");
+    }
+    for (size_t index : servo_indices) {
+        if (index >= servos_.size()) {
+            throw std::out_of_range("Servo index out of range");
+        }
+        for (const auto& spec : chainSpecs_) {
+            if (std::find(spec.servoIndices.begin(), spec.servoIndices.end(), index) != spec.servoIndices.end()) {
+                throw std::invalid_argument("Servo " + std::to_string(index) + " already drives chain '" +
+                                            spec.config.name + "'");
+            }
+        }
+    }
+    chainSpecs_.push_back({config, servo_indices});
+    kernelGroups_.clear();
+    chains_.clear();
+}
+
+size_t SimulationEngine::getChainCount() const {
+    return chainSpecs_.size();
+}
+
+void SimulationEngine::setChainThreads(uint32_t threads) {
+    chainThreads_ = std::max<uint32_t>(1, threads);
+}
+
+bool SimulationEngine::addLoadProfile(size_t index, const std::string& path, uint32_t channel, double scale,
+                                      bool loop) {
+    Servo& servo = getServo(index);
+    if (servo.isFixedPoint()) {
+        LOG_WARNING("SimulationEngine: Servo %zu uses fixed-point physics, which ignores load profiles", index);
+    }
+
+    auto profile = std::make_unique<LoadProfile>(path, channel, loop);
+    if (!profile->open()) {
+        return false;
+    }
+
+    // Servos are heap-allocated, so the pointer survives servos_ changing
+    loadProfiles_.add(std::move(profile), &servo.getMotor(), scale);
+    return true;
+}
+
+const LoadProfilePlayer& SimulationEngine::getLoadProfiles() const {
+    return loadProfiles_;
+}
+
 Motor& SimulationEngine::getMotor(size_t index) {
     return getServo(index).getMotor();
 }
@@ -83,13 +571,319 @@ Encoder& SimulationEngine::getEncoder(size_t index) {
     return getServo(index).getEncoder();
 }
 
+const std::map<std::string, std::shared_ptr<CanBus>>& SimulationEngine::getCanBuses() const {
+    return canBuses_;
+}
+
+void SimulationEngine::enableStateMirror(const std::string& name) {
+    stateMirrorName_ = name;
+}
+
+uint64_t SimulationEngine::getTick() const {
+    return tick_.load(std::memory_order_relaxed);
+}
+
+void SimulationEngine::enableTelemetry(const std::string& path, const std::vector<size_t>& servo_indices) {
+    telemetryPath_ = path;
+    telemetryIndices_ = servo_indices;
+    kernelGroups_.clear(); // Captured servos integrate every tick
+    chains_.clear();
+}
+
+const TelemetryRecorder* SimulationEngine::getTelemetry() const {
+    return telemetry_.get();
+}
+
+bool SimulationEngine::capturesTelemetry(size_t index) const {
+    if (telemetryPath_.empty()) {
+        return false;
+    }
+    return telemetryIndices_.empty() ||
+           std::find(telemetryIndices_.begin(), telemetryIndices_.end(), index) != telemetryIndices_.end();
+}
+
+void SimulationEngine::startTelemetry() {
+    if (telemetryPath_.empty() || telemetry_) {
+        return;
+    }
+
+    std::vector<Servo*> servos;
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i < servos_.size(); ++i) {
+        if (capturesTelemetry(i)) {
+            servos.push_back(servos_[i].get());
+            indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    telemetry_ = std::make_unique<TelemetryRecorder>(telemetryPath_, servos, indices, simulationFrequencyHz_);
+    if (!telemetry_->start()) {
+        telemetry_.reset();
+        return;
+    }
+    telemetryRing_ = telemetry_->registerProducer();
+
+    // The capture set is fixed now; servos added later are not recorded
+    if (telemetryIndices_.empty()) {
+        telemetryIndices_.assign(indices.begin(), indices.end());
+    }
+}
+
+void SimulationEngine::enableSync(uint32_t sync_id) {
+    syncId_ = sync_id;
+}
+
+void SimulationEngine::createSyncGroups() {
+    if (syncId_ == 0 || !syncGroups_.empty()) {
+        return;
+    }
+
+    // One group per interface; the first board on each interface listens for SYNC
+    std::map<std::string, SyncGroup*> groups_by_interface;
+    for (auto& servo : servos_) {
+        CanBoard* board = servo->getCanBoard();
+        if (!board) {
+            continue;
+        }
+
+        const std::string& interface_name = board->getTransport().getInterfaceName();
+        SyncGroup*& group = groups_by_interface[interface_name];
+        bool listener = false;
+        if (!group) {
+            syncGroups_.push_back(std::make_unique<SyncGroup>(syncId_));
+            group = syncGroups_.back().get();
+            listener = true;
+        }
+        group->addBoard(board);
+        board->setSyncGroup(group, listener);
+    }
+
+    for (auto& group : syncGroups_) {
+        group->start();
+    }
+}
+
+void SimulationEngine::createKernelGroups() {
+    publishAllLanes();
+    kernelGroups_.clear();
+    chains_.clear();
+
+    // Physics is charged to the servo's board, so one owner sums all of a servo's work
+    while (physicsCpu_.size() < servos_.size()) {
+        size_t index = physicsCpu_.size();
+        const CanBoard* board = servos_[index]->getCanBoard();
+        physicsCpu_.push_back(CpuAccounting::instance().account(
+            board ? board->getCpuOwner() : "servo " + std::to_string(index), CpuAccounting::Activity::Physics));
+    }
+
+    // Chains take over their servos' physics, and pick up from the servos' current state
+    std::vector<bool> chained(servos_.size(), false);
+    for (const auto& spec : chainSpecs_) {
+        ChainInstance instance;
+        std::vector<Servo*> servos;
+        for (size_t index : spec.servoIndices) {
+            Servo& servo = *servos_[index];
+            if (servo.isFixedPoint() || servo.isElectromechanical()) {
+                LOG_WARNING("SimulationEngine: Servo %zu drives chain '%s', its own motor model is not used", index,
+                            spec.config.name.c_str());
+            }
+            servos.push_back(&servo);
+            instance.indices.push_back(static_cast<uint32_t>(index));
+            if (CanBoard* board = servo.getCanBoard()) {
+                board->attachIntegrationClock(&chainClock_);
+                instance.boards.push_back(board);
+                instance.boardServos.push_back(&servo);
+            }
+            chained[index] = true;
+        }
+        instance.chain = std::make_unique<KinematicChain>(spec.config, servos);
+        chains_.push_back(std::move(instance));
+    }
+
+    // Clocks are reused by group position: every group is at the current tick here,
+    // so a board timer still reading a clock of the previous grouping sees this tick
+    uint64_t tick = tick_.load(std::memory_order_relaxed);
+    chainClock_.beginStep();
+    chainClock_.endStep(tick);
+    for (size_t i = 0; i < servos_.size(); ++i) {
+        if (chained[i]) {
+            continue;
+        }
+        uint32_t decimation = integrationDecimation(i);
+        ServoKernel kernel = selectServoKernel(*servos_[i], decimation > 1);
+        auto group = std::find_if(kernelGroups_.begin(), kernelGroups_.end(), [&](const KernelGroup& g) {
+            return g.kernel == kernel && g.decimation == decimation;
+        });
+        if (group == kernelGroups_.end()) {
+            if (groupClocks_.size() == kernelGroups_.size()) {
+                groupClocks_.push_back(std::make_unique<IntegrationClock>());
+            }
+            IntegrationClock* clock = groupClocks_[kernelGroups_.size()].get();
+            clock->beginStep();
+            clock->endStep(tick);
+            KernelGroup created;
+            created.kernel = kernel;
+            created.decimation = decimation;
+            created.lastTick = tick;
+            created.clock = clock;
+            created.publishDivider = 1;
+            created.publishedTick = tick;
+            kernelGroups_.push_back(std::move(created));
+            group = kernelGroups_.end() - 1;
+        }
+        if (CanBoard* board = servos_[i]->getCanBoard()) {
+            board->attachIntegrationClock(group->clock);
+            group->boards.push_back(board);
+            group->boardServos.push_back(static_cast<uint32_t>(group->servos.size()));
+        }
+        group->servos.push_back(servos_[i].get());
+        group->indices.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Fixed-point groups are stepped as lanes, picking up from the servos' current state
+    for (auto& group : kernelGroups_) {
+        if (group.servos.front()->isFixedPoint()) {
+            group.lanes = std::make_unique<FixedPointLanes>();
+            group.lanes->load(group.servos, dt_);
+            group.publishDivider = publishDivider(group);
+        }
+    }
+}
+
+uint32_t SimulationEngine::integrationDecimation(size_t index) const {
+    // Fixed-point servos keep a constant step so their results stay bit-exact; the
+    // electromechanical model's dynamics are not described by timeConstant; telemetry
+    // records the state of every tick; a load profile changes the load every tick
+    const Servo& servo = *servos_[index];
+    if (integrationAccuracy_ <= 0.0 || servo.isFixedPoint() || servo.isElectromechanical() ||
+        capturesTelemetry(index) || loadProfiles_.drives(&servo.getMotor())) {
+        return 1;
+    }
+
+    double max_step = std::min(integrationAccuracy_ * servo.getMotor().getMotorTimeConstant(),
+                               observationStep(servo));
+
+    // Powers of two, so every group steps on the ticks of the coarser groups
+    uint32_t decimation = 1;
+    while (decimation < MAX_INTEGRATION_DECIMATION && (decimation * 2) * dt_ <= max_step) {
+        decimation *= 2;
+    }
+    return decimation;
+}
+
+double SimulationEngine::observationStep(const Servo& servo) const {
+    // Board observations (and the hold loop's actuation) should see state at most
+    // a quarter of their period old
+    const CanBoard* board = servo.getCanBoard();
+    if (!board) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const BoardTimerRates& rates = board->getTimerRates();
+    double fastest_hz = std::max({rates.encoderReadHz, rates.controlUpdateHz, rates.canTransmitHz,
+                                  board->getPositionHoldRate()});
+    return 0.25 / fastest_hz;
+}
+
+uint32_t SimulationEngine::publishDivider(const KernelGroup& group) const {
+    // The state mirror and telemetry read every tick's state
+    if (stateMirror_) {
+        return 1;
+    }
+    uint32_t divider = MAX_INTEGRATION_DECIMATION;
+    for (size_t i = 0; i < group.servos.size(); ++i) {
+        if (capturesTelemetry(group.indices[i])) {
+            return 1;
+        }
+        double ticks = std::floor(observationStep(*group.servos[i]) / dt_);
+        divider = ticks < divider ? std::max(1U, static_cast<uint32_t>(ticks)) : divider;
+    }
+    return divider;
+}
+
+void SimulationEngine::createCanBuses() {
+    for (auto& servo : servos_) {
+        if (CanBoard* board = servo->getCanBoard()) {
+            attachCanBus(*board);
+        }
+    }
+
+    for (auto& entry : canBuses_) {
+        entry.second->start();
+    }
+}
+
+void SimulationEngine::attachCanBus(CanBoard& board) {
+    // One bus model per interface, shared by every board that asks for timing
+    if (board.getCanBitrate() == 0) {
+        return;
+    }
+
+    // addServo() refused boards at another bitrate than the interface's
+    const std::string& interface_name = board.getTransport().getInterfaceName();
+    auto& bus = canBuses_[interface_name];
+    if (!bus) {
+        bus = std::make_shared<CanBus>(interface_name, board.getCanBitrate());
+    }
+    board.attachBus(bus);
+}
+
+void SimulationEngine::claimCanBitrate(Servo& servo) {
+    CanBoard* board = servo.getCanBoard();
+    if (!board || board->getCanBitrate() == 0) {
+        return;
+    }
+
+    // The first board modeling an interface fixes its bitrate for the engine's lifetime
+    const std::string& interface_name = board->getTransport().getInterfaceName();
+    auto claimed = canBitrates_.emplace(interface_name, board->getCanBitrate());
+    if (claimed.first->second != board->getCanBitrate()) {
+        throw std::invalid_argument("CAN ID 0x" + toHex(board->getCanId()) + " requests " +
+                                    std::to_string(board->getCanBitrate()) + " bit/s on " + interface_name +
+                                    ", which runs at " + std::to_string(claimed.first->second) + " bit/s");
+    }
+}
+
 void SimulationEngine::simulationLoop() {
     auto next_update = std::chrono::steady_clock::now();
-    constexpr auto update_interval = std::chrono::microseconds(static_cast<long>(1000000.0 / simulationFrequencyHz_));
+    const auto update_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(dt_));
+    // Keep a few seconds of ticks, not just the last 16k
+    Tracer::nameThread("physics", Tracer::DEFAULT_RING_EVENTS * 16);
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
 
     while (running_) {
-        update();
+        if (editPending_.load(std::memory_order_acquire)) {
+            TraceSpan span("edit");
+            applyPendingEdit();
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        {
+            TraceSpan span("update");
+            HotPath hot_path;
+            update();
+        }
+        auto finished = std::chrono::steady_clock::now();
+        tickDuration_.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started).count()));
+
         next_update += update_interval;
+        if (finished > next_update) {
+            tickOverruns_.add();
+        }
         std::this_thread::sleep_until(next_update);
     }
-}
\ No newline at end of file
+
+    // An edit that arrived while stopping still runs; later ones run on their caller
+    std::lock_guard<std::mutex> lock(editMutex_);
+    physicsRunning_ = false;
+    if (pendingEdit_) {
+        (*pendingEdit_)();
+        kernelGroups_.clear();
+        chains_.clear();
+        pendingEdit_ = nullptr;
+        editPending_.store(false, std::memory_order_relaxed);
+    }
+    editDone_.notify_all();
+}
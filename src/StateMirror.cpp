@@ -0,0 +1,94 @@
+#include "StateMirror.h"
+#include "Servo.h"
+#include "CanBoard.h"
+#include "Logger.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+StateMirror::StateMirror(const std::string& name)
+    : path_(stateMirrorPath(name)), header_(nullptr), entries_(nullptr), servo_count_(0), size_(0) {
+}
+
+StateMirror::~StateMirror() {
+    close();
+}
+
+bool StateMirror::open(uint32_t servo_count, double simulation_frequency_hz) {
+    if (header_) {
+        return true;
+    }
+
+    int fd = shm_open(path_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        LOG_ERROR("StateMirror: Failed to create segment %s: %s", path_.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    size_ = stateMirrorSize(servo_count);
+    if (ftruncate(fd, static_cast<off_t>(size_)) < 0) {
+        LOG_ERROR("StateMirror: Failed to size segment %s: %s", path_.c_str(), std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("StateMirror: Failed to map segment %s: %s", path_.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    std::memset(mapping, 0, size_);
+    header_ = static_cast<StateMirrorHeader*>(mapping);
+    entries_ = stateMirrorEntries(header_);
+    servo_count_ = servo_count;
+
+    header_->version = STATE_MIRROR_VERSION;
+    header_->servo_count = servo_count;
+    header_->entry_size = sizeof(StateMirrorEntry);
+    header_->simulation_frequency_hz = simulation_frequency_hz;
+    header_->tick.store(0, std::memory_order_relaxed);
+    header_->magic.store(STATE_MIRROR_MAGIC, std::memory_order_release);
+    return true;
+}
+
+void StateMirror::close() {
+    if (!header_) {
+        return;
+    }
+
+    header_->magic.store(0, std::memory_order_release);
+    munmap(header_, size_);
+    shm_unlink(path_.c_str());
+    header_ = nullptr;
+    entries_ = nullptr;
+    servo_count_ = 0;
+}
+
+bool StateMirror::isOpen() const {
+    return header_ != nullptr;
+}
+
+void StateMirror::publish(uint32_t index, const Servo& servo, uint64_t tick) {
+    if (index >= servo_count_) {
+        return;
+    }
+
+    ServoStateSnapshot state;
+    state.canId = servo.getCanBoard() ? servo.getCanBoard()->getCanId() : 0;
+    state.controlSignal = servo.getControlSignal();
+    state.tick = tick;
+    state.encoderSteps = servo.getEncoderPosition();
+    state.angularPosition = servo.getAngularPosition();
+    state.angularVelocity = servo.getAngularVelocity();
+    state.encoderRadians = servo.getEncoderPositionRadians();
+    entries_[index].write(state);
+}
+
+void StateMirror::commitTick(uint64_t tick) {
+    header_->tick.store(tick, std::memory_order_release);
+}
@@ -0,0 +1,99 @@
+#include "SyncGroup.h"
+#include "CanBoard.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+SyncGroup::SyncGroup(uint32_t sync_id)
+    : sync_id_(sync_id), sync_requested_(false), running_(false), pending_bursts_(0), sync_count_(0) {
+}
+
+SyncGroup::~SyncGroup() {
+    stop();
+}
+
+void SyncGroup::addBoard(CanBoard* board) {
+    boards_.push_back(board);
+}
+
+void SyncGroup::start() {
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    sender_thread_ = std::thread(&SyncGroup::senderLoop, this);
+}
+
+void SyncGroup::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    burst_cv_.notify_all();
+
+    if (sender_thread_.joinable()) {
+        sender_thread_.join();
+    }
+}
+
+void SyncGroup::requestSync() {
+    sync_requested_.store(true, std::memory_order_release);
+}
+
+bool SyncGroup::isSyncRequested() const {
+    return sync_requested_.load(std::memory_order_relaxed);
+}
+
+bool SyncGroup::latchIfRequested(uint64_t tick) {
+    if (!sync_requested_.load(std::memory_order_relaxed) ||
+        !sync_requested_.exchange(false, std::memory_order_acquire)) {
+        return false;
+    }
+
+    for (CanBoard* board : boards_) {
+        board->latchStatus(tick);
+    }
+    sync_count_.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_bursts_;
+    }
+    burst_cv_.notify_one();
+    return true;
+}
+
+uint32_t SyncGroup::getSyncId() const {
+    return sync_id_;
+}
+
+uint64_t SyncGroup::getSyncCount() const {
+    return sync_count_.load(std::memory_order_relaxed);
+}
+
+void SyncGroup::senderLoop() {
+    Logger::instance().prepareThread();
+    Metrics::prepareThread();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (running_) {
+        burst_cv_.wait(lock, [this]() { return !running_ || pending_bursts_ > 0; });
+        if (!running_) {
+            break;
+        }
+
+        // A burst still queued when a newer SYNC latches is superseded by it
+        pending_bursts_ = 0;
+        lock.unlock();
+        {
+            HotPath hot_path;
+            for (CanBoard* board : boards_) {
+                board->transmitLatchedStatus();
+            }
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,145 @@
+#include "TelemetryFormat.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decode a telemetry capture to CSV
+ *
+ * Usage: telemetry_reader <file> [servo index]
+ * Prints tick,servo,position,velocity,control,steps for every captured tick, limited
+ * to one servo (engine index) if given, and a summary on stderr.
+ */
+
+namespace {
+
+bool readColumn(FILE* file, std::vector<uint8_t>& column) {
+    uint32_t length;
+    if (std::fread(&length, sizeof(length), 1, file) != 1) {
+        return false;
+    }
+    column.resize(length);
+    return length == 0 || std::fread(column.data(), 1, length, file) == length;
+}
+
+bool decodeVarints(const std::vector<uint8_t>& column, size_t count, std::vector<int64_t>& values) {
+    values.resize(count);
+    const uint8_t* data = column.data();
+    const uint8_t* end = data + column.size();
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t encoded;
+        if (!readVarint(data, end, encoded)) {
+            return false;
+        }
+        values[i] = zigzagDecode(encoded);
+    }
+    return true;
+}
+
+void decodeFloats(const std::vector<uint8_t>& column, size_t count, std::vector<double>& values) {
+    values.resize(count);
+    BitReader reader(column.data(), column.size());
+    XorFloatDecoder decoder;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = decoder.decode(reader);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file> [servo index]" << std::endl;
+        return 1;
+    }
+    long only_servo = argc > 2 ? std::strtol(argv[2], nullptr, 10) : -1;
+
+    FILE* file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TelemetryFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || header.magic != TELEMETRY_FILE_MAGIC ||
+        header.version != TELEMETRY_VERSION) {
+        std::cerr << argv[1] << " is not a telemetry capture" << std::endl;
+        std::fclose(file);
+        return 1;
+    }
+    std::vector<uint32_t> indices(header.servoCount);
+    if (header.servoCount > 0 && std::fread(indices.data(), sizeof(uint32_t), header.servoCount, file) != header.servoCount) {
+        std::cerr << argv[1] << " is truncated" << std::endl;
+        std::fclose(file);
+        return 1;
+    }
+
+    std::printf("tick,servo,position,velocity,control,steps\n");
+
+    std::vector<uint8_t> column;
+    std::vector<int64_t> tick_deltas;
+    std::vector<std::vector<int64_t>> controls(header.servoCount), steps(header.servoCount);
+    std::vector<std::vector<double>> positions(header.servoCount), velocities(header.servoCount);
+    std::vector<uint64_t> ticks;
+    uint64_t total_ticks = 0;
+    uint64_t blocks = 0;
+    TelemetryBlockHeader block;
+    while (std::fread(&block, sizeof(block), 1, file) == 1) {
+        if (block.magic != TELEMETRY_BLOCK_MAGIC || block.tickCount == 0) {
+            std::cerr << "Corrupt block after " << total_ticks << " ticks" << std::endl;
+            break;
+        }
+        const size_t count = block.tickCount;
+
+        if (!readColumn(file, column) || !decodeVarints(column, count - 1, tick_deltas)) {
+            std::cerr << "Truncated block after " << total_ticks << " ticks" << std::endl;
+            break;
+        }
+        ticks.resize(count);
+        ticks[0] = block.firstTick;
+        int64_t delta = 1;
+        for (size_t t = 1; t < count; ++t) {
+            delta += tick_deltas[t - 1];
+            ticks[t] = ticks[t - 1] + static_cast<uint64_t>(delta);
+        }
+
+        // Columns are servo-major; decode the whole block, then print it tick by tick
+        bool complete = true;
+        for (uint32_t s = 0; s < header.servoCount && complete; ++s) {
+            complete = readColumn(file, column);
+            if (complete) decodeFloats(column, count, positions[s]);
+            complete = complete && readColumn(file, column);
+            if (complete) decodeFloats(column, count, velocities[s]);
+            complete = complete && readColumn(file, column) && decodeVarints(column, count, controls[s]);
+            complete = complete && readColumn(file, column) && decodeVarints(column, count, steps[s]);
+            for (size_t t = 1; complete && t < count; ++t) {
+                controls[s][t] += controls[s][t - 1];
+                steps[s][t] += steps[s][t - 1];
+            }
+        }
+
+        for (size_t t = 0; complete && t < count; ++t) {
+            for (uint32_t s = 0; s < header.servoCount; ++s) {
+                if (only_servo >= 0 && indices[s] != static_cast<uint32_t>(only_servo)) {
+                    continue;
+                }
+                std::printf("%llu,%u,%.17g,%.17g,%lld,%lld\n", static_cast<unsigned long long>(ticks[t]), indices[s],
+                            positions[s][t], velocities[s][t], static_cast<long long>(controls[s][t]),
+                            static_cast<long long>(steps[s][t]));
+            }
+        }
+        if (!complete) {
+            std::cerr << "Truncated block after " << total_ticks << " ticks" << std::endl;
+            break;
+        }
+        total_ticks += count;
+        ++blocks;
+    }
+    std::fclose(file);
+
+    std::cerr << blocks << " blocks, " << total_ticks << " ticks of " << header.servoCount << " servos at "
+              << header.tickRateHz << " Hz" << std::endl;
+    return 0;
+}
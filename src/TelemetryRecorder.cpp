@@ -0,0 +1,239 @@
+#include "TelemetryRecorder.h"
+#include "Servo.h"
+#include "Logger.h"
+#include <chrono>
+
+TelemetryRing::TelemetryRing(uint32_t servo_count, uint64_t capacity)
+    : record_size_(sizeof(uint64_t) + servo_count * sizeof(TelemetrySample)), capacity_(capacity),
+      head_(0), tail_(0), dropped_(0) {
+    storage_.resize(record_size_ * capacity_);
+}
+
+TelemetrySample* TelemetryRing::beginRecord(uint64_t tick) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    uint8_t* slot = record(head);
+    std::memcpy(slot, &tick, sizeof(tick));
+    return reinterpret_cast<TelemetrySample*>(slot + sizeof(uint64_t));
+}
+
+const TelemetrySample* TelemetryRing::peekRecord(uint64_t& tick) const {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    const uint8_t* slot = record(tail);
+    std::memcpy(&tick, slot, sizeof(tick));
+    return reinterpret_cast<const TelemetrySample*>(slot + sizeof(uint64_t));
+}
+
+TelemetryRecorder::TelemetryRecorder(const std::string& path, const std::vector<Servo*>& servos,
+                                     const std::vector<uint32_t>& indices, double tick_rate_hz)
+    : path_(path), servos_(servos), indices_(indices), tick_rate_hz_(tick_rate_hz), file_(nullptr),
+      bytes_written_(0), ticks_written_(0), running_(false) {}
+
+TelemetryRecorder::~TelemetryRecorder() {
+    stop();
+}
+
+bool TelemetryRecorder::start() {
+    if (running_) {
+        return true;
+    }
+
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (!file_) {
+        LOG_ERROR("TelemetryRecorder: Cannot create %s", path_.c_str());
+        return false;
+    }
+
+    TelemetryFileHeader header = {TELEMETRY_FILE_MAGIC, TELEMETRY_VERSION, tick_rate_hz_,
+                                  static_cast<uint32_t>(servos_.size()), 0};
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(indices_.data(), sizeof(uint32_t), indices_.size(), file_);
+    bytes_written_ = sizeof(header) + indices_.size() * sizeof(uint32_t);
+
+    running_ = true;
+    writer_thread_ = std::thread(&TelemetryRecorder::writerLoop, this);
+    return true;
+}
+
+void TelemetryRecorder::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    // Producers are stopped, so this drain sees everything they captured
+    drain();
+    for (Block& block : blocks_) {
+        writeBlock(block);
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+TelemetryRing* TelemetryRecorder::registerProducer() {
+    // Largest power-of-two tick count within the byte budget
+    size_t record_size = sizeof(uint64_t) + servos_.size() * sizeof(TelemetrySample);
+    uint64_t capacity = MIN_RING_TICKS;
+    while (capacity * 2 * record_size <= RING_BYTES) {
+        capacity *= 2;
+    }
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.push_back(std::make_unique<TelemetryRing>(static_cast<uint32_t>(servos_.size()), capacity));
+    return rings_.back().get();
+}
+
+void TelemetryRecorder::capture(TelemetryRing& ring, uint64_t tick) {
+    TelemetrySample* samples = ring.beginRecord(tick);
+    if (!samples) {
+        return;
+    }
+
+    const size_t count = servos_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Servo& servo = *servos_[i];
+        samples[i].position = servo.getAngularPosition();
+        samples[i].velocity = servo.getAngularVelocity();
+        samples[i].control = servo.getControlSignal();
+        samples[i].steps = static_cast<int32_t>(servo.getEncoderPosition());
+    }
+    ring.commitRecord();
+}
+
+uint64_t TelemetryRecorder::getDropped() const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    uint64_t dropped = 0;
+    for (const auto& ring : rings_) {
+        dropped += ring->getDropped();
+    }
+    return dropped;
+}
+
+void TelemetryRecorder::writerLoop() {
+    while (running_) {
+        if (!drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_IDLE_MS));
+        }
+    }
+}
+
+bool TelemetryRecorder::drain() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    blocks_.resize(rings_.size());
+
+    const size_t servo_count = servos_.size();
+    bool drained_any = false;
+    for (size_t r = 0; r < rings_.size(); ++r) {
+        TelemetryRing& ring = *rings_[r];
+        Block& block = blocks_[r];
+
+        uint64_t tick;
+        while (const TelemetrySample* samples = ring.peekRecord(tick)) {
+            if (block.ticks.empty()) {
+                block.firstTick = tick;
+            }
+            block.ticks.push_back(tick);
+            block.samples.insert(block.samples.end(), samples, samples + servo_count);
+            ring.popRecord();
+            drained_any = true;
+
+            if (block.ticks.size() == TELEMETRY_BLOCK_TICKS) {
+                writeBlock(block);
+            }
+        }
+    }
+    return drained_any;
+}
+
+void TelemetryRecorder::writeBlock(Block& block) {
+    if (block.ticks.empty()) {
+        return;
+    }
+
+    const size_t tick_count = block.ticks.size();
+    const size_t servo_count = servos_.size();
+    encoded_.clear();
+
+    auto beginColumn = [this]() {
+        size_t at = encoded_.size();
+        encoded_.resize(at + sizeof(uint32_t));
+        return at;
+    };
+    auto endColumn = [this](size_t at) {
+        uint32_t length = static_cast<uint32_t>(encoded_.size() - at - sizeof(uint32_t));
+        std::memcpy(encoded_.data() + at, &length, sizeof(length));
+    };
+
+    TelemetryBlockHeader header = {TELEMETRY_BLOCK_MAGIC, static_cast<uint32_t>(tick_count), block.firstTick};
+    encoded_.resize(sizeof(header));
+    std::memcpy(encoded_.data(), &header, sizeof(header));
+
+    // Ticks: delta-of-delta, 0 for every consecutive tick
+    size_t column = beginColumn();
+    int64_t previous_delta = 1;
+    for (size_t t = 1; t < tick_count; ++t) {
+        int64_t delta = static_cast<int64_t>(block.ticks[t] - block.ticks[t - 1]);
+        appendVarint(encoded_, zigzagEncode(delta - previous_delta));
+        previous_delta = delta;
+    }
+    endColumn(column);
+
+    for (size_t s = 0; s < servo_count; ++s) {
+        const TelemetrySample* samples = block.samples.data() + s;
+
+        column = beginColumn();
+        {
+            BitWriter writer(encoded_);
+            XorFloatEncoder encoder;
+            for (size_t t = 0; t < tick_count; ++t) {
+                encoder.encode(writer, samples[t * servo_count].position);
+            }
+            writer.flush();
+        }
+        endColumn(column);
+
+        column = beginColumn();
+        {
+            BitWriter writer(encoded_);
+            XorFloatEncoder encoder;
+            for (size_t t = 0; t < tick_count; ++t) {
+                encoder.encode(writer, samples[t * servo_count].velocity);
+            }
+            writer.flush();
+        }
+        endColumn(column);
+
+        column = beginColumn();
+        int32_t previous = 0;
+        for (size_t t = 0; t < tick_count; ++t) {
+            int32_t control = samples[t * servo_count].control;
+            appendVarint(encoded_, zigzagEncode(static_cast<int64_t>(control) - previous));
+            previous = control;
+        }
+        endColumn(column);
+
+        column = beginColumn();
+        previous = 0;
+        for (size_t t = 0; t < tick_count; ++t) {
+            int32_t steps = samples[t * servo_count].steps;
+            appendVarint(encoded_, zigzagEncode(static_cast<int64_t>(steps) - previous));
+            previous = steps;
+        }
+        endColumn(column);
+    }
+
+    std::fwrite(encoded_.data(), 1, encoded_.size(), file_);
+    bytes_written_ += encoded_.size();
+    ticks_written_ += tick_count;
+    block.ticks.clear();
+    block.samples.clear();
+}
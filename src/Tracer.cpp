@@ -0,0 +1,194 @@
+#include "Tracer.h"
+#include "Logger.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+std::atomic<bool> Tracer::enabled_{false};
+std::string Tracer::path_;
+sem_t Tracer::dump_request_;
+std::thread Tracer::dumper_;
+std::atomic<bool> Tracer::dumper_running_{false};
+struct sigaction Tracer::previous_action_;
+std::mutex Tracer::mutex_;
+std::vector<std::shared_ptr<Tracer::Ring>> Tracer::rings_;
+std::set<std::string> Tracer::names_;
+thread_local Tracer::Ring* Tracer::thread_ring_ = nullptr;
+
+void Tracer::enable(const std::string& path) {
+    if (dumper_running_) {
+        return;
+    }
+    path_ = path;
+    enabled_ = true;
+
+    sem_init(&dump_request_, 0, 0);
+    dumper_running_ = true;
+    dumper_ = std::thread(&Tracer::dumperLoop);
+
+    struct sigaction action = {};
+    action.sa_handler = &Tracer::onDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, &previous_action_);
+}
+
+void Tracer::shutdown() {
+    if (!dumper_running_.exchange(false)) {
+        return;
+    }
+    sigaction(SIGUSR1, &previous_action_, nullptr);
+    sem_post(&dump_request_);
+    dumper_.join();
+    sem_destroy(&dump_request_);
+
+    enabled_ = false;
+    if (write(path_)) {
+        LOG_INFO("Tracer: Trace written to %s", path_.c_str());
+    }
+}
+
+void Tracer::onDumpSignal(int) {
+    // Only async-signal-safe work here; the dumper thread writes the file
+    sem_post(&dump_request_);
+}
+
+void Tracer::dumperLoop() {
+    unsigned dumps = 0;
+    while (true) {
+        if (sem_wait(&dump_request_) != 0) {
+            continue; // EINTR
+        }
+        if (!dumper_running_) {
+            return;
+        }
+        std::string path = path_ + "." + std::to_string(++dumps);
+        if (write(path)) {
+            LOG_INFO("Tracer: Trace written to %s", path.c_str());
+        }
+    }
+}
+
+void Tracer::nameThread(const std::string& name, size_t ring_events) {
+    if (!isEnabled()) {
+        return;
+    }
+    Ring* ring = threadRing(ring_events);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring->threadName = name;
+}
+
+const char* Tracer::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.insert(name).first->c_str();
+}
+
+Tracer::Ring* Tracer::threadRing(size_t ring_events) {
+    if (!thread_ring_) {
+        // Rings outlive their threads, so a dump at exit still shows them
+        auto ring = std::make_shared<Ring>();
+        ring->tid = static_cast<long>(syscall(SYS_gettid));
+        ring->threadName = "thread " + std::to_string(ring->tid);
+        ring->events.resize(std::max<size_t>(ring_events, 1));
+        thread_ring_ = ring.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(std::move(ring));
+    }
+    return thread_ring_;
+}
+
+void Tracer::record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t id) {
+    Ring* ring = thread_ring_ ? thread_ring_ : threadRing(DEFAULT_RING_EVENTS);
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t duration = end_ns - start_ns;
+    ring->events[head % ring->events.size()] = {name, start_ns,
+                                                 static_cast<uint32_t>(std::min<uint64_t>(duration, UINT32_MAX)), id};
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+namespace {
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+bool Tracer::write(const std::string& path) {
+    std::string temporary = path + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Tracer: Cannot create %s: %s", temporary.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings = rings_;
+    }
+
+    const int pid = static_cast<int>(getpid());
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<Event> events;
+    for (const auto& ring : rings) {
+        std::string thread_name;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            thread_name = ring->threadName;
+        }
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", pid, ring->tid, jsonEscape(thread_name).c_str());
+        first = false;
+
+        // The owning thread keeps recording while we copy; afterwards, drop the
+        // oldest events, whose slots it may have overwritten in the meantime
+        const uint64_t size = ring->events.size();
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > size ? head - size : 0;
+        events.clear();
+        for (uint64_t index = begin; index < head; ++index) {
+            events.push_back(ring->events[index % size]);
+        }
+        uint64_t head_after = ring->head.load(std::memory_order_acquire);
+        uint64_t valid_from = head_after >= size ? head_after - size + 1 : 0;
+        size_t skip = static_cast<size_t>(std::min<uint64_t>(valid_from > begin ? valid_from - begin : 0, events.size()));
+
+        for (size_t i = skip; i < events.size(); ++i) {
+            const Event& event = events[i];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"sim\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld",
+                         jsonEscape(event.name).c_str(), static_cast<double>(event.startNs) * 1e-3,
+                         static_cast<double>(event.durationNs) * 1e-3, pid, ring->tid);
+            if (event.id != 0) {
+                std::fprintf(file, ",\"args\":{\"id\":\"0x%x\"}", event.id);
+            }
+            std::fprintf(file, "}");
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool written = !std::ferror(file);
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("Tracer: Cannot write %s: %s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    return true;
+}
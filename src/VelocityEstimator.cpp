@@ -0,0 +1,103 @@
+#include "VelocityEstimator.h"
+#include <algorithm>
+#include <cmath>
+
+VelocityEstimator::VelocityEstimator()
+    : method_(Method::Model), half_revolution_q16_(0), revolution_mask_q16_(0), sample_rate_q16_(0),
+      sample_period_q24_(0), rpm_x100_numerator_(6000), rpm_x100_denominator_(1), last_steps_(0),
+      window_sum_(0), window_{}, window_index_(0), window_mask_(0), window_shift_(0),
+      position_estimate_q16_(0), velocity_q16_(0), proportional_gain_q16_(0), integral_gain_q16_(0),
+      primed_(false) {
+}
+
+void VelocityEstimator::configure(const Config& config, long max_steps, double sample_rate_hz) {
+    method_ = config.method;
+
+    int64_t revolution_q16 = static_cast<int64_t>(max_steps) << FRACTION_BITS;
+    half_revolution_q16_ = revolution_q16 / 2;
+    revolution_mask_q16_ = revolution_q16 - 1;
+
+    sample_rate_q16_ = std::llround(sample_rate_hz * (1 << FRACTION_BITS));
+    sample_period_q24_ = std::llround((1 << 24) / sample_rate_hz);
+    rpm_x100_denominator_ = revolution_q16;
+
+    // Largest power of two not above the requested window
+    int window = std::clamp(config.averageWindow, 1, MAX_AVERAGE_WINDOW);
+    window_shift_ = 0;
+    while ((2 << window_shift_) <= window) {
+        ++window_shift_;
+    }
+    window_mask_ = (1U << window_shift_) - 1;
+
+    // Critically damped second-order tracking loop, discretized at the sample period
+    const double damping = 1.0;
+    double omega = 2.0 * M_PI * config.trackingBandwidthHz;
+    double period = 1.0 / sample_rate_hz;
+    proportional_gain_q16_ = std::llround(std::min(2.0 * damping * omega * period, 1.0) * (1 << FRACTION_BITS));
+    integral_gain_q16_ = std::llround(omega * omega * period * (1 << FRACTION_BITS));
+
+    reset();
+}
+
+void VelocityEstimator::reset() {
+    last_steps_ = 0;
+    window_sum_ = 0;
+    std::fill(window_, window_ + MAX_AVERAGE_WINDOW, 0);
+    window_index_ = 0;
+    position_estimate_q16_ = 0;
+    velocity_q16_ = 0;
+    primed_ = false;
+}
+
+void VelocityEstimator::update(long steps) {
+    int64_t steps_q16 = static_cast<int64_t>(steps) << FRACTION_BITS;
+
+    // The first sample only establishes the reference position
+    if (!primed_) {
+        last_steps_ = steps;
+        position_estimate_q16_ = steps_q16;
+        primed_ = true;
+        return;
+    }
+
+    // Shortest signed distance around the wraparound point
+    int64_t delta = wrapQ16((static_cast<int64_t>(steps) - last_steps_) << FRACTION_BITS) >> FRACTION_BITS;
+    last_steps_ = steps;
+
+    switch (method_) {
+        case Method::FiniteDifference:
+            velocity_q16_ = delta * sample_rate_q16_;
+            break;
+
+        case Method::MovingAverage: {
+            uint32_t slot = window_index_ & window_mask_;
+            window_sum_ += delta - window_[slot];
+            window_[slot] = delta;
+            ++window_index_;
+            velocity_q16_ = (window_sum_ * sample_rate_q16_) >> window_shift_;
+            break;
+        }
+
+        case Method::TrackingLoop: {
+            // Predict, then correct position and velocity from the wrapped phase error
+            position_estimate_q16_ += (velocity_q16_ * sample_period_q24_) >> 24;
+            int64_t error_q16 = wrapQ16(steps_q16 - position_estimate_q16_);
+            position_estimate_q16_ += (proportional_gain_q16_ * error_q16) >> FRACTION_BITS;
+            position_estimate_q16_ = wrapQ16(position_estimate_q16_ - half_revolution_q16_) + half_revolution_q16_;
+            velocity_q16_ += (integral_gain_q16_ * error_q16) >> FRACTION_BITS;
+            break;
+        }
+
+        case Method::Model:
+            break;
+    }
+}
+
+int64_t VelocityEstimator::getVelocityStepsPerSecondQ16() const {
+    return velocity_q16_;
+}
+
+int16_t VelocityEstimator::getSpeedRPMx100() const {
+    int64_t speed = velocity_q16_ * rpm_x100_numerator_ / rpm_x100_denominator_;
+    return static_cast<int16_t>(std::clamp<int64_t>(speed, INT16_MIN, INT16_MAX));
+}
@@ -1,14 +1,173 @@
 #include "SimulationEngine.h"
 #include "ConfigLoader.h"
+#include "ConfigWatcher.h"
+#include "Logger.h"
+#include "MetricsExporter.h"
+#include "Tracer.h"
+#include "CpuAccounting.h"
+#include "CanSocket.h"
+#include "AllocationTracker.h"
+#include "BoardScheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 
-int main() {
+// Parse an option value that must be a number within [min, max] with nothing after it;
+// integers may be 0x-prefixed hex
+template <typename T>
+static bool parseNumber(const std::string& text, T min, T max, T& value) {
+    size_t used = 0;
+    try {
+        if constexpr (std::is_integral_v<T>) {
+            long long parsed = std::stoll(text, &used, 0);
+            if (used != text.size() || parsed < static_cast<long long>(min) || parsed > static_cast<long long>(max)) {
+                return false;
+            }
+            value = static_cast<T>(parsed);
+        } else {
+            T parsed = std::stod(text, &used);
+            if (used != text.size() || !(parsed >= min && parsed <= max)) {
+                return false;
+            }
+            value = parsed;
+        }
+    } catch (const std::logic_error&) { // std::invalid_argument or std::out_of_range
+        return false;
+    }
+    return true;
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--state-mirror [name]] [--sync-id <id>] [--rate <hz>] [--telemetry <file>] [--log-level <level>] [--metrics-socket <path>] [--metrics-port <port>] [--metrics-board-latency] [--metrics-file <path>] [--trace <file>] [--cpu-report [rows]] [--can-io <threads|io_uring>] [--alloc-check <report|abort>] [--watch-config] [--make-profile <csv> <profile> <hz>]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
     SimulationEngine simulation;
+    double simulation_frequency_hz = 0.0; // 0 = take it from servos.json
+    std::string telemetry_path;            // Empty = no telemetry capture
+    MetricsExporter::Config metrics_config; // No endpoint = no exporter
+    std::string trace_path;                // Empty = no tracing
+    size_t cpu_report_rows = 0;            // 0 = no CPU accounting
+    bool watch_config = false;             // Apply edits of servos.json while running
+    auto invalid_value = [&](const std::string& option, const char* value) {
+        std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    };
+
+    // Command line options
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--state-mirror") {
+            // Optional segment name, defaults to "main" (/dev/shm/can_sim_state_main)
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                simulation.enableStateMirror(argv[++i]);
+            } else {
+                simulation.enableStateMirror();
+            }
+        } else if (arg == "--sync-id" && i + 1 < argc) {
+            // SYNC CAN ID, decimal or 0x-prefixed hex (CANopen default 0x80), standard 11-bit
+            uint32_t sync_id = 0;
+            if (!parseNumber<uint32_t>(argv[++i], 1, 0x7FF, sync_id)) {
+                return invalid_value(arg, argv[i]);
+            }
+            simulation.enableSync(sync_id);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            // Physics tick rate in Hz, overrides simulationFrequencyHz in servos.json
+            if (!parseNumber(argv[++i], 1.0, 1e6, simulation_frequency_hz)) {
+                return invalid_value(arg, argv[i]);
+            }
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            // debug, info (default), warning or error
+            LogLevel level;
+            if (!Logger::parseLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return 1;
+            }
+            Logger::setLevel(level);
+        } else if (arg == "--metrics-socket" && i + 1 < argc) {
+            metrics_config.unixSocketPath = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            if (!parseNumber<uint16_t>(argv[++i], 1, 65535, metrics_config.httpPort)) {
+                return invalid_value(arg, argv[i]);
+            }
+        } else if (arg == "--metrics-board-latency") {
+            // One command latency histogram per board instead of per interface
+            CanBoard::setPerBoardLatencyMetrics(true);
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            // Rewritten every second
+            metrics_config.dumpPath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            // Chrome trace JSON, written at exit and (as <file>.N) on SIGUSR1
+            trace_path = argv[++i];
+        } else if (arg == "--cpu-report") {
+            // Optional row count, defaults to the top 10 owners
+            cpu_report_rows = 10;
+            if (i + 1 < argc && argv[i + 1][0] != '-' &&
+                !parseNumber<size_t>(argv[++i], 1, std::numeric_limits<uint32_t>::max(), cpu_report_rows)) {
+                return invalid_value(arg, argv[i]);
+            }
+        } else if (arg == "--can-io" && i + 1 < argc) {
+            // SocketCAN I/O: threads (default) or io_uring, which falls back to threads
+            std::string backend = argv[++i];
+            if (backend == "threads") {
+                CanSocket::setIoBackend(CanSocket::IoBackend::Threads);
+            } else if (backend == "io_uring") {
+                CanSocket::setIoBackend(CanSocket::IoBackend::IoUring);
+            } else {
+                std::cerr << "Unknown CAN I/O backend: " << backend << std::endl;
+                return 1;
+            }
+        } else if (arg == "--alloc-check" && i + 1 < argc) {
+            // Report or abort on heap allocations in ticks, timers and frame handling
+            std::string mode = argv[++i];
+            if (!AllocationTracker::AVAILABLE) {
+                std::cerr << "--alloc-check needs a build configured with -DMOTOR_SIM_TRACK_ALLOCATIONS=ON" << std::endl;
+                return 1;
+            }
+            if (mode == "report") {
+                AllocationTracker::setMode(AllocationTracker::Mode::Report);
+            } else if (mode == "abort") {
+                AllocationTracker::setMode(AllocationTracker::Mode::Abort);
+            } else {
+                std::cerr << "Unknown allocation check mode: " << mode << std::endl;
+                return 1;
+            }
+        } else if (arg == "--watch-config") {
+            watch_config = true;
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetry_path = argv[++i];
+        } else if (arg == "--make-profile" && i + 3 < argc) {
+            // Convert a CSV recording: --make-profile <in.csv> <out.prof> <sample rate Hz>
+            double sample_rate_hz = 0.0;
+            if (!parseNumber(argv[i + 3], std::numeric_limits<double>::min(), 1e6, sample_rate_hz)) {
+                return invalid_value(arg, argv[i + 3]);
+            }
+            return LoadProfile::convertCsv(argv[i + 1], argv[i + 2], sample_rate_hz) ? 0 : 1;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
     // Load servo configurations from JSON file
     std::cout << "Loading servo configurations from servos.json..." << std::endl;
-    auto servos = ConfigLoader::loadServosFromFile("servos.json");
+    auto servo_configs = ConfigLoader::loadFromFile("servos.json");
+    auto servos = ConfigLoader::createServos(servo_configs);
+    SimulationConfig simulation_config = ConfigLoader::loadSimulationConfig("servos.json");
+    if (simulation_frequency_hz <= 0.0) {
+        simulation_frequency_hz = simulation_config.simulationFrequencyHz;
+    }
+    simulation.setSimulationFrequency(simulation_frequency_hz);
+    simulation.setIntegrationAccuracy(simulation_config.integrationAccuracy);
+    simulation.setChainThreads(simulation_config.chainThreads);
+    BoardScheduler::instance().setThreads(simulation_config.timerThreads);
     
     if (servos.empty()) {
         std::cerr << "No servos loaded! Check servos.json file." << std::endl;
@@ -17,7 +176,62 @@ int main() {
     
     // Add all loaded servos to simulation
     for (auto& servo : servos) {
-        simulation.addServo(std::move(servo));
+        try {
+            simulation.addServo(std::move(servo));
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Recorded loads referenced from servos.json
+    for (size_t i = 0; i < servo_configs.size(); ++i) {
+        const ServoConfig& config = servo_configs[i];
+        if (!config.loadProfile.empty() &&
+            !simulation.addLoadProfile(i, config.loadProfile, static_cast<uint32_t>(config.loadProfileChannel),
+                                       config.loadProfileScale, config.loadProfileLoop)) {
+            return 1;
+        }
+    }
+
+    // Servos flagged "telemetry" in servos.json, or all of them
+    if (!telemetry_path.empty()) {
+        std::vector<size_t> telemetry_servos;
+        for (size_t i = 0; i < servo_configs.size(); ++i) {
+            if (servo_configs[i].telemetry) {
+                telemetry_servos.push_back(i);
+            }
+        }
+        simulation.enableTelemetry(telemetry_path, telemetry_servos);
+    }
+
+    // Optional kinematic chains coupling servos by name
+    for (const auto& chain : ConfigLoader::loadChainsFromFile("chains.json")) {
+        std::vector<size_t> indices;
+        if (!ConfigLoader::resolveChainServos(chain, servo_configs, indices)) {
+            return 1;
+        }
+        try {
+            simulation.addChain(chain, indices);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<MetricsExporter> metrics;
+    if (!metrics_config.unixSocketPath.empty() || metrics_config.httpPort != 0 || !metrics_config.dumpPath.empty()) {
+        metrics = std::make_unique<MetricsExporter>(metrics_config);
+        if (!metrics->start()) {
+            return 1;
+        }
+    }
+
+    if (!trace_path.empty()) {
+        Tracer::enable(trace_path);
+    }
+    if (cpu_report_rows > 0) {
+        CpuAccounting::instance().enable(cpu_report_rows); // SIGUSR2 prints the table
     }
 
     std::cout << "Starting simulation with " << simulation.getServoCount() << " servos..." << std::endl;
@@ -27,16 +241,68 @@ int main() {
     for (size_t i = 0; i < simulation.getServoCount(); ++i) {
         simulation.getServo(i).startCAN();
     }
+    std::cout << "Memory: " << simulation.measureHeapBytesPerServo() << " bytes of heap per servo, "
+              << BoardScheduler::instance().getThreads() << " board timer thread(s)" << std::endl;
+
+    std::unique_ptr<ConfigWatcher> config_watcher;
+    if (watch_config) {
+        config_watcher = std::make_unique<ConfigWatcher>(simulation, "servos.json", servo_configs);
+        if (!config_watcher->start()) {
+            config_watcher.reset();
+        }
+    }
 
     // Wait for program termination (e.g., Ctrl+C)
     std::cout << "Press Enter to stop the simulation..." << std::endl;
     std::cin.get();
 
+    if (config_watcher) {
+        config_watcher->stop();
+    }
+
     // Stop CAN communication for all servos
     for (size_t i = 0; i < simulation.getServoCount(); ++i) {
         simulation.getServo(i).stopCAN();
     }
 
     simulation.stop();
+    if (metrics) {
+        metrics->stop();
+    }
+    Tracer::shutdown();
+    Logger::instance().flush(); // Keep the summary below the last log lines
+
+    if (AllocationTracker::getMode() != AllocationTracker::Mode::Off) {
+        std::cout << "Allocation check: " << AllocationTracker::getHotAllocations()
+                  << " heap allocations on hot paths while running" << std::endl;
+    }
+
+    if (cpu_report_rows > 0) {
+        std::cout << CpuAccounting::instance().report(cpu_report_rows);
+        CpuAccounting::instance().disable();
+    }
+
+    // Report modeled bus load for interfaces with a timing model
+    for (const auto& entry : simulation.getCanBuses()) {
+        CanBus::Statistics stats = entry.second->getStatistics();
+        std::cout << "CAN bus " << entry.first << " @ " << entry.second->getBitrate() << " bit/s: "
+                  << stats.frames << " frames, " << stats.stuffBits << " stuff bits, "
+                  << "utilization " << stats.utilization * 100.0 << "%, "
+                  << "queueing delay mean " << stats.meanQueueDelayUs << " us / max "
+                  << stats.maxQueueDelayUs << " us, max pending " << stats.maxPending << ", "
+                  << stats.overflows << " overflows" << std::endl;
+    }
+
+    if (const TelemetryRecorder* telemetry = simulation.getTelemetry()) {
+        std::cout << "Telemetry: " << telemetry->getTicksWritten() << " ticks of " << telemetry->getServoCount()
+                  << " servos in " << telemetry->getBytesWritten() << " bytes, " << telemetry->getDropped()
+                  << " ticks dropped" << std::endl;
+    }
+
+    // Underruns mean the streamer could not keep a profile mapped ahead of playback
+    if (simulation.getLoadProfiles().size() > 0) {
+        std::cout << "Load profiles: " << simulation.getLoadProfiles().size() << " played, "
+                  << simulation.getLoadProfiles().getUnderruns() << " underruns" << std::endl;
+    }
     return 0;
 }
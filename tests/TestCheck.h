@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @brief Minimal checks for the ctest executables
+ *
+ * Example usage:
+ *   CHECK(bus.getStatistics().frames > 0);
+ *   return testResult();
+ */
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++testFailures();                                                               \
+        }                                                                                   \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures() != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", testFailures());
+        return 1;
+    }
+    return 0;
+}
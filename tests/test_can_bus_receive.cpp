@@ -0,0 +1,100 @@
+// Received frames cross the bus model, and an interface's boards share one bitrate
+#include "TestCheck.h"
+#include "CanBus.h"
+#include "SimulationEngine.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class RecordingReceiver : public CanBus::Receiver {
+public:
+    std::vector<uint32_t> ids;
+    std::vector<Clock::time_point> times;
+    std::atomic<int> count{0};
+
+    void onBusFrame(const struct can_frame& frame) override {
+        ids.push_back(frame.can_id);
+        times.push_back(Clock::now());
+        ++count;
+    }
+};
+
+struct can_frame commandFrame(uint32_t can_id) {
+    struct can_frame frame = {};
+    frame.can_id = can_id;
+    frame.can_dlc = 2;
+    frame.data[0] = 0x10;
+    frame.data[1] = 25;
+    return frame;
+}
+
+// Each frame reaches the board no earlier than its wire time, and counts as bus traffic
+void receivedFramesAreDelayed() {
+    CanBus bus("receive_test", 125000);
+    bus.start();
+    RecordingReceiver receiver;
+    auto wire_time = std::chrono::microseconds(CanBus::frameBitCount(commandFrame(0x21)) * 8);
+
+    auto submitted = Clock::now();
+    for (uint32_t id : {0x21U, 0x22U, 0x23U}) {
+        CHECK(bus.receive(commandFrame(id), receiver));
+    }
+    auto deadline = submitted + std::chrono::seconds(2);
+    while (receiver.count < 3 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(receiver.count == 3);
+    if (receiver.count == 3) {
+        CHECK(receiver.times[0] - submitted >= wire_time);
+        CHECK(receiver.times[2] - submitted >= 3 * wire_time);
+    }
+    CHECK(bus.getStatistics().frames == 3);
+
+    // Frames still queued for a detached receiver are dropped
+    for (int i = 0; i < 50; ++i) {
+        bus.receive(commandFrame(0x30), receiver);
+    }
+    bus.detach(static_cast<CanBus::Receiver&>(receiver));
+    int delivered = receiver.count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(receiver.count == delivered);
+    CHECK(delivered < 53);
+    bus.stop();
+}
+
+Servo boardServo(uint32_t can_id, const std::string& interface_name, uint32_t bitrate) {
+    return Servo::builder().canId(can_id).canInterface(interface_name).canBitrate(bitrate).build();
+}
+
+void bitrateMismatchRefused() {
+    SimulationEngine engine;
+    engine.addServo(boardServo(0x10, "loop:bitrate_test", 125000));
+    bool refused = false;
+    try {
+        engine.addServo(boardServo(0x11, "loop:bitrate_test", 250000));
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    CHECK(refused);
+    CHECK(engine.getServoCount() == 1);
+
+    // Matching, unmodeled and other-interface boards are fine
+    engine.addServo(boardServo(0x12, "loop:bitrate_test", 125000));
+    engine.addServo(boardServo(0x13, "loop:bitrate_test", 0));
+    engine.addServo(boardServo(0x14, "loop:bitrate_other", 250000));
+    CHECK(engine.getServoCount() == 4);
+}
+
+} // namespace
+
+int main() {
+    receivedFramesAreDelayed();
+    bitrateMismatchRefused();
+    return testResult();
+}
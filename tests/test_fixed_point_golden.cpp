@@ -0,0 +1,125 @@
+// Fixed-point servos integrate to bit-identical state on every build and machine
+#include "TestCheck.h"
+#include "Servo.h"
+#include "ServoKernels.h"
+#include "FixedPointLanes.h"
+#include <cinttypes>
+#include <map>
+#include <vector>
+
+namespace {
+
+constexpr long TICKS = 20000;               // One simulated second at the default rate
+constexpr double DT = 1.0 / 20000.0;
+constexpr size_t SERVO_COUNT = 8;
+
+struct Golden {
+    long encoderSteps;
+    int64_t positionQ32;
+    int64_t velocityQ32;
+    int64_t revolutions;
+};
+
+// State after TICKS steps; regenerate only for an intended change of the fixed-point
+// model, from the values this test prints on a mismatch
+constexpr Golden GOLDEN[SERVO_COUNT] = {
+    {3993, 17152851241281, 439764461, -1},
+    {3441, 266694865112726, 7393743898, -1},
+    {3856, 16561819176500, 343560191, -1},
+    {65004, 279190476232472, 2286777057, -1},
+    {3999, 416322642509, -208275506, 0},
+    {7196, 30910214557208, -10306852193, 0},
+    {302, 1300393057831, -1301704648, 0},
+    {14249, 220272880598789, 30616351231, -1},
+};
+
+std::vector<Servo> createServos() {
+    std::vector<Servo> servos;
+    for (size_t i = 0; i < SERVO_COUNT; ++i) {
+        servos.push_back(Servo::builder()
+                             .maxVelocityRPM(30.0 + 15.0 * static_cast<double>(i))
+                             .maxControlSignal(100)
+                             .timeConstant(0.05 + 0.05 * static_cast<double>(i % 3))
+                             .loadDamping(i % 4 == 3 ? 0.02 : 0.0)
+                             .encoderBitResolution(i % 2 == 0 ? 12 : 16)
+                             .encoderDirectionInverted(i % 3 == 1)
+                             .fixedPoint(true)
+                             .build());
+        servos.back().setControlSignal(static_cast<int>(i * 29 % 201) - 100);
+    }
+    return servos;
+}
+
+// Both step paths reverse every command halfway, so the run covers acceleration
+// in both directions
+
+void stepKernels(std::vector<Servo>& servos) {
+    std::map<ServoKernel, std::vector<Servo*>> groups;
+    for (auto& servo : servos) {
+        groups[selectServoKernel(servo)].push_back(&servo);
+    }
+    for (long tick = 0; tick < TICKS; ++tick) {
+        if (tick == TICKS / 2) {
+            for (auto& servo : servos) {
+                servo.setControlSignal(-servo.getControlSignal());
+            }
+        }
+        for (const auto& group : groups) {
+            group.first(group.second.data(), group.second.size(), DT);
+        }
+    }
+}
+
+void stepLanes(std::vector<Servo>& servos) {
+    std::vector<Servo*> pointers;
+    for (auto& servo : servos) {
+        pointers.push_back(&servo);
+    }
+    FixedPointLanes lanes;
+    lanes.load(pointers, DT);
+    for (long tick = 0; tick < TICKS; ++tick) {
+        if (tick == TICKS / 2) {
+            for (size_t i = 0; i < servos.size(); ++i) {
+                servos[i].setControlSignal(-servos[i].getControlSignal());
+                lanes.reloadControlSignal(i);
+            }
+        }
+        lanes.step();
+    }
+    for (size_t i = 0; i < servos.size(); ++i) {
+        CHECK(lanes.getEncoderSteps(i) == GOLDEN[i].encoderSteps);
+    }
+    lanes.publish();
+}
+
+void checkGolden(std::vector<Servo>& servos) {
+    for (size_t i = 0; i < SERVO_COUNT; ++i) {
+        const FixedPointModel* model = servos[i].getFixedPointModel();
+        CHECK(model != nullptr);
+        if (!model) {
+            continue;
+        }
+        Golden actual = {servos[i].getEncoderPosition(), model->getPositionQ32(), model->getVelocityQ32(),
+                         model->getRevolutions()};
+        if (actual.encoderSteps != GOLDEN[i].encoderSteps || actual.positionQ32 != GOLDEN[i].positionQ32 ||
+            actual.velocityQ32 != GOLDEN[i].velocityQ32 || actual.revolutions != GOLDEN[i].revolutions) {
+            std::fprintf(stderr, "servo %zu: {%ld, %" PRId64 ", %" PRId64 ", %" PRId64 "},\n", i,
+                         actual.encoderSteps, actual.positionQ32, actual.velocityQ32, actual.revolutions);
+            CHECK(!"fixed-point state differs from the golden values");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    // The scalar kernels and the engine's vectorized lanes give the same state
+    std::vector<Servo> stepped = createServos();
+    stepKernels(stepped);
+    checkGolden(stepped);
+
+    std::vector<Servo> laned = createServos();
+    stepLanes(laned);
+    checkGolden(laned);
+    return testResult();
+}
@@ -0,0 +1,93 @@
+// Board/controller round trips over a loopback bus, reported in frames per second
+#include "TestCheck.h"
+#include "LoopbackTransport.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t PAIRS = 4;
+constexpr uint32_t ROUND_TRIPS = 200000;     // Per pair
+constexpr uint32_t REPLY_OFFSET = 0x100;
+
+struct can_frame commandFrame(uint32_t can_id, uint8_t sequence) {
+    struct can_frame frame = {};
+    frame.can_id = can_id;
+    frame.can_dlc = 2;
+    frame.data[0] = 0x10;
+    frame.data[1] = sequence;
+    return frame;
+}
+
+// A board answering each command from its receive callback, and the controller driving it
+struct Pair {
+    std::unique_ptr<LoopbackTransport> board;
+    std::unique_ptr<LoopbackTransport> controller;
+    std::atomic<uint32_t> replies{0};
+    uint32_t mismatches = 0;
+};
+
+} // namespace
+
+int main() {
+    std::vector<std::unique_ptr<Pair>> pairs;
+    for (uint32_t i = 0; i < PAIRS; ++i) {
+        auto pair = std::make_unique<Pair>();
+        Pair* p = pair.get();
+        uint32_t board_id = 0x20 + i;
+        p->board = std::make_unique<LoopbackTransport>("loop:throughput_test");
+        p->controller = std::make_unique<LoopbackTransport>("loop:throughput_test");
+        CHECK(p->board->open());
+        CHECK(p->controller->open());
+
+        // Filters as CanBoard::start() sets them, so each endpoint sees only its peer
+        struct can_filter board_filter = {board_id, CAN_SFF_MASK};
+        struct can_filter controller_filter = {board_id + REPLY_OFFSET, CAN_SFF_MASK};
+        CHECK(p->board->setFilters(&board_filter, 1));
+        CHECK(p->controller->setFilters(&controller_filter, 1));
+        CHECK(p->board->startReceiving([p, board_id](const struct can_frame& frame) {
+            p->board->sendFrame(commandFrame(board_id + REPLY_OFFSET, frame.data[1]));
+        }));
+        CHECK(p->controller->startReceiving([p](const struct can_frame& frame) {
+            if (frame.data[1] != static_cast<uint8_t>(p->replies.load(std::memory_order_relaxed))) {
+                ++p->mismatches;
+            }
+            p->replies.fetch_add(1, std::memory_order_relaxed);
+        }));
+        pairs.push_back(std::move(pair));
+    }
+
+    // Every controller drives its board from its own thread, all on the same bus
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < PAIRS; ++i) {
+        threads.emplace_back([&pairs, i]() {
+            Pair& pair = *pairs[i];
+            for (uint32_t trip = 0; trip < ROUND_TRIPS; ++trip) {
+                pair.controller->sendFrame(commandFrame(0x20 + i, static_cast<uint8_t>(trip)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    for (const auto& pair : pairs) {
+        CHECK(pair->replies == ROUND_TRIPS);
+        CHECK(pair->mismatches == 0);
+    }
+    double frames = 2.0 * PAIRS * ROUND_TRIPS;
+    std::printf("%u round trips on %u pairs in %.3f s: %.0f frames/s\n", PAIRS * ROUND_TRIPS, PAIRS,
+                elapsed.count(), frames / elapsed.count());
+
+    for (auto& pair : pairs) {
+        pair->board->close();
+        pair->controller->close();
+    }
+    return testResult();
+}
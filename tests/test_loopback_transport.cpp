@@ -0,0 +1,91 @@
+// Loopback transport: delivery, receive filters, and sends racing close()
+#include "TestCheck.h"
+#include "LoopbackTransport.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct can_frame frameWithId(uint32_t can_id) {
+    struct can_frame frame = {};
+    frame.can_id = can_id;
+    frame.can_dlc = 2;
+    frame.data[0] = 0x10;
+    frame.data[1] = 25;
+    return frame;
+}
+
+void roundTrip() {
+    LoopbackTransport controller("loop:loopback_test");
+    LoopbackTransport board("loop:loopback_test");
+    CHECK(controller.open());
+    CHECK(board.open());
+
+    std::vector<uint32_t> at_board;
+    std::vector<uint32_t> at_controller;
+    CHECK(board.startReceiving([&](const struct can_frame& frame) {
+        at_board.push_back(frame.can_id);
+        board.sendFrame(frameWithId(frame.can_id + 0x100)); // Reply from inside the callback
+    }));
+    CHECK(controller.startReceiving([&](const struct can_frame& frame) { at_controller.push_back(frame.can_id); }));
+
+    // The board takes its own ID and the SYNC ID, like CanBoard::start()
+    struct can_filter filters[2] = {{0x21, CAN_SFF_MASK}, {0x80, CAN_SFF_MASK}};
+    CHECK(board.setFilters(filters, 2));
+
+    CHECK(controller.sendFrame(frameWithId(0x21)));
+    CHECK(controller.sendFrame(frameWithId(0x22)));
+    CHECK(controller.sendFrame(frameWithId(0x80)));
+    CHECK((at_board == std::vector<uint32_t>{0x21, 0x80}));
+    CHECK((at_controller == std::vector<uint32_t>{0x121, 0x180})); // Senders do not see their own frames
+
+    // No filters receive everything; too many are refused and leave the old ones
+    CHECK(board.setFilters(nullptr, 0));
+    CHECK(controller.sendFrame(frameWithId(0x22)));
+    CHECK(at_board.size() == 3);
+    struct can_filter unused = {0x30, CAN_SFF_MASK};
+    std::vector<struct can_filter> many(CanEndpoint::MAX_FILTERS + 1, unused);
+    CHECK(!board.setFilters(many.data(), many.size()));
+    CHECK(controller.sendFrame(frameWithId(0x23)));
+    CHECK(at_board.size() == 4);
+
+    board.close();
+    CHECK(!board.isOpen());
+    CHECK(!board.sendFrame(frameWithId(0x21)));
+    CHECK(controller.sendFrame(frameWithId(0x21)));
+    CHECK(at_board.size() == 4);
+}
+
+void sendWhileClosing() {
+    LoopbackTransport sender("loop:loopback_close_test");
+    LoopbackTransport receiver("loop:loopback_close_test");
+    CHECK(receiver.open());
+    std::atomic<int> received{0};
+    CHECK(receiver.startReceiving([&](const struct can_frame&) { ++received; }));
+
+    // The last transport closing destroys the bus while the other thread may be sending
+    std::atomic<bool> running{true};
+    std::thread sending([&]() {
+        while (running) {
+            sender.sendFrame(frameWithId(0x21));
+        }
+    });
+    for (int round = 0; round < 2000; ++round) {
+        CHECK(sender.open());
+        receiver.close();
+        sender.close();
+        CHECK(receiver.open());
+        CHECK(receiver.startReceiving([&](const struct can_frame&) { ++received; }));
+    }
+    running = false;
+    sending.join();
+}
+
+} // namespace
+
+int main() {
+    roundTrip();
+    sendWhileClosing();
+    return testResult();
+}
@@ -0,0 +1,115 @@
+// Removing a servo whose board has frames queued on a bitrate-modeled bus
+#include "TestCheck.h"
+#include "CanBus.h"
+#include "SimulationEngine.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// Records sends, and takes long enough per frame that detach() lands mid-send
+class ProbeTransport : public CanTransport {
+public:
+    std::atomic<bool> sending{false};
+    std::atomic<int> sends{0};
+
+    bool open() override { return true; }
+    void close() override {}
+    bool isOpen() const override { return true; }
+    bool sendFrame(const struct can_frame&) override {
+        sending = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++sends;
+        sending = false;
+        return true;
+    }
+    bool startReceiving(ReceiveCallback) override { return true; }
+    void stopReceiving() override {}
+    bool isReceiving() const override { return false; }
+    bool setFilters(const struct can_filter*, size_t) override { return true; }
+    const std::string& getInterfaceName() const override { return name_; }
+
+private:
+    std::string name_ = "probe";
+};
+
+struct can_frame statusFrame(uint32_t can_id) {
+    struct can_frame frame = {};
+    frame.can_id = can_id;
+    frame.can_dlc = 6;
+    return frame;
+}
+
+// The bus never touches a transport after detach() returns
+void detachWaitsForSend() {
+    CanBus bus("probe", 125000);
+    bus.start();
+    auto probe = std::make_unique<ProbeTransport>();
+    ProbeTransport other;
+    for (int i = 0; i < 50; ++i) {
+        CHECK(bus.submit(statusFrame(0x10), *probe));
+        CHECK(bus.submit(statusFrame(0x11), other));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!probe->sending && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    CHECK(probe->sending);
+
+    bus.detach(*probe);
+    CHECK(!probe->sending);
+    int sends = probe->sends;
+    probe.reset();
+
+    // The other transport's frames still go out after the detached ones are gone
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(other.sends > 0);
+    bus.stop();
+    CHECK(sends < 50);
+}
+
+Servo transmittingServo(uint32_t can_id) {
+    BoardTimerRates rates;
+    rates.canTransmitHz = 1000.0; // Far more than a 125 kbit/s bus carries, so frames queue up
+    return Servo::builder()
+        .canId(can_id)
+        .canInterface("loop:servo_removal")
+        .canBitrate(125000)
+        .timerRates(rates)
+        .build();
+}
+
+// Servos leave and join a saturated bus while the others keep transmitting
+void removeWhileTransmitting() {
+    SimulationEngine engine;
+    engine.setSimulationFrequency(2000.0);
+    for (uint32_t i = 0; i < 4; ++i) {
+        engine.addServo(transmittingServo(0x10 + i));
+    }
+    engine.start();
+
+    for (uint32_t round = 0; round < 5; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        engine.removeServo(0);
+        engine.addServo(transmittingServo(0x20 + round));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    CHECK(engine.getServoCount() == 4);
+    CHECK(engine.getCanBuses().at("loop:servo_removal")->getStatistics().frames > 0);
+
+    engine.removeServo(3);
+    engine.removeServo(0);
+    engine.stop();
+    CHECK(engine.getServoCount() == 2);
+}
+
+} // namespace
+
+int main() {
+    detachWaitsForSend();
+    removeWhileTransmitting();
+    return testResult();
+}
@@ -0,0 +1,70 @@
+// Shared-memory segments outlive their transports closing, and serve a single mode
+#include "TestCheck.h"
+#include "ShmTransport.h"
+#include "ShmClient.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const char* const SEGMENT_FILE = "/dev/shm/can_sim_bus_shm_segment_test";
+
+struct can_frame commandFrame(uint32_t can_id) {
+    struct can_frame frame = {};
+    frame.can_id = can_id;
+    frame.can_dlc = 2;
+    frame.data[0] = 0x10;
+    frame.data[1] = 50;
+    return frame;
+}
+
+bool segmentExists() {
+    return access(SEGMENT_FILE, F_OK) == 0;
+}
+
+} // namespace
+
+int main() {
+    ShmTransport transport("shm:shm_segment_test");
+    CHECK(transport.open());
+    ShmClient client("shm_segment_test");
+    CHECK(client.connect());
+
+    // Closing the last transport keeps the segment and the controller's mapping
+    transport.close();
+    CHECK(segmentExists());
+    CHECK(client.isConnected());
+
+    std::atomic<int> received{0};
+    CHECK(transport.open());
+    CHECK(transport.startReceiving([&](const struct can_frame& frame) {
+        if (frame.can_id == 0x21) {
+            ++received;
+        }
+    }));
+    CHECK(client.send(commandFrame(0x21)));
+    for (int wait = 0; wait < 200 && received == 0; ++wait) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(received == 1);
+
+    struct can_frame status = commandFrame(0x21);
+    status.data[0] = 0x13;
+    CHECK(transport.sendFrame(status));
+    struct can_frame echoed;
+    CHECK(client.receive(echoed, 1000) && echoed.data[0] == 0x13);
+
+    // The dispatch thread of a segment either parks or spins
+    ShmTransport polling("shm-poll:shm_segment_test");
+    CHECK(!polling.open());
+
+    // Engine shutdown unlinks the segment once its transports are closed
+    transport.close();
+    ShmTransport::releaseSegments();
+    CHECK(!segmentExists());
+
+    client.disconnect();
+    return testResult();
+}